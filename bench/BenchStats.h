@@ -0,0 +1,51 @@
+/*
+ * Copyright 2025 Kadir Mert Abatay
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <QJsonObject>
+#include <QList>
+#include <algorithm>
+
+// Summary statistics shared by the benchmark reports, in milliseconds
+class BenchStats {
+public:
+  // Nearest-rank percentile of sorted samples, p in [0, 1]
+  static double percentile(const QList<double> &sorted, double p) {
+    if (sorted.isEmpty())
+      return 0;
+    const int rank = qBound(0, int(p * sorted.size() + 0.5) - 1,
+                            int(sorted.size()) - 1);
+    return sorted[rank];
+  }
+
+  // {"count", "min_ms", "median_ms", "p95_ms", "mean_ms", "max_ms"}
+  static QJsonObject summarize(QList<double> samples) {
+    std::sort(samples.begin(), samples.end());
+    double total = 0;
+    for (double ms : samples)
+      total += ms;
+    QJsonObject stats;
+    stats["count"] = int(samples.size());
+    stats["min_ms"] = samples.isEmpty() ? 0 : samples.first();
+    // Upper median, as the first benchmark reports have it
+    stats["median_ms"] = samples.isEmpty() ? 0 : samples[samples.size() / 2];
+    stats["p95_ms"] = percentile(samples, 0.95);
+    stats["mean_ms"] = samples.isEmpty() ? 0 : total / samples.size();
+    stats["max_ms"] = samples.isEmpty() ? 0 : samples.last();
+    return stats;
+  }
+};
@@ -0,0 +1,205 @@
+/*
+ * Copyright 2025 Kadir Mert Abatay
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Times each stage of a refresh on synthetic data at several scales and
+// prints one JSON document on stdout, so runs can be compared between
+// builds. Runs on the offscreen platform; settings and the snapshot file go
+// to Qt's test locations, never the user's.
+
+#include "BenchStats.h"
+#include "MainWindow.h"
+#include "PortMonitor.h"
+#include "PortSniffer.h"
+#include "PortTableModel.h"
+#include "SnapshotDiff.h"
+#include "SocketTable.h"
+#include "SyntheticData.h"
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QStandardPaths>
+#include <QSysInfo>
+#include <QTemporaryDir>
+#include <cstdio>
+#include <functional>
+#include <memory>
+
+// Results are summed here so no stage can be optimized away
+static qsizetype g_sink = 0;
+
+static QJsonObject summarize(const QString &stage, int rows,
+                             const QList<double> &samples) {
+  // Earlier reports call the sample count "iterations"; p95_ms is new
+  QJsonObject result = BenchStats::summarize(samples);
+  result["iterations"] = result.take("count");
+  result["stage"] = stage;
+  result["rows"] = rows;
+  return result;
+}
+
+// One untimed warm-up run, then `iterations` timed ones; `setup` runs
+// before each, outside the timing
+static QJsonObject measure(const QString &stage, int rows, int iterations,
+                           const std::function<void(int)> &run,
+                           const std::function<void(int)> &setup = {}) {
+  QList<double> samples;
+  for (int i = -1; i < iterations; ++i) {
+    if (setup)
+      setup(i);
+    QElapsedTimer timer;
+    timer.start();
+    run(i);
+    if (i >= 0)
+      samples.append(timer.nsecsElapsed() / 1.0e6);
+  }
+  return summarize(stage, rows, samples);
+}
+
+static bool writeFile(const QString &path, const QByteArray &data) {
+  QFile file(path);
+  return file.open(QIODevice::WriteOnly) && file.write(data) == data.size();
+}
+
+int main(int argc, char *argv[]) {
+  if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+  QStandardPaths::setTestModeEnabled(true);
+
+  QApplication app(argc, argv);
+  app.setApplicationName("Port Monitor Benchmark");
+
+  QCommandLineParser parser;
+  parser.setApplicationDescription(
+      "Times parsing, diffing, the table model, filtering and dashboard "
+      "updates on synthetic socket tables.");
+  parser.addHelpOption();
+  QCommandLineOption scalesOption(
+      "scales", "Comma-separated socket counts (default 1k,10k,100k,1M).",
+      "rows", "1000,10000,100000,1000000");
+  QCommandLineOption iterationsOption(
+      "iterations", "Timed runs per stage and scale (default 5).", "count",
+      "5");
+  parser.addOption(scalesOption);
+  parser.addOption(iterationsOption);
+  parser.process(app);
+
+  QList<int> scales;
+  for (const QString &value : parser.value(scalesOption).split(',')) {
+    const int rows = value.trimmed().toInt();
+    if (rows > 0)
+      scales.append(rows);
+  }
+  const int iterations = qMax(1, parser.value(iterationsOption).toInt());
+
+  QTemporaryDir dir;
+  if (!dir.isValid()) {
+    fprintf(stderr, "Cannot create a temporary directory\n");
+    return 1;
+  }
+
+  // The real window, shown offscreen so dashboard cards get built; the
+  // event loop never runs, so its own scans never deliver results
+  MainWindow window;
+  window.resize(1000, 700);
+  window.show();
+  app.processEvents();
+
+  QJsonArray results;
+  for (int rows : scales) {
+    fprintf(stderr, "%d rows...\n", rows);
+
+    const QByteArray lsof = SyntheticData::lsofOutput(rows);
+    results.append(measure("lsof_parse", rows, iterations, [&](int) {
+      g_sink += PortMonitor::parseLsof(lsof).size();
+    }));
+
+    std::unique_ptr<PortSniffer> sniffer;
+    results.append(measure(
+        "sniffer_parse", rows, iterations,
+        [&](int) { sniffer->parseOutput(lsof); },
+        [&](int) { sniffer.reset(new PortSniffer()); }));
+    sniffer.reset();
+
+    const QString tcpPath = dir.filePath("tcp");
+    const QString tcp6Path = dir.filePath("tcp6");
+    if (!writeFile(tcpPath, SyntheticData::procNetTcp(rows, false)) ||
+        !writeFile(tcp6Path, SyntheticData::procNetTcp(rows, true))) {
+      fprintf(stderr, "Cannot write to %s\n", qPrintable(dir.path()));
+      return 1;
+    }
+    results.append(measure("procnet_tcp_parse", rows, iterations, [&](int) {
+      g_sink += SocketTable::readProcNet(tcpPath, "TCP").size();
+    }));
+    results.append(measure("procnet_tcp6_parse", rows, iterations, [&](int) {
+      g_sink += SocketTable::readProcNet(tcp6Path, "TCP").size();
+    }));
+
+    // Alternating between two scans 5% apart gives every run real changes
+    const QList<PortInfo> scan = SyntheticData::snapshot(rows);
+    const QList<PortInfo> next = SyntheticData::churn(scan, 0.05);
+    auto pick = [&](int i) -> const QList<PortInfo> & {
+      return (i % 2 == 0) ? next : scan;
+    };
+
+    SnapshotDiff diff;
+    diff.update(scan);
+    results.append(measure("diff", rows, iterations, [&](int i) {
+      const SnapshotDelta delta = diff.update(pick(i));
+      g_sink += delta.added.size() + delta.removed.size();
+    }));
+
+    PortTableModel model;
+    results.append(measure("model_set_ports", rows, iterations,
+                           [&](int i) { model.setPorts(pick(i)); }));
+
+    results.append(measure("filter", rows, iterations, [&](int i) {
+      g_sink += PortTableModel::filter(pick(i), "node").size();
+    }));
+
+    // The window stage covers model reset, filter and dashboard together;
+    // the dashboard's share is read back from the window
+    QList<double> dashboardMs;
+    results.append(measure("window_ports_updated", rows, iterations,
+                           [&](int i) {
+                             QMetaObject::invokeMethod(
+                                 &window, "onPortsUpdated",
+                                 Qt::DirectConnection,
+                                 Q_ARG(QList<PortInfo>, pick(i)));
+                             if (i >= 0)
+                               dashboardMs.append(
+                                   window.dashboardUpdateUs() / 1000.0);
+                           }));
+    results.append(summarize("dashboard_update", rows, dashboardMs));
+  }
+
+  QJsonObject report;
+  report["benchmark"] = "engine";
+  report["timestamp"] =
+      QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+  report["qt"] = qVersion();
+  report["abi"] = QSysInfo::buildAbi();
+  report["kernel"] = QSysInfo::kernelVersion();
+  report["iterations"] = iterations;
+  report["results"] = results;
+  printf("%s", QJsonDocument(report).toJson(QJsonDocument::Indented).data());
+  fprintf(stderr, "done (%lld)\n", qint64(g_sink));
+  return 0;
+}
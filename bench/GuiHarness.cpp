@@ -0,0 +1,255 @@
+/*
+ * Copyright 2025 Kadir Mert Abatay
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Drives the real MainWindow on the offscreen platform the way a user
+// would: snapshots arriving, typing in the search box, scrolling the
+// table, resizing the window (and with it the dashboard) and opening the
+// tray menu. For every operation it reports how long it took until the
+// event loop was idle again, and how long the loop was blocked (how late
+// a 5 ms heartbeat timer fired), as JSON on stdout.
+
+#include "BenchStats.h"
+#include "MainWindow.h"
+#include "SyntheticData.h"
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QKeyEvent>
+#include <QMap>
+#include <QMenu>
+#include <QScrollBar>
+#include <QStandardPaths>
+#include <QSysInfo>
+#include <cstdio>
+#include <functional>
+
+static const int kHeartbeatMs = 5;
+
+// Runs the event loop until what the last operation posted (layouts,
+// repaints, queued calls and what those post in turn) has been handled
+static void settle() {
+  for (int pass = 0; pass < 3; ++pass) {
+    QEventLoop loop;
+    QTimer::singleShot(0, &loop, &QEventLoop::quit);
+    loop.exec();
+  }
+}
+
+// How late each tick of a fast timer comes: time the event loop was busy
+class Heartbeat {
+public:
+  Heartbeat() {
+    m_timer.setTimerType(Qt::PreciseTimer);
+    m_timer.setInterval(kHeartbeatMs);
+    QObject::connect(&m_timer, &QTimer::timeout, [this]() { tick(); });
+  }
+
+  void start() {
+    m_stalls.clear();
+    m_last.start();
+    m_timer.start();
+  }
+
+  QList<double> stop() {
+    tick(); // A tick still pending covers the end of the operation
+    m_timer.stop();
+    return m_stalls;
+  }
+
+private:
+  void tick() {
+    const double gapMs = m_last.nsecsElapsed() / 1.0e6;
+    m_last.start();
+    if (gapMs > kHeartbeatMs)
+      m_stalls.append(gapMs - kHeartbeatMs);
+  }
+
+  QTimer m_timer;
+  QElapsedTimer m_last;
+  QList<double> m_stalls;
+};
+
+struct OperationSamples {
+  QList<double> durations;
+  QList<double> stalls;
+};
+
+class Harness {
+public:
+  explicit Harness(MainWindow *window) : m_window(window) {}
+
+  // Runs one operation to idle and files its time and loop stalls
+  void run(const QString &name, const std::function<void()> &operation) {
+    OperationSamples &samples = m_samples[name];
+    m_heartbeat.start();
+    QElapsedTimer timer;
+    timer.start();
+    operation();
+    settle();
+    samples.durations.append(timer.nsecsElapsed() / 1.0e6);
+    samples.stalls += m_heartbeat.stop();
+  }
+
+  void typeKey(QWidget *target, int key, const QString &text) {
+    run(key == Qt::Key_Backspace ? "search_backspace" : "search_type",
+        [target, key, text]() {
+          QKeyEvent press(QEvent::KeyPress, key, Qt::NoModifier, text);
+          QApplication::sendEvent(target, &press);
+          QKeyEvent release(QEvent::KeyRelease, key, Qt::NoModifier, text);
+          QApplication::sendEvent(target, &release);
+        });
+  }
+
+  void feed(const QList<PortInfo> &ports) {
+    run("ports_updated", [this, &ports]() {
+      QMetaObject::invokeMethod(m_window, "onPortsUpdated",
+                                Qt::DirectConnection,
+                                Q_ARG(QList<PortInfo>, ports));
+    });
+  }
+
+  // One entry per operation, then forgets them for the next scale
+  QJsonArray report(int rows) {
+    QJsonArray results;
+    for (auto it = m_samples.cbegin(); it != m_samples.cend(); ++it) {
+      QJsonObject result;
+      result["operation"] = it.key();
+      result["rows"] = rows;
+      result["duration"] = BenchStats::summarize(it->durations);
+      result["loop_stall"] = BenchStats::summarize(it->stalls);
+      results.append(result);
+    }
+    m_samples.clear();
+    return results;
+  }
+
+private:
+  MainWindow *m_window;
+  Heartbeat m_heartbeat;
+  QMap<QString, OperationSamples> m_samples;
+};
+
+int main(int argc, char *argv[]) {
+  if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+  QStandardPaths::setTestModeEnabled(true);
+
+  QApplication app(argc, argv);
+  app.setApplicationName("Port Monitor GUI Harness");
+
+  QCommandLineParser parser;
+  parser.setApplicationDescription(
+      "Scripts typical interactions with the main window on synthetic "
+      "snapshots and reports per-operation time and event loop stalls.");
+  parser.addHelpOption();
+  QCommandLineOption scalesOption(
+      "scales", "Comma-separated socket counts (default 1k,10k,100k).",
+      "rows", "1000,10000,100000");
+  QCommandLineOption repeatOption(
+      "repeat", "Times the script runs per scale (default 3).", "count",
+      "3");
+  parser.addOption(scalesOption);
+  parser.addOption(repeatOption);
+  parser.process(app);
+
+  QList<int> scales;
+  for (const QString &value : parser.value(scalesOption).split(',')) {
+    const int rows = value.trimmed().toInt();
+    if (rows > 0)
+      scales.append(rows);
+  }
+  const int repeat = qMax(1, parser.value(repeatOption).toInt());
+
+  MainWindow window;
+  window.resize(1000, 700);
+  window.show();
+
+  // Only synthetic snapshots reach the window: its own scans are stopped
+  // and their results dropped
+  if (QTimer *refresh = window.findChild<QTimer *>("refreshTimer"))
+    refresh->stop();
+  if (PortMonitor *monitor = window.findChild<PortMonitor *>())
+    monitor->blockSignals(true);
+  settle();
+
+  auto *searchBox = window.findChild<QLineEdit *>("searchBox");
+  auto *table = window.findChild<QTableView *>("portTable");
+  auto *trayMenu = window.findChild<QMenu *>("trayMenu");
+  if (!searchBox || !table || !trayMenu) {
+    fprintf(stderr, "Main window widgets not found\n");
+    return 1;
+  }
+
+  Harness harness(&window);
+  QJsonArray results;
+  for (int rows : scales) {
+    fprintf(stderr, "%d rows...\n", rows);
+    const QList<PortInfo> scan = SyntheticData::snapshot(rows);
+    const QList<PortInfo> next = SyntheticData::churn(scan, 0.05);
+    harness.feed(scan);
+    harness.report(rows); // First load is a warm-up
+
+    for (int round = 0; round < repeat; ++round) {
+      harness.feed(round % 2 == 0 ? next : scan);
+
+      for (const QChar c : QString("node"))
+        harness.typeKey(searchBox, Qt::Key_A + (c.unicode() - 'a'), c);
+      for (int i = 0; i < 4; ++i)
+        harness.typeKey(searchBox, Qt::Key_Backspace, QString());
+
+      QScrollBar *scrollBar = table->verticalScrollBar();
+      for (int page = 0; page < 10; ++page) {
+        harness.run("table_scroll_page", [scrollBar]() {
+          scrollBar->setValue(scrollBar->value() + scrollBar->pageStep());
+        });
+      }
+      harness.run("table_scroll_end", [scrollBar]() {
+        scrollBar->setValue(scrollBar->maximum());
+      });
+      harness.run("table_scroll_top", [scrollBar]() {
+        scrollBar->setValue(scrollBar->minimum());
+      });
+
+      for (const QSize &size : {QSize(700, 700), QSize(1400, 900),
+                                QSize(1000, 700)}) {
+        harness.run("window_resize",
+                    [&window, size]() { window.resize(size); });
+      }
+
+      harness.run("tray_menu_open",
+                  [trayMenu]() { trayMenu->popup(QPoint(0, 0)); });
+      harness.run("tray_menu_close", [trayMenu]() { trayMenu->hide(); });
+    }
+    for (const QJsonValue &result : harness.report(rows))
+      results.append(result);
+  }
+
+  QJsonObject report;
+  report["benchmark"] = "gui";
+  report["timestamp"] =
+      QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+  report["qt"] = qVersion();
+  report["platform"] = QGuiApplication::platformName();
+  report["abi"] = QSysInfo::buildAbi();
+  report["heartbeat_ms"] = kHeartbeatMs;
+  report["results"] = results;
+  printf("%s", QJsonDocument(report).toJson(QJsonDocument::Indented).data());
+  return 0;
+}
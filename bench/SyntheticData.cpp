@@ -0,0 +1,176 @@
+/*
+ * Copyright 2025 Kadir Mert Abatay
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "SyntheticData.h"
+#include <QRandomGenerator>
+
+static const char *const kProcesses[] = {
+    "node", "python3", "postgres", "redis-server", "nginx",
+    "java", "ruby",    "dotnet",   "mongod",       "envoy"};
+static const char *const kUsers[] = {"root", "www-data", "dev", "postgres"};
+static const int kServicePorts[] = {3000, 5000, 5432, 6379,
+                                    8000, 8080, 27017, 9000};
+static const char *const kTcpStates[] = {"ESTABLISHED", "ESTABLISHED",
+                                         "ESTABLISHED", "ESTABLISHED",
+                                         "TIME_WAIT",   "CLOSE_WAIT",
+                                         "SYN_SENT",    "FIN_WAIT1"};
+
+template <typename T, size_t N> static int count(T (&)[N]) { return int(N); }
+
+QByteArray SyntheticData::lsofOutput(int rows, quint32 seed) {
+  QRandomGenerator rng(seed);
+  const int processes = qMax(1, rows / 16);
+  QByteArray out;
+  out.reserve(qsizetype(rows) * 110);
+  out += "COMMAND     PID USER   FD   TYPE             DEVICE SIZE/OFF NODE "
+         "NAME\n";
+
+  for (int i = 0; i < rows; ++i) {
+    const int pid = 1000 + int(rng.bounded(processes));
+    const char *name = kProcesses[pid % count(kProcesses)];
+    const char *user = kUsers[pid % count(kUsers)];
+    const int kind = int(rng.bounded(100));
+    const int servicePort = kServicePorts[pid % count(kServicePorts)];
+
+    QByteArray nameField;
+    const char *protocol = "TCP";
+    if (kind < 5) {
+      const int port =
+          kind < 2 ? servicePort : 10000 + int(rng.bounded(50000));
+      nameField = "*:" + QByteArray::number(port) + " (LISTEN)";
+    } else if (kind < 15) {
+      protocol = "UDP";
+      nameField = "*:" + QByteArray::number(1024 + rng.bounded(60000));
+    } else {
+      const char *state = kTcpStates[rng.bounded(count(kTcpStates))];
+      nameField = "127.0.0.1:" + QByteArray::number(servicePort) +
+                  "->10." + QByteArray::number(rng.bounded(256)) + '.' +
+                  QByteArray::number(rng.bounded(256)) + '.' +
+                  QByteArray::number(1 + rng.bounded(254)) + ':' +
+                  QByteArray::number(32768 + rng.bounded(28000)) + " (" +
+                  state + ')';
+    }
+
+    out += name;
+    out += ' ';
+    out += QByteArray::number(pid);
+    out += ' ';
+    out += user;
+    out += ' ';
+    out += QByteArray::number(3 + (i % 1000));
+    out += "u IPv4 0x";
+    out += QByteArray::number(0x7f0000000000ULL + quint64(i) * 64, 16);
+    out += " 0t0 ";
+    out += protocol;
+    out += ' ';
+    out += nameField;
+    out += '\n';
+  }
+  return out;
+}
+
+QByteArray SyntheticData::procNetTcp(int rows, bool v6, quint32 seed) {
+  QRandomGenerator rng(seed);
+  QByteArray out;
+  out.reserve(qsizetype(rows) * (v6 ? 180 : 150));
+  out += "  sl  local_address rem_address   st tx_queue rx_queue tr "
+         "tm->when retrnsmt   uid  timeout inode\n";
+
+  for (int i = 0; i < rows; ++i) {
+    const bool listen = rng.bounded(100) < 5;
+    const int localPort = kServicePorts[rng.bounded(count(kServicePorts))];
+    const int remotePort = listen ? 0 : 32768 + int(rng.bounded(28000));
+    // 127.0.0.1 and a 10.x peer, as the kernel prints them (host order)
+    const quint32 local = 0x0100007F;
+    const quint32 remote =
+        listen ? 0 : 0x0000000A | (rng.bounded(1u << 24) << 8);
+    const int state = listen ? 0x0A : 0x01;
+    const quint32 rx = listen ? rng.bounded(16) : rng.bounded(4096);
+
+    QString line;
+    if (v6) {
+      line = QString::asprintf(
+          "%4d: 0000000000000000FFFF0000%08X:%04X "
+          "0000000000000000FFFF0000%08X:%04X %02X %08X:%08X 00:00000000 "
+          "00000000  1000        0 %d 1 0000000000000000 100 0 0 10 0\n",
+          i, local, localPort, remote, remotePort, state, 0u, rx,
+          100000 + i);
+    } else {
+      line = QString::asprintf(
+          "%4d: %08X:%04X %08X:%04X %02X %08X:%08X 00:00000000 00000000  "
+          "1000        0 %d 1 0000000000000000 100 0 0 10 0\n",
+          i, local, localPort, remote, remotePort, state, 0u, rx,
+          100000 + i);
+    }
+    out += line.toLatin1();
+  }
+  return out;
+}
+
+QList<PortInfo> SyntheticData::snapshot(int rows, quint32 seed) {
+  QList<PortInfo> ports = PortMonitor::parseLsof(lsofOutput(rows, seed));
+  QRandomGenerator rng(seed);
+  for (PortInfo &info : ports) {
+    const qint64 pid = info.pid.toLongLong();
+    info.netns = 4026531840ULL;
+    info.netnsOwner = "host";
+    info.startTime = quint64(pid) * 100;
+    if (pid % 3 == 0)
+      info.unit = info.processName + ".service";
+    if (info.state == "LISTEN") {
+      info.backlog = 511;
+      info.acceptQueue = int(rng.bounded(16));
+    }
+  }
+  return ports;
+}
+
+QList<PortInfo> SyntheticData::churn(const QList<PortInfo> &ports,
+                                     double fraction, quint32 seed) {
+  QList<PortInfo> next = ports;
+  if (next.isEmpty())
+    return next;
+  QRandomGenerator rng(seed);
+  const int changes = qMax(1, int(next.size() * fraction));
+  for (int i = 0; i < changes; ++i) {
+    const int at = int(rng.bounded(next.size()));
+    switch (rng.bounded(3)) {
+    case 0: // Closed
+      next.swapItemsAt(at, next.size() - 1);
+      next.removeLast();
+      break;
+    case 1: { // Opened: another connection of the same process
+      PortInfo opened = next[at];
+      opened.state = "ESTABLISHED";
+      opened.remoteAddress =
+          QString("10.9.%1.%2:%3")
+              .arg(rng.bounded(256))
+              .arg(1 + rng.bounded(254))
+              .arg(32768 + rng.bounded(28000));
+      next.append(opened);
+      break;
+    }
+    default: // New state
+      if (next[at].state != "LISTEN")
+        next[at].state =
+            next[at].state == "CLOSE_WAIT" ? "ESTABLISHED" : "CLOSE_WAIT";
+      break;
+    }
+    if (next.isEmpty())
+      break;
+  }
+  return next;
+}
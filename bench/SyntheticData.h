@@ -0,0 +1,43 @@
+/*
+ * Copyright 2025 Kadir Mert Abatay
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "PortMonitor.h"
+#include <QByteArray>
+#include <QList>
+
+// Deterministic stand-ins for what the scanners read, at any scale. The
+// mix roughly follows a busy dev box: a few listeners on well-known ports,
+// mostly established TCP connections, some UDP, and a process per ~16
+// sockets. The same seed always gives the same data.
+class SyntheticData {
+public:
+  // `lsof -i -P -n` output with `rows` sockets after the header line
+  static QByteArray lsofOutput(int rows, quint32 seed = 1);
+
+  // /proc/net/tcp (or tcp6) content with `rows` sockets
+  static QByteArray procNetTcp(int rows, bool v6, quint32 seed = 1);
+
+  // A scan as PortMonitor emits it: the lsof rows plus namespace, unit and
+  // listener queue details
+  static QList<PortInfo> snapshot(int rows, quint32 seed = 1);
+
+  // The next scan: about `fraction` of the sockets closed, opened or in a
+  // new state
+  static QList<PortInfo> churn(const QList<PortInfo> &ports, double fraction,
+                               quint32 seed = 2);
+};
@@ -0,0 +1,214 @@
+/*
+ * Copyright 2025 Kadir Mert Abatay
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "AgentCollector.h"
+#include "SnapshotProtocol.h"
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTimer>
+#include <algorithm>
+
+// Uncompressed; a snapshot of a million sockets fits. Only agents past
+// the hello get this much; until then a frame is a host name and token.
+static const int kMaxFrameBytes = 512 * 1024 * 1024;
+static const int kMaxHelloBytes = 4 * 1024;
+// Connections still owing a hello; more are turned away
+static const int kMaxPendingHellos = 16;
+// An agent says hello right after connecting
+static const int kHelloTimeoutMs = 10000;
+
+// Takes as long for a wrong token as for a right one
+static bool sameToken(const QString &a, const QString &b) {
+  const QByteArray x = a.toUtf8();
+  const QByteArray y = b.toUtf8();
+  int diff = x.size() ^ y.size();
+  for (int i = 0; i < x.size(); ++i)
+    diff |= x[i] ^ (i < y.size() ? y[i] : 0);
+  return diff == 0;
+}
+
+static void tag(QList<PortInfo> &ports, const QString &host) {
+  for (PortInfo &info : ports)
+    info.host = host;
+}
+
+AgentCollector::AgentCollector(QObject *parent) : QObject(parent) {
+  m_server = new QTcpServer(this);
+  connect(m_server, &QTcpServer::newConnection, this,
+          &AgentCollector::onNewConnection);
+}
+
+AgentCollector::~AgentCollector() {
+  // Sockets die with the server; no signals for a collector going away
+  for (auto it = m_agents.begin(); it != m_agents.end(); ++it)
+    it.key()->disconnect(this);
+}
+
+bool AgentCollector::listen(quint16 port, const QString &token) {
+  close();
+  m_token = token;
+  // Without a token anyone who can connect could report, so only this
+  // machine (and tunnels ending here) may
+  return m_server->listen(token.isEmpty() ? QHostAddress::LocalHost
+                                          : QHostAddress::Any,
+                          port);
+}
+
+void AgentCollector::close() {
+  const QList<QTcpSocket *> sockets = m_agents.keys();
+  for (QTcpSocket *socket : sockets)
+    drop(socket, "Collector closed");
+  m_server->close();
+}
+
+bool AgentCollector::isListening() const { return m_server->isListening(); }
+
+QString AgentCollector::errorString() const {
+  return m_server->errorString();
+}
+
+QStringList AgentCollector::hosts() const {
+  QStringList hosts;
+  for (const Agent &agent : m_agents) {
+    if (!agent.host.isEmpty())
+      hosts.append(agent.host);
+  }
+  std::sort(hosts.begin(), hosts.end());
+  return hosts;
+}
+
+QList<PortInfo> AgentCollector::ports() const {
+  QList<PortInfo> ports;
+  for (const Agent &agent : m_agents) {
+    if (!agent.taggedValid) {
+      agent.tagged = agent.table.sockets().values();
+      tag(agent.tagged, agent.host);
+      agent.taggedValid = true;
+    }
+    ports += agent.tagged;
+  }
+  return ports;
+}
+
+void AgentCollector::onNewConnection() {
+  while (QTcpSocket *socket = m_server->nextPendingConnection()) {
+    int pending = 0;
+    for (const Agent &agent : m_agents)
+      pending += agent.host.isEmpty() ? 1 : 0;
+    if (pending >= kMaxPendingHellos) {
+      socket->abort();
+      socket->deleteLater();
+      continue;
+    }
+    m_agents.insert(socket, Agent());
+    connect(socket, &QTcpSocket::readyRead, this,
+            [this, socket]() { onReadyRead(socket); });
+    connect(socket, &QTcpSocket::disconnected, this,
+            [this, socket]() { drop(socket, socket->errorString()); });
+    QTimer::singleShot(kHelloTimeoutMs, socket, [this, socket]() {
+      if (m_agents.value(socket).host.isEmpty())
+        drop(socket, "No hello");
+    });
+  }
+}
+
+void AgentCollector::onReadyRead(QTcpSocket *socket) {
+  auto it = m_agents.find(socket);
+  if (it == m_agents.end())
+    return;
+  it->buffer.append(socket->readAll());
+
+  quint8 type = 0;
+  QByteArray body;
+  int taken;
+  while ((taken = SnapshotProtocol::takeFrame(
+              it->buffer, it->host.isEmpty() ? kMaxHelloBytes : kMaxFrameBytes,
+              &type, &body)) > 0) {
+    if (it->host.isEmpty()) {
+      QString host, token;
+      if (type != SnapshotProtocol::Hello ||
+          !SnapshotProtocol::readHello(body, &host, &token) ||
+          (!m_token.isEmpty() && !sameToken(token, m_token))) {
+        drop(socket, "Rejected hello");
+        return;
+      }
+      // A reconnect from the same machine replaces a connection that has
+      // not noticed it is dead yet; another machine using the same name
+      // is turned away rather than knocking the first one off
+      QTcpSocket *previous = nullptr;
+      for (auto other = m_agents.begin(); other != m_agents.end(); ++other) {
+        if (other.key() != socket && other->host == host) {
+          previous = other.key();
+          break;
+        }
+      }
+      if (previous) {
+        if (previous->state() == QAbstractSocket::ConnectedState &&
+            previous->peerAddress() != socket->peerAddress()) {
+          drop(socket, "Host name " + host + " is already connected");
+          return;
+        }
+        drop(previous, "Replaced by a new connection");
+      }
+      it = m_agents.find(socket);
+      it->host = host;
+      emit hostConnected(host);
+      continue;
+    }
+
+    SnapshotDelta delta;
+    if (!SnapshotProtocol::apply(type, body, &it->table, &delta)) {
+      drop(socket, "Malformed message");
+      return;
+    }
+    if (delta.isEmpty())
+      continue;
+    it->taggedValid = false;
+    tag(delta.added, it->host);
+    tag(delta.removed, it->host);
+    tag(delta.changed, it->host);
+    const QString host = it->host;
+    emit hostUpdated(host, delta);
+    // A slot may have closed the collector
+    it = m_agents.find(socket);
+    if (it == m_agents.end())
+      return;
+  }
+  if (taken < 0)
+    drop(socket, "Oversized message");
+}
+
+void AgentCollector::drop(QTcpSocket *socket, const QString &reason) {
+  auto it = m_agents.find(socket);
+  if (it == m_agents.end())
+    return;
+  const QString host = it->host;
+  SnapshotDelta gone;
+  gone.removed = it->table.sockets().values();
+  tag(gone.removed, host);
+  m_agents.erase(it);
+
+  socket->disconnect(this);
+  socket->abort();
+  socket->deleteLater();
+  if (host.isEmpty())
+    return;
+  // Disconnected first: the removal that follows means the host is gone
+  // from view, not that its sockets closed
+  emit hostDisconnected(host, reason);
+  if (!gone.isEmpty())
+    emit hostUpdated(host, gone);
+}
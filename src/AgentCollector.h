@@ -0,0 +1,72 @@
+/*
+ * Copyright 2025 Kadir Mert Abatay
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "SnapshotDiff.h"
+#include <QHash>
+#include <QObject>
+
+class QTcpServer;
+class QTcpSocket;
+
+// Central side of multi-host monitoring: accepts SnapshotAgent connections
+// and keeps one table per host, its sockets tagged with the host name. A
+// host's sockets go away when its agent disconnects. A reconnect from the
+// same address replaces the old connection and starts from its snapshot;
+// a second machine claiming a connected host name is refused.
+class AgentCollector : public QObject {
+  Q_OBJECT
+
+public:
+  explicit AgentCollector(QObject *parent = nullptr);
+  ~AgentCollector() override;
+
+  // Agents must present `token` if it is not empty. Without a token only
+  // connections from this machine are accepted.
+  bool listen(quint16 port, const QString &token = QString());
+  void close();
+  bool isListening() const;
+  QString errorString() const;
+
+  QStringList hosts() const; // Connected agents, sorted
+  // Every agent's sockets, tagged with their host
+  QList<PortInfo> ports() const;
+
+signals:
+  void hostConnected(const QString &host);
+  // Emitted before the update that removes the host's sockets
+  void hostDisconnected(const QString &host, const QString &reason);
+  // Tagged with the host; on disconnect everything is removed
+  void hostUpdated(const QString &host, const SnapshotDelta &delta);
+
+private:
+  struct Agent {
+    QString host; // Empty until the hello
+    QByteArray buffer;
+    SnapshotDiff table;
+    mutable QList<PortInfo> tagged; // Cache for ports()
+    mutable bool taggedValid = false;
+  };
+
+  void onNewConnection();
+  void onReadyRead(QTcpSocket *socket);
+  void drop(QTcpSocket *socket, const QString &reason);
+
+  QTcpServer *m_server;
+  QString m_token;
+  QHash<QTcpSocket *, Agent> m_agents;
+};
@@ -0,0 +1,607 @@
+/*
+ * Copyright 2025 Kadir Mert Abatay
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "AlertEngine.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QProcess>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QTimer>
+
+// Hooks beyond this many at once are skipped rather than queued
+static const int kMaxCommands = 4;
+static const int kCommandTimeoutMs = 10000;
+// Alerts kept per rule while rate limited; the rest are only counted
+static const int kMaxHeld = 100;
+
+const QString AlertEngine::kAnyHost = "*";
+
+static const char *const kKindNames[] = {"newListener", "portDown",
+                                         "stateCount"};
+
+AlertEngine::AlertEngine(QObject *parent) : QObject(parent) {
+  qRegisterMetaType<Alert>();
+  m_clock.start();
+  m_timer = new QTimer(this);
+  m_timer->setSingleShot(true);
+  connect(m_timer, &QTimer::timeout, this, &AlertEngine::settle);
+}
+
+void AlertEngine::setRules(const QList<AlertRule> &rules) {
+  m_rules = rules;
+  m_watchers.clear();
+  m_instances.clear();
+  m_pending.clear();
+  m_limits.clear();
+  m_timer->stop();
+  for (int i = 0; i < m_rules.size(); ++i) {
+    AlertRule &rule = m_rules[i];
+    rule.state = rule.state.toUpper();
+    if (rule.clearAtOrBelow < 0)
+      rule.clearAtOrBelow = rule.above;
+    if (rule.kind == AlertRule::PortDown && rule.port > 0)
+      m_watchers[countKey(rule.host, "LISTEN", rule.port)].append(i);
+    else if (rule.kind == AlertRule::StateCount)
+      m_watchers[countKey(rule.host, rule.state, rule.port)].append(i);
+  }
+  // Conditions already true start their forSeconds now
+  for (int i = 0; i < m_rules.size(); ++i) {
+    const AlertRule &rule = m_rules[i];
+    if (rule.kind == AlertRule::NewListener)
+      continue;
+    if (rule.host != kAnyHost) {
+      evaluateRule(i, rule.host);
+      continue;
+    }
+    for (const QString &host : std::as_const(m_baselined))
+      evaluateRule(i, host);
+  }
+  settle();
+}
+
+void AlertEngine::update(const QList<PortInfo> &ports) {
+  apply(m_diff.update(ports));
+  m_baselined.insert(QString());
+}
+
+void AlertEngine::apply(const SnapshotDelta &delta) {
+  QSet<QString> touched;
+  QList<PortInfo> listening;
+  QList<QPair<QString, int>> closed;
+  QSet<QString> hosts;
+
+  // Listeners per port before this delta: a restart or reload arrives as
+  // remove plus add under a new PID, and is not a new listener
+  QHash<QString, int> listenedBefore;
+  for (const QList<PortInfo> *list : {&delta.added, &delta.changed}) {
+    for (const PortInfo &info : *list) {
+      if (info.state == "LISTEN") {
+        const QString key = countKey(info.host, "LISTEN", info.port);
+        listenedBefore.insert(key, m_counts.value(key));
+      }
+    }
+  }
+
+  auto remove = [&](const PortInfo &info) {
+    auto it = m_sockets.find(info.host + '\n' + SnapshotDiff::key(info));
+    if (it == m_sockets.end())
+      return;
+    count(it.value(), -1, &touched);
+    if (it->state == "LISTEN")
+      closed.append({it->host, it->port});
+    m_sockets.erase(it);
+  };
+  auto add = [&](const PortInfo &info) {
+    const QString key = info.host + '\n' + SnapshotDiff::key(info);
+    auto it = m_sockets.find(key);
+    const bool wasListening = (it != m_sockets.end() && it->state == "LISTEN");
+    if (it != m_sockets.end())
+      count(it.value(), -1, &touched);
+    m_sockets.insert(key, info);
+    count(info, 1, &touched);
+    hosts.insert(info.host);
+    if (info.state == "LISTEN" && !wasListening)
+      listening.append(info);
+    else if (info.state != "LISTEN" && wasListening)
+      closed.append({info.host, info.port});
+  };
+  for (const PortInfo &info : delta.removed)
+    remove(info);
+  for (const PortInfo &info : delta.changed)
+    add(info);
+  for (const PortInfo &info : delta.added)
+    add(info);
+
+  // A host's first delta is everything it has; none of that is news
+  for (const PortInfo &info : listening) {
+    if (m_baselined.contains(info.host) &&
+        listenedBefore.value(countKey(info.host, "LISTEN", info.port)) == 0) {
+      listenerSeen(info);
+    }
+  }
+  for (const auto &port : closed)
+    listenerGone(port.first, port.second);
+  m_baselined += hosts;
+
+  // Rule -> hosts to re-check; "*" rules watch the same counts of every
+  // host, keyed "*\n<state>\n<port>"
+  QHash<int, QSet<QString>> rules;
+  for (const QString &key : touched) {
+    const int split = key.indexOf('\n');
+    const QString host = key.left(split);
+    for (const QString &watched : {key, kAnyHost + key.mid(split)}) {
+      for (int rule : m_watchers.value(watched))
+        rules[rule].insert(host);
+    }
+  }
+  for (auto it = rules.cbegin(); it != rules.cend(); ++it) {
+    for (const QString &host : it.value())
+      evaluateRule(it.key(), host);
+  }
+  settle();
+}
+
+void AlertEngine::forgetHost(const QString &host) {
+  const QString prefix = host + '\n';
+  auto dropPrefixed = [&prefix](auto &container) {
+    for (auto it = container.begin(); it != container.end();) {
+      if (it.key().startsWith(prefix))
+        it = container.erase(it);
+      else
+        ++it;
+    }
+  };
+  dropPrefixed(m_sockets);
+  dropPrefixed(m_counts);
+  for (auto it = m_everListening.begin(); it != m_everListening.end();) {
+    if (it->startsWith(prefix))
+      it = m_everListening.erase(it);
+    else
+      ++it;
+  }
+  m_baselined.remove(host);
+  for (auto it = m_instances.begin(); it != m_instances.end();) {
+    if (it->host == host) {
+      m_pending.remove(it.key());
+      it = m_instances.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+void AlertEngine::raise(const Alert &alert, int repeatSeconds) {
+  deliver(alert, repeatSeconds);
+}
+
+QString AlertEngine::countKey(const QString &host, const QString &state,
+                              int port) {
+  return host + '\n' + state + '\n' + QString::number(port);
+}
+
+void AlertEngine::count(const PortInfo &info, int sign,
+                        QSet<QString> *touched) {
+  for (int port : {info.port, 0}) {
+    const QString key = countKey(info.host, info.state, port);
+    const int n = m_counts.value(key) + sign;
+    if (n > 0)
+      m_counts.insert(key, n);
+    else
+      m_counts.remove(key);
+    touched->insert(key);
+  }
+  if (sign > 0 && info.state == "LISTEN")
+    m_everListening.insert(info.host + '\n' + QString::number(info.port));
+}
+
+void AlertEngine::evaluateRule(int index, const QString &host) {
+  const AlertRule &rule = m_rules[index];
+  const QString key = QString("%1\n%2").arg(index).arg(host);
+  auto it = m_instances.find(key);
+  const bool firing = (it != m_instances.end() && it->firing);
+
+  bool condition;
+  if (rule.kind == AlertRule::PortDown) {
+    // Only a port seen listening can go down
+    condition =
+        m_everListening.contains(host + '\n' + QString::number(rule.port)) &&
+        !m_counts.contains(countKey(host, "LISTEN", rule.port));
+  } else {
+    // Fires above `above`, clears only at or below `clearAtOrBelow`
+    const int n = m_counts.value(countKey(host, rule.state, rule.port));
+    condition = n > (firing ? rule.clearAtOrBelow : rule.above);
+  }
+
+  if (it == m_instances.end()) {
+    if (!condition)
+      return;
+    it = m_instances.insert(key, Instance());
+    it->rule = index;
+    it->host = host;
+    it->port = rule.port;
+  }
+  setCondition(key, it.value(), condition);
+}
+
+void AlertEngine::listenerSeen(const PortInfo &info) {
+  for (int i = 0; i < m_rules.size(); ++i) {
+    const AlertRule &rule = m_rules[i];
+    if (rule.kind != AlertRule::NewListener ||
+        (rule.host != kAnyHost && rule.host != info.host) ||
+        (rule.port != 0 && rule.port != info.port) ||
+        (!rule.users.isEmpty() && rule.users.contains(info.user))) {
+      continue;
+    }
+    const QString key = QString("%1\n%2\n%3").arg(i).arg(info.host).arg(
+        info.port);
+    Instance &instance = m_instances[key];
+    instance.rule = i;
+    instance.host = info.host;
+    instance.port = info.port;
+    instance.socket = info;
+    setCondition(key, instance, true);
+  }
+}
+
+void AlertEngine::listenerGone(const QString &host, int port) {
+  if (m_counts.contains(countKey(host, "LISTEN", port)))
+    return; // Another socket still listens there
+  for (int i = 0; i < m_rules.size(); ++i) {
+    if (m_rules[i].kind != AlertRule::NewListener)
+      continue;
+    const QString key = QString("%1\n%2\n%3").arg(i).arg(host).arg(port);
+    auto it = m_instances.find(key);
+    if (it != m_instances.end())
+      setCondition(key, it.value(), false);
+  }
+}
+
+void AlertEngine::setCondition(const QString &key, Instance &instance,
+                               bool condition) {
+  if (instance.condition != condition) {
+    instance.condition = condition;
+    instance.sinceMs = m_clock.elapsed();
+  }
+  m_pending.insert(key);
+}
+
+void AlertEngine::settle() {
+  const qint64 now = m_clock.elapsed();
+  qint64 next = -1;
+  QList<QPair<QString, Alert>> raised;
+  QList<Alert> resolved;
+  for (auto it = m_pending.begin(); it != m_pending.end();) {
+    auto instance = m_instances.find(*it);
+    if (instance == m_instances.end()) {
+      it = m_pending.erase(it);
+      continue;
+    }
+    if (instance->condition != instance->firing) {
+      const AlertRule &rule = m_rules[instance->rule];
+      const qint64 due =
+          instance->sinceMs +
+          1000LL * (instance->condition ? rule.forSeconds : rule.clearSeconds);
+      if (due > now) {
+        next = (next < 0) ? due : qMin(next, due);
+        ++it;
+        continue;
+      }
+      instance->firing = instance->condition;
+      if (instance->firing)
+        raised.append({*it, makeAlert(instance.value())});
+      else if (instance->notified)
+        resolved.append(makeAlert(instance.value()));
+    }
+    if (!instance->firing)
+      m_instances.erase(instance);
+    it = m_pending.erase(it);
+  }
+
+  // Rules whose rate limit window ended send what they held back, as the
+  // first held alert standing for the rest. Alerts whose condition cleared
+  // during the window are dropped: they were never sent, so no resolution
+  // would follow them.
+  QList<Alert> summaries;
+  for (auto it = m_limits.begin(); it != m_limits.end(); ++it) {
+    Limit &limit = it.value();
+    if (limit.heldCount == 0)
+      continue;
+    const qint64 due = limit.lastMs + 1000LL * limit.repeatSeconds;
+    if (due > now) {
+      next = (next < 0) ? due : qMin(next, due);
+      continue;
+    }
+    QList<Alert> live;
+    int cleared = 0;
+    for (const auto &held : std::as_const(limit.held)) {
+      if (held.first.isEmpty()) {
+        live.append(held.second); // Raised from outside, nothing to check
+        continue;
+      }
+      auto instance = m_instances.find(held.first);
+      if (instance == m_instances.end() || !instance->firing) {
+        cleared++;
+        continue;
+      }
+      instance->notified = true;
+      live.append(held.second);
+    }
+    if (!live.isEmpty()) {
+      Alert summary = live.first();
+      summary.suppressed = limit.heldCount - cleared - 1;
+      summaries.append(summary);
+      limit.lastMs = now;
+    }
+    limit.held.clear();
+    limit.heldCount = 0;
+  }
+
+  if (next >= 0)
+    m_timer->start(int(next - now));
+  else
+    m_timer->stop();
+
+  // Delivered last, as a slot may replace the rules
+  for (const Alert &alert : summaries)
+    notify(alert);
+  for (const Alert &alert : resolved)
+    deliver(alert, 0);
+  for (const auto &entry : raised) {
+    auto instance = m_instances.find(entry.first);
+    if (instance == m_instances.end() || !instance->firing)
+      continue;
+    const int repeatSeconds = m_rules[instance->rule].repeatSeconds;
+    instance->notified = deliver(entry.second, repeatSeconds, entry.first);
+  }
+}
+
+Alert AlertEngine::makeAlert(const Instance &instance) const {
+  const AlertRule &rule = m_rules[instance.rule];
+  Alert alert;
+  alert.rule = rule.name;
+  alert.firing = instance.firing;
+  alert.host = instance.host;
+  alert.port = instance.port ? instance.port : instance.socket.port;
+  alert.socket = instance.socket;
+
+  const QString where =
+      instance.host.isEmpty() ? QString() : instance.host + ": ";
+  switch (rule.kind) {
+  case AlertRule::NewListener:
+    alert.message =
+        alert.firing
+            ? QString("%1%2 (%3) listening on %4 port %5 as %6")
+                  .arg(where, instance.socket.processName,
+                       instance.socket.pid, instance.socket.protocol)
+                  .arg(alert.port)
+                  .arg(instance.socket.user)
+            : QString("%1port %2 no longer listening").arg(where).arg(
+                  alert.port);
+    break;
+  case AlertRule::PortDown:
+    alert.message = alert.firing
+                        ? QString("%1port %2 is down").arg(where).arg(
+                              alert.port)
+                        : QString("%1port %2 is back up").arg(where).arg(
+                              alert.port);
+    break;
+  case AlertRule::StateCount: {
+    const int n =
+        m_counts.value(countKey(instance.host, rule.state, rule.port));
+    const QString scope =
+        rule.port ? QString(" on port %1").arg(rule.port) : QString();
+    alert.message = QString("%1%2 sockets in %3%4")
+                        .arg(where)
+                        .arg(n)
+                        .arg(rule.state, scope);
+    break;
+  }
+  }
+  return alert;
+}
+
+bool AlertEngine::deliver(const Alert &alert, int repeatSeconds,
+                          const QString &key) {
+  if (alert.firing) {
+    Limit &limit = m_limits[alert.rule];
+    const qint64 now = m_clock.elapsed();
+    limit.repeatSeconds = repeatSeconds;
+    const qint64 wait = limit.lastMs + 1000LL * repeatSeconds - now;
+    if (limit.lastMs >= 0 && wait > 0) {
+      // Sent with the others when the window ends (see settle)
+      if (limit.held.size() < kMaxHeld)
+        limit.held.append({key, alert});
+      limit.heldCount++;
+      if (!m_timer->isActive() || m_timer->remainingTime() > wait)
+        m_timer->start(int(wait));
+      return false;
+    }
+    limit.lastMs = now;
+  }
+  notify(alert);
+  return true;
+}
+
+void AlertEngine::notify(const Alert &alert) {
+  runCommand(alert);
+  if (alert.firing)
+    emit alertRaised(alert);
+  else
+    emit alertResolved(alert);
+}
+
+void AlertEngine::runCommand(const Alert &alert) {
+  if (m_command.isEmpty())
+    return;
+  QStringList args = QProcess::splitCommand(m_command);
+  if (args.isEmpty())
+    return;
+  if (m_runningCommands >= kMaxCommands) {
+    qWarning("Alert command still running; not run for \"%s\"",
+             qPrintable(alert.message));
+    return;
+  }
+
+  QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+  env.insert("PORTMONITOR_ALERT_RULE", alert.rule);
+  env.insert("PORTMONITOR_ALERT_STATE", alert.firing ? "firing" : "resolved");
+  env.insert("PORTMONITOR_ALERT_MESSAGE", alert.message);
+  env.insert("PORTMONITOR_ALERT_HOST", alert.host);
+  env.insert("PORTMONITOR_ALERT_PORT", QString::number(alert.port));
+  env.insert("PORTMONITOR_ALERT_PID", alert.socket.pid);
+  env.insert("PORTMONITOR_ALERT_PROCESS", alert.socket.processName);
+  env.insert("PORTMONITOR_ALERT_SUPPRESSED",
+             QString::number(alert.suppressed));
+
+  QProcess *process = new QProcess(this);
+  process->setProcessEnvironment(env);
+  process->setProcessChannelMode(QProcess::ForwardedChannels);
+  m_runningCommands++;
+  connect(process,
+          QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), this,
+          [this, process]() {
+            m_runningCommands--;
+            process->deleteLater();
+          });
+  connect(process, &QProcess::errorOccurred, this,
+          [this, process](QProcess::ProcessError error) {
+            // Only a failed start ends without finished()
+            if (error != QProcess::FailedToStart)
+              return;
+            qWarning("Alert command: %s", qPrintable(process->errorString()));
+            m_runningCommands--;
+            process->deleteLater();
+          });
+  QTimer::singleShot(kCommandTimeoutMs, process, &QProcess::kill);
+  const QString program = args.takeFirst();
+  process->start(program, args);
+}
+
+QString AlertEngine::defaultPath() {
+  return QStandardPaths::writableLocation(QStandardPaths::AppConfigLocation) +
+         "/alerts.json";
+}
+
+QList<AlertRule> AlertEngine::load(const QString &path, QString *error) {
+  if (!QFile::exists(path))
+    return defaultRules();
+
+  QFile file(path);
+  if (!file.open(QIODevice::ReadOnly)) {
+    if (error)
+      *error = file.errorString();
+    return {};
+  }
+  QJsonParseError parseError;
+  const QJsonDocument doc =
+      QJsonDocument::fromJson(file.readAll(), &parseError);
+  if (!doc.isArray()) {
+    if (error) {
+      *error = parseError.error != QJsonParseError::NoError
+                   ? parseError.errorString()
+                   : QString("expected an array of rules");
+    }
+    return {};
+  }
+
+  QList<AlertRule> rules;
+  const AlertRule defaults;
+  for (const QJsonValue &value : doc.array()) {
+    const QJsonObject object = value.toObject();
+    AlertRule rule;
+    const QString kind = object["kind"].toString();
+    int k = 0;
+    while (k < 3 && kind != kKindNames[k])
+      k++;
+    if (k == 3) {
+      if (error)
+        *error = QString("unknown rule kind \"%1\"").arg(kind);
+      return {};
+    }
+    rule.kind = AlertRule::Kind(k);
+    rule.name = object["name"].toString(kind);
+    rule.host = object["host"].toString();
+    rule.port = object["port"].toInt();
+    rule.state = object["state"].toString();
+    rule.above = object["above"].toInt();
+    rule.clearAtOrBelow = object["clearAtOrBelow"].toInt(-1);
+    for (const QJsonValue &user : object["users"].toArray())
+      rule.users.append(user.toString());
+    rule.forSeconds = object["forSeconds"].toInt(defaults.forSeconds);
+    rule.clearSeconds = object["clearSeconds"].toInt(defaults.clearSeconds);
+    rule.repeatSeconds =
+        object["repeatSeconds"].toInt(defaults.repeatSeconds);
+    rules.append(rule);
+  }
+  return rules;
+}
+
+bool AlertEngine::save(const QString &path, const QList<AlertRule> &rules) {
+  QJsonArray array;
+  for (const AlertRule &rule : rules) {
+    QJsonObject object;
+    object["name"] = rule.name;
+    object["kind"] = kKindNames[rule.kind];
+    if (!rule.host.isEmpty())
+      object["host"] = rule.host;
+    if (rule.port != 0)
+      object["port"] = rule.port;
+    if (rule.kind == AlertRule::StateCount) {
+      object["state"] = rule.state;
+      object["above"] = rule.above;
+      if (rule.clearAtOrBelow >= 0)
+        object["clearAtOrBelow"] = rule.clearAtOrBelow;
+    }
+    if (!rule.users.isEmpty())
+      object["users"] = QJsonArray::fromStringList(rule.users);
+    object["forSeconds"] = rule.forSeconds;
+    object["clearSeconds"] = rule.clearSeconds;
+    object["repeatSeconds"] = rule.repeatSeconds;
+    array.append(object);
+  }
+
+  QDir().mkpath(QFileInfo(path).absolutePath());
+  QSaveFile file(path);
+  if (!file.open(QIODevice::WriteOnly))
+    return false;
+  file.write(QJsonDocument(array).toJson());
+  return file.commit();
+}
+
+QList<AlertRule> AlertEngine::defaultRules() {
+  // What the tray used to announce, minus the flapping
+  AlertRule newListener;
+  newListener.name = "New listener";
+  newListener.kind = AlertRule::NewListener;
+  newListener.host = AlertEngine::kAnyHost;
+  newListener.clearSeconds = 30;
+  newListener.repeatSeconds = 10;
+
+  AlertRule closeWait;
+  closeWait.name = "CLOSE_WAIT build-up";
+  closeWait.kind = AlertRule::StateCount;
+  closeWait.host = AlertEngine::kAnyHost;
+  closeWait.state = "CLOSE_WAIT";
+  closeWait.above = 50;
+  closeWait.clearAtOrBelow = 10;
+  closeWait.forSeconds = 30;
+  closeWait.repeatSeconds = 300;
+  return {newListener, closeWait};
+}
@@ -0,0 +1,158 @@
+/*
+ * Copyright 2025 Kadir Mert Abatay
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "SnapshotDiff.h"
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMetaType>
+#include <QObject>
+#include <QSet>
+#include <QStringList>
+
+class QTimer;
+
+struct AlertRule {
+  enum Kind {
+    NewListener, // A port starts listening, optionally by an unexpected user
+    PortDown,    // A port that was listening no longer is
+    StateCount,  // More than `above` sockets in `state`
+  };
+
+  QString name;
+  Kind kind = NewListener;
+  QString host;  // Agent host name; empty: this machine; "*": every host
+  int port = 0;  // 0: any port (NewListener, StateCount)
+  QString state; // StateCount, e.g. "CLOSE_WAIT"
+  int above = 0; // StateCount: fires above this many sockets...
+  int clearAtOrBelow = -1; // ...and clears at or below this (-1: `above`)
+  QStringList users;       // NewListener: expected owners; empty: anyone
+  int forSeconds = 0;      // Condition must hold this long to fire...
+  int clearSeconds = 30;   // ...and be gone this long to clear
+  int repeatSeconds = 60;  // Minimum gap between notifications of a rule
+};
+
+struct Alert {
+  QString rule;
+  bool firing = true; // false: resolved
+  QString message;
+  QString host;
+  int port = 0;
+  PortInfo socket;    // The socket involved, if any
+  int suppressed = 0; // Further alerts of the rule this one stands for
+};
+
+Q_DECLARE_METATYPE(Alert)
+
+// Evaluates alert rules as scans come in. Only what a delta touches is
+// looked at: per-state socket counts are kept up to date from the added,
+// removed and changed sockets, and a rule is re-checked when one of its
+// counts moves. Conditions must hold for forSeconds before an alert fires
+// and be gone for clearSeconds before it resolves, so a flapping service
+// stays one alert; beyond that, a rule notifies at most once per
+// repeatSeconds, and what it held back and is still firing goes out as one
+// summary when the window ends. Alerts are emitted and, if a command is
+// set, handed to it in PORTMONITOR_ALERT_* variables.
+class AlertEngine : public QObject {
+  Q_OBJECT
+
+public:
+  // AlertRule::host matching this machine and every agent
+  static const QString kAnyHost;
+
+  explicit AlertEngine(QObject *parent = nullptr);
+
+  void setRules(const QList<AlertRule> &rules);
+  QList<AlertRule> rules() const { return m_rules; }
+
+  // Run for every alert and resolution; split like a shell command line
+  void setCommand(const QString &command) { m_command = command; }
+
+  // This host's scan; the first one is the baseline and raises nothing new
+  void update(const QList<PortInfo> &ports);
+  // Sockets tagged with a host, e.g. from an AgentCollector; a host's first
+  // delta is its baseline
+  void apply(const SnapshotDelta &delta);
+  // Drops a host's sockets and alerts without resolving them; a delta that
+  // then removes them changes nothing
+  void forgetHost(const QString &host);
+
+  // Delivers an alert evaluated elsewhere, rate limited like the rules'
+  void raise(const Alert &alert, int repeatSeconds = 300);
+
+  // <config dir>/alerts.json
+  static QString defaultPath();
+  // The defaults when the file does not exist; empty with `error` set when
+  // it cannot be parsed
+  static QList<AlertRule> load(const QString &path, QString *error = nullptr);
+  static bool save(const QString &path, const QList<AlertRule> &rules);
+  static QList<AlertRule> defaultRules();
+
+signals:
+  void alertRaised(const Alert &alert);
+  void alertResolved(const Alert &alert);
+
+private:
+  struct Instance {
+    int rule = -1;
+    QString host;
+    int port = 0;
+    bool condition = false;
+    bool firing = false;
+    bool notified = false; // Firing got past the rate limit
+    qint64 sinceMs = 0;    // When the condition last changed
+    PortInfo socket;
+  };
+
+  struct Limit {
+    qint64 lastMs = -1;
+    int repeatSeconds = 0;
+    QList<QPair<QString, Alert>> held; // Instance key (or empty), alert
+    int heldCount = 0;                 // Including those not kept
+  };
+
+  static QString countKey(const QString &host, const QString &state,
+                          int port);
+  void count(const PortInfo &info, int sign, QSet<QString> *touched);
+  void evaluateRule(int rule, const QString &host);
+  void listenerSeen(const PortInfo &info);
+  void listenerGone(const QString &host, int port);
+  void setCondition(const QString &key, Instance &instance, bool condition);
+  void settle();
+  Alert makeAlert(const Instance &instance) const;
+  bool deliver(const Alert &alert, int repeatSeconds,
+               const QString &key = QString());
+  void notify(const Alert &alert);
+  void runCommand(const Alert &alert);
+
+  QList<AlertRule> m_rules;
+  // Count key -> rules that watch it (PortDown, StateCount)
+  QHash<QString, QList<int>> m_watchers;
+  QString m_command;
+  int m_runningCommands = 0;
+
+  SnapshotDiff m_diff; // This host's previous scan
+  QHash<QString, PortInfo> m_sockets; // Every host's sockets, by host + key
+  QHash<QString, int> m_counts;       // host|state|port (0: any) -> sockets
+  QSet<QString> m_everListening;      // host|port, arms PortDown
+  QSet<QString> m_baselined;          // Hosts past their first delta
+
+  QHash<QString, Instance> m_instances;
+  QSet<QString> m_pending; // Instances waiting out forSeconds/clearSeconds
+  QHash<QString, Limit> m_limits; // By rule name
+  QElapsedTimer m_clock;
+  QTimer *m_timer; // Next forSeconds/clearSeconds deadline
+};
@@ -0,0 +1,128 @@
+/*
+ * Copyright 2025 Kadir Mert Abatay
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "CgroupResolver.h"
+#include "ProcessInfoCache.h"
+#include <QFile>
+#include <QRegularExpression>
+
+CgroupInfo CgroupResolver::lookup(qint64 pid) {
+#ifdef Q_OS_LINUX
+  if (pid <= 0)
+    return CgroupInfo();
+  return lookup(pid, ProcessInfoCache::readStartTime(pid));
+#else
+  Q_UNUSED(pid);
+  return CgroupInfo();
+#endif
+}
+
+CgroupInfo CgroupResolver::lookup(qint64 pid, quint64 startTime) {
+#ifdef Q_OS_LINUX
+  if (pid <= 0)
+    return CgroupInfo();
+
+  auto it = m_entries.constFind(pid);
+  if (it != m_entries.constEnd() && it->startTime == startTime)
+    return it->info;
+
+  QFile file(QString("/proc/%1/cgroup").arg(pid));
+  CgroupInfo info;
+  if (file.open(QIODevice::ReadOnly))
+    info = parse(file.readAll());
+  // Also cache failures (exited or foreign process) until the PID changes
+  m_entries.insert(pid, {startTime, info});
+  return info;
+#else
+  Q_UNUSED(pid);
+  Q_UNUSED(startTime);
+  return CgroupInfo();
+#endif
+}
+
+void CgroupResolver::retainOnly(const QSet<qint64> &livePids) {
+  for (auto it = m_entries.begin(); it != m_entries.end();) {
+    if (!livePids.contains(it.key()))
+      it = m_entries.erase(it);
+    else
+      ++it;
+  }
+}
+
+CgroupInfo CgroupResolver::parse(const QByteArray &cgroupFile) {
+  // "hierarchy:controllers:path"; the unified (v2) hierarchy is "0::path",
+  // on v1 hosts systemd keeps its own "name=systemd" hierarchy
+  QByteArray path;
+  for (const QByteArray &line : cgroupFile.split('\n')) {
+    const QList<QByteArray> fields = line.split(':');
+    if (fields.size() < 3)
+      continue;
+    const QByteArray linePath = fields.mid(2).join(':').trimmed();
+    if (fields[0] == "0" && fields[1].isEmpty()) {
+      path = linePath;
+      break;
+    }
+    if (fields[1] == "name=systemd" || path.isEmpty())
+      path = linePath;
+  }
+
+  CgroupInfo info;
+  info.path = QString::fromUtf8(path);
+  if (info.path.isEmpty() || info.path == "/")
+    return info;
+
+  // docker-<id>.scope (systemd driver), /docker/<id> (cgroupfs driver),
+  // cri-containerd-<id>.scope, crio-<id>.scope, libpod-<id>.scope, ...
+  static const QRegularExpression containerRe(
+      "^(?:([a-z-]+?)-)?([0-9a-f]{64})(?:\\.scope)?$");
+
+  const QStringList parts = info.path.split('/', Qt::SkipEmptyParts);
+  for (int i = parts.size() - 1; i >= 0; --i) {
+    const QString &part = parts[i];
+
+    QRegularExpressionMatch match = containerRe.match(part);
+    if (match.hasMatch() && info.container.isEmpty()) {
+      QString runtime = match.captured(1);
+      if (runtime.isEmpty()) {
+        const QString parent = parts.value(i - 1);
+        runtime = parent.startsWith("kubepods") || parent.startsWith("pod")
+                      ? "k8s"
+                      : parent;
+      }
+      if (runtime == "cri-containerd")
+        runtime = "containerd";
+      else if (runtime == "libpod")
+        runtime = "podman";
+      else if (runtime == "crio")
+        runtime = "cri-o";
+      if (runtime.isEmpty())
+        runtime = "container";
+      info.container = runtime + ":" + match.captured(2).left(12);
+      continue;
+    }
+
+    if (part.startsWith("lxc.payload.") && info.container.isEmpty()) {
+      info.container = "lxc:" + part.mid(12);
+      continue;
+    }
+
+    if (info.unit.isEmpty() &&
+        (part.endsWith(".service") || part.endsWith(".scope"))) {
+      info.unit = part;
+    }
+  }
+  return info;
+}
@@ -0,0 +1,55 @@
+/*
+ * Copyright 2025 Kadir Mert Abatay
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <QHash>
+#include <QSet>
+#include <QString>
+
+struct CgroupInfo {
+  QString path;      // e.g. "/system.slice/nginx.service"
+  QString unit;      // systemd unit, e.g. "nginx.service"
+  QString container; // "<runtime>:<short id>", e.g. "docker:3f2a9c81d0e4"
+
+  // What the UI shows: the container if any, else the unit
+  QString label() const { return container.isEmpty() ? unit : container; }
+};
+
+// Maps PIDs to the systemd unit or container that owns them, from
+// /proc/<pid>/cgroup. Results are cached per (pid, start time), so a scan
+// only pays for a stat read per process and a reused PID is re-resolved.
+// Linux only; elsewhere every lookup is empty.
+class CgroupResolver {
+public:
+  CgroupInfo lookup(qint64 pid);
+  // Same, for a caller that already read the process's start time
+  CgroupInfo lookup(qint64 pid, quint64 startTime);
+
+  // Forgets every PID not in `livePids`
+  void retainOnly(const QSet<qint64> &livePids);
+
+  // Parses the contents of a /proc/<pid>/cgroup file
+  static CgroupInfo parse(const QByteArray &cgroupFile);
+
+private:
+  struct Entry {
+    quint64 startTime;
+    CgroupInfo info;
+  };
+
+  QHash<qint64, Entry> m_entries;
+};
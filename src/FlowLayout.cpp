@@ -1,6 +1,16 @@
 #include "FlowLayout.h"
 #include <QWidget>
 
+// Stand-in for an item whose widget has not been created yet
+class FlowPlaceholder : public QSpacerItem {
+public:
+  explicit FlowPlaceholder(const QSize &size)
+      : QSpacerItem(size.width(), size.height(), QSizePolicy::Fixed,
+                    QSizePolicy::Fixed) {}
+
+  bool hidden = false;
+};
+
 FlowLayout::FlowLayout(QWidget *parent, int margin, int hSpacing, int vSpacing)
     : QLayout(parent), m_hSpace(hSpacing), m_vSpace(vSpacing) {
   setContentsMargins(margin, margin, margin, margin);
@@ -12,12 +22,56 @@ FlowLayout::FlowLayout(int margin, int hSpacing, int vSpacing)
 }
 
 FlowLayout::~FlowLayout() {
-  QLayoutItem *item;
-  while ((item = takeAt(0)))
-    delete item;
+  qDeleteAll(itemList);
+  itemList.clear();
+}
+
+void FlowLayout::addItem(QLayoutItem *item) {
+  itemList.append(item);
+  m_geometries.append(QRect());
+  invalidate();
+}
+
+void FlowLayout::addPlaceholder(const QSize &size) {
+  addItem(new FlowPlaceholder(size));
 }
 
-void FlowLayout::addItem(QLayoutItem *item) { itemList.append(item); }
+void FlowLayout::setWidgetFactory(std::function<QWidget *(int)> factory) {
+  m_factory = std::move(factory);
+  scheduleMaterialize();
+}
+
+void FlowLayout::setWidgetReleaser(std::function<void(int)> releaser) {
+  m_releaser = std::move(releaser);
+}
+
+void FlowLayout::setVisibleRect(const QRect &rect) {
+  if (rect == m_visibleRect)
+    return;
+  m_visibleRect = rect;
+  scheduleMaterialize();
+}
+
+void FlowLayout::setItemHidden(int index, bool hidden) {
+  QLayoutItem *item = itemList.value(index);
+  if (!item)
+    return;
+  if (QWidget *widget = item->widget()) {
+    widget->setHidden(hidden); // Invalidates the layout by itself
+    return;
+  }
+  auto *placeholder = dynamic_cast<FlowPlaceholder *>(item);
+  if (placeholder && placeholder->hidden != hidden) {
+    placeholder->hidden = hidden;
+    invalidate();
+  }
+}
+
+void FlowLayout::invalidate() {
+  m_cacheValid = false;
+  m_cachedWidth = -1;
+  QLayout::invalidate();
+}
 
 int FlowLayout::horizontalSpacing() const {
   if (m_hSpace >= 0) {
@@ -42,9 +96,13 @@ QLayoutItem *FlowLayout::itemAt(int index) const {
 }
 
 QLayoutItem *FlowLayout::takeAt(int index) {
-  if (index >= 0 && index < itemList.size())
-    return itemList.takeAt(index);
-  else
+  if (index >= 0 && index < itemList.size()) {
+    m_geometries.removeAt(index);
+    QLayoutItem *item = itemList.takeAt(index);
+    m_materialized.remove(item->widget());
+    invalidate();
+    return item;
+  } else
     return nullptr;
 }
 
@@ -53,8 +111,12 @@ Qt::Orientations FlowLayout::expandingDirections() const { return {}; }
 bool FlowLayout::hasHeightForWidth() const { return true; }
 
 int FlowLayout::heightForWidth(int width) const {
-  int height = doLayout(QRect(0, 0, width, 0), true);
-  return height;
+  // Asked repeatedly for the same width while the window is resized
+  if (width != m_cachedWidth) {
+    m_cachedHeight = doLayout(QRect(0, 0, width, 0), true);
+    m_cachedWidth = width;
+  }
+  return m_cachedHeight;
 }
 
 void FlowLayout::setGeometry(const QRect &rect) {
@@ -65,10 +127,8 @@ void FlowLayout::setGeometry(const QRect &rect) {
 QSize FlowLayout::sizeHint() const { return minimumSize(); }
 
 QSize FlowLayout::minimumSize() const {
-  QSize size;
-  QLayoutItem *item;
-  for (const auto item : itemList)
-    size = size.expandedTo(item->minimumSize());
+  ensureCache();
+  QSize size = m_minimumSize;
 
   const QMargins margins = contentsMargins();
   size +=
@@ -76,51 +136,143 @@ QSize FlowLayout::minimumSize() const {
   return size;
 }
 
+void FlowLayout::ensureCache() const {
+  if (m_cacheValid)
+    return;
+
+  m_cache.resize(itemList.size());
+  m_minimumSize = QSize();
+  QWidget *styleWidget = nullptr;
+  for (int i = 0; i < itemList.size(); ++i) {
+    QLayoutItem *item = itemList[i];
+    QWidget *wid = item->widget();
+    auto *placeholder = wid ? nullptr : dynamic_cast<FlowPlaceholder *>(item);
+    // Skip hidden items to allow filtering logic to work visually
+    m_cache[i].skip =
+        wid ? wid->isHidden() : (placeholder && placeholder->hidden);
+    m_cache[i].size = item->sizeHint();
+    m_minimumSize = m_minimumSize.expandedTo(item->minimumSize());
+    if (wid && !styleWidget)
+      styleWidget = wid;
+  }
+
+  // Every item shares the style, so spacing is resolved once per pass
+  m_spaceX = horizontalSpacing();
+  if (m_spaceX == -1)
+    m_spaceX = styleWidget ? styleWidget->style()->layoutSpacing(
+                                 QSizePolicy::PushButton,
+                                 QSizePolicy::PushButton, Qt::Horizontal)
+                           : 10;
+  m_spaceY = verticalSpacing();
+  if (m_spaceY == -1)
+    m_spaceY = styleWidget ? styleWidget->style()->layoutSpacing(
+                                 QSizePolicy::PushButton,
+                                 QSizePolicy::PushButton, Qt::Vertical)
+                           : 10;
+  m_cacheValid = true;
+}
+
 int FlowLayout::doLayout(const QRect &rect, bool testOnly) const {
+  ensureCache();
   int left, top, right, bottom;
   getContentsMargins(&left, &top, &right, &bottom);
   QRect effectiveRect = rect.adjusted(+left, +top, -right, -bottom);
   int x = effectiveRect.x();
   int y = effectiveRect.y();
   int lineHeight = 0;
+  bool placeholderPlaced = false;
 
-  for (QLayoutItem *item : itemList) {
-    QWidget *wid = item->widget();
-    if (wid && !wid->isVisible()) {
-      // Skip invisible items to allow filtering logic to work visually
+  for (int i = 0; i < itemList.size(); ++i) {
+    const CachedItem &cached = m_cache[i];
+    if (cached.skip)
       continue;
-    }
 
-    int spaceX = horizontalSpacing();
-    if (spaceX == -1)
-      spaceX = wid ? wid->style()->layoutSpacing(QSizePolicy::PushButton,
-                                                 QSizePolicy::PushButton,
-                                                 Qt::Horizontal)
-                   : 10;
-    int spaceY = verticalSpacing();
-    if (spaceY == -1)
-      spaceY = wid ? wid->style()->layoutSpacing(QSizePolicy::PushButton,
-                                                 QSizePolicy::PushButton,
-                                                 Qt::Vertical)
-                   : 10;
-
-    int nextX = x + item->sizeHint().width() + spaceX;
-    if (nextX - spaceX > effectiveRect.right() && lineHeight > 0) {
+    int nextX = x + cached.size.width() + m_spaceX;
+    if (nextX - m_spaceX > effectiveRect.right() && lineHeight > 0) {
       x = effectiveRect.x();
-      y = y + lineHeight + spaceY;
-      nextX = x + item->sizeHint().width() + spaceX;
+      y = y + lineHeight + m_spaceY;
+      nextX = x + cached.size.width() + m_spaceX;
       lineHeight = 0;
     }
 
-    if (!testOnly)
-      item->setGeometry(QRect(QPoint(x, y), item->sizeHint()));
+    if (!testOnly) {
+      const QRect geometry(QPoint(x, y), cached.size);
+      if (geometry != m_geometries[i]) {
+        itemList[i]->setGeometry(geometry);
+        m_geometries[i] = geometry;
+      }
+      placeholderPlaced = placeholderPlaced || !itemList[i]->widget();
+    }
 
     x = nextX;
-    lineHeight = qMax(lineHeight, item->sizeHint().height());
+    lineHeight = qMax(lineHeight, cached.size.height());
   }
+  if (placeholderPlaced)
+    scheduleMaterialize();
   return y + lineHeight - rect.y() + bottom;
 }
 
+void FlowLayout::scheduleMaterialize() const {
+  if (!m_factory || m_materializeQueued)
+    return;
+  // Widgets are created outside of setGeometry, which must not add items
+  m_materializeQueued = true;
+  FlowLayout *self = const_cast<FlowLayout *>(this);
+  QMetaObject::invokeMethod(
+      self, [self]() { self->materializeVisible(); }, Qt::QueuedConnection);
+}
+
+void FlowLayout::materializeVisible() {
+  m_materializeQueued = false;
+  if (!m_factory || m_visibleRect.isEmpty())
+    return;
+
+  // Half a screen of slack above and below, so scrolling finds cards ready;
+  // widgets go only two screens away, so scrolling back and forth does not
+  // rebuild them
+  const int slack = m_visibleRect.height() / 2;
+  const QRect area = m_visibleRect.adjusted(0, -slack, 0, slack);
+  const int keep = m_visibleRect.height() * 2;
+  const QRect kept = m_visibleRect.adjusted(0, -keep, 0, keep);
+  bool changed = false;
+  for (int i = 0; i < itemList.size(); ++i) {
+    QWidget *made = itemList[i]->widget();
+    if (made && m_materialized.contains(made)) {
+      if (m_geometries[i].isNull() || m_geometries[i].intersects(kept))
+        continue;
+      if (m_releaser)
+        m_releaser(i);
+      auto *slot = new FlowPlaceholder(m_geometries[i].size());
+      slot->hidden = made->isHidden();
+      delete itemList[i];
+      itemList[i] = slot;
+      m_materialized.remove(made);
+      // Later, as the card may be running one of its own slots
+      made->hide();
+      made->deleteLater();
+      changed = true;
+      continue;
+    }
+
+    auto *placeholder = dynamic_cast<FlowPlaceholder *>(itemList[i]);
+    if (!placeholder || placeholder->hidden || m_geometries[i].isNull() ||
+        !m_geometries[i].intersects(area))
+      continue;
+    QWidget *widget = m_factory(i);
+    if (!widget)
+      continue;
+    addChildWidget(widget);
+    widget->setGeometry(m_geometries[i]);
+    widget->show();
+    itemList[i] = new QWidgetItem(widget);
+    m_materialized.insert(widget);
+    delete placeholder;
+    changed = true;
+  }
+  if (changed)
+    invalidate();
+}
+
 int FlowLayout::smartSpacing(QStyle::PixelMetric pm) const {
   QObject *parent = this->parent();
   if (!parent) {
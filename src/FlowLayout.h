@@ -3,7 +3,9 @@
 
 #include <QLayout>
 #include <QRect>
+#include <QSet>
 #include <QStyle>
+#include <functional>
 
 class FlowLayout : public QLayout {
 public:
@@ -24,14 +26,57 @@ public:
   void setGeometry(const QRect &rect) override;
   QSize sizeHint() const override;
   QLayoutItem *takeAt(int index) override;
+  void invalidate() override;
+
+  // Virtualized items: a fixed-size slot whose widget is only created, by
+  // the factory, once the slot comes near the visible rect. The factory
+  // returns the widget for an item index (or nullptr) and must not add it
+  // to the layout itself. Once the slot is far out of view again the
+  // releaser is told, the widget is deleted and the slot is a placeholder
+  // until it comes back.
+  void addPlaceholder(const QSize &size);
+  void setWidgetFactory(std::function<QWidget *(int index)> factory);
+  void setWidgetReleaser(std::function<void(int index)> releaser);
+  // Part of the parent widget on screen, e.g. a scroll area's viewport
+  void setVisibleRect(const QRect &rect);
+
+  // Hides a widget or placeholder item from the flow (filtering)
+  void setItemHidden(int index, bool hidden);
 
 private:
+  // Size hints and spacing are cached until the layout is invalidated;
+  // doLayout runs on every resize and used to query them per item
+  struct CachedItem {
+    QSize size;
+    bool skip;
+  };
+
   int doLayout(const QRect &rect, bool testOnly) const;
   int smartSpacing(QStyle::PixelMetric pm) const;
+  void ensureCache() const;
+  void scheduleMaterialize() const;
+  void materializeVisible();
 
   QList<QLayoutItem *> itemList;
   int m_hSpace;
   int m_vSpace;
+
+  mutable QList<CachedItem> m_cache;
+  mutable bool m_cacheValid = false;
+  mutable int m_spaceX = 0;
+  mutable int m_spaceY = 0;
+  mutable QSize m_minimumSize;
+  mutable int m_cachedWidth = -1; // Last heightForWidth query and answer
+  mutable int m_cachedHeight = -1;
+
+  // Last geometry given to each item, so unchanged items are not moved
+  mutable QList<QRect> m_geometries;
+
+  std::function<QWidget *(int)> m_factory;
+  std::function<void(int)> m_releaser;
+  QSet<QWidget *> m_materialized; // Widgets the factory made
+  QRect m_visibleRect;
+  mutable bool m_materializeQueued = false;
 };
 
 #endif // FLOWLAYOUT_H
@@ -0,0 +1,363 @@
+/*
+ * Copyright 2025 Kadir Mert Abatay
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "HealthChecker.h"
+#include <QTcpSocket>
+
+// Bodies larger than this are not drained; the connection is dropped instead
+static const qint64 kMaxDrainBytes = 1024 * 1024;
+
+HealthChecker::HealthChecker(QObject *parent) : QObject(parent) {
+  qRegisterMetaType<HealthResult>();
+  m_clock.start();
+
+  m_tick = new QTimer(this);
+  m_tick->setInterval(250);
+  connect(m_tick, &QTimer::timeout, this, &HealthChecker::tick);
+}
+
+HealthChecker::~HealthChecker() {
+  for (auto it = m_checks.begin(); it != m_checks.end(); ++it)
+    closeSocket(it.value());
+}
+
+void HealthChecker::setCheck(const HealthCheck &check) {
+  State &state = m_checks[check.port];
+  const bool changed = state.check.host != check.host ||
+                       state.check.path != check.path ||
+                       state.check.expectedStatus != check.expectedStatus;
+  state.check = check;
+  if (changed) {
+    // New target: start over on a fresh connection, right away
+    closeSocket(state);
+    m_queue.removeAll(check.port);
+    state.phase = Idle;
+    state.nextDueMs = 0;
+  }
+  if (!m_tick->isActive())
+    m_tick->start();
+}
+
+void HealthChecker::removeCheck(int port) {
+  auto it = m_checks.find(port);
+  if (it == m_checks.end())
+    return;
+  closeSocket(it.value());
+  m_queue.removeAll(port);
+  m_checks.erase(it);
+  if (m_checks.isEmpty())
+    m_tick->stop();
+}
+
+int HealthChecker::running() const {
+  int count = 0;
+  for (const State &state : m_checks) {
+    if (state.phase == Connecting || state.phase == AwaitingResponse)
+      count++;
+  }
+  return count;
+}
+
+void HealthChecker::tick() {
+  const qint64 nowMs = m_clock.elapsed();
+  const qint64 nowNs = m_clock.nsecsElapsed();
+
+  QList<int> timedOut;
+  for (auto it = m_checks.begin(); it != m_checks.end(); ++it) {
+    State &state = it.value();
+    if ((state.phase == Connecting || state.phase == AwaitingResponse) &&
+        nowNs - state.startedNs > qint64(m_timeoutMs) * 1000000) {
+      timedOut.append(it.key());
+    } else if ((state.phase == Idle || state.phase == Draining) &&
+               state.nextDueMs <= nowMs) {
+      state.phase = Queued;
+      m_queue.append(it.key());
+    }
+  }
+
+  // Results are emitted outside the loop; a slot may remove checks
+  for (int port : timedOut) {
+    auto it = m_checks.find(port);
+    if (it == m_checks.end())
+      continue;
+    closeSocket(it.value());
+    complete(it.value(), Idle, "Timed out");
+  }
+
+  int slots = m_maxConcurrent - running();
+  while (slots > 0 && !m_queue.isEmpty()) {
+    start(m_queue.takeFirst());
+    slots--;
+  }
+}
+
+void HealthChecker::start(int port) {
+  auto it = m_checks.find(port);
+  if (it == m_checks.end())
+    return;
+  State &state = it.value();
+
+  state.result = HealthResult();
+  state.result.port = port;
+  state.retried = false;
+  state.startedNs = m_clock.nsecsElapsed();
+
+  // A connection still draining the previous body cannot carry a request
+  if (state.reusable && state.socket &&
+      state.socket->state() == QAbstractSocket::ConnectedState) {
+    state.result.reused = true;
+    sendRequest(state);
+    return;
+  }
+
+  closeSocket(state);
+  state.socket = new QTcpSocket(this);
+  connect(state.socket, &QTcpSocket::connected, this,
+          [this, port]() { onConnected(port); });
+  connect(state.socket, &QTcpSocket::readyRead, this,
+          [this, port]() { onReadyRead(port); });
+  connect(state.socket, &QTcpSocket::errorOccurred, this,
+          [this, port](QAbstractSocket::SocketError) { onSocketError(port); });
+  state.phase = Connecting;
+  state.socket->connectToHost(state.check.host, quint16(port));
+}
+
+void HealthChecker::onConnected(int port) {
+  auto it = m_checks.find(port);
+  if (it == m_checks.end() || it->phase != Connecting)
+    return;
+  it->result.connectMs = (m_clock.nsecsElapsed() - it->startedNs) / 1.0e6;
+  sendRequest(it.value());
+}
+
+void HealthChecker::sendRequest(State &state) {
+  QString host = state.check.host.contains(':')
+                     ? QString("[%1]").arg(state.check.host)
+                     : state.check.host;
+  QByteArray request = "GET " + state.check.path.toUtf8() +
+                       " HTTP/1.1\r\nHost: " + host.toUtf8() + ':' +
+                       QByteArray::number(state.check.port) +
+                       "\r\nUser-Agent: PortMonitor\r\nAccept: */*\r\n"
+                       "Connection: keep-alive\r\n\r\n";
+  state.buffer.clear();
+  state.bodyRemaining = -1;
+  state.chunked = false;
+  state.keepAlive = true;
+  state.reusable = false;
+  state.phase = AwaitingResponse;
+  state.requestSentNs = m_clock.nsecsElapsed();
+  state.socket->write(request);
+}
+
+void HealthChecker::onReadyRead(int port) {
+  auto it = m_checks.find(port);
+  if (it == m_checks.end())
+    return;
+  State &state = it.value();
+
+  if (state.phase != AwaitingResponse && state.phase != Draining) {
+    // Unsolicited bytes on an idle connection: it is no longer usable
+    closeSocket(state);
+    return;
+  }
+
+  if (state.phase == AwaitingResponse && state.buffer.isEmpty()) {
+    state.result.ttfbMs =
+        (m_clock.nsecsElapsed() - state.requestSentNs) / 1.0e6;
+  }
+  state.buffer.append(state.socket->readAll());
+
+  if (state.phase == Draining) {
+    if (drainBody(state)) {
+      state.phase = Idle;
+      state.reusable = (state.socket != nullptr);
+    }
+    return;
+  }
+
+  int headerEnd = state.buffer.indexOf("\r\n\r\n");
+  if (headerEnd < 0) {
+    if (state.buffer.size() > 64 * 1024) {
+      closeSocket(state);
+      complete(state, Idle, "Malformed response");
+    }
+    return;
+  }
+  parseHeader(state, headerEnd);
+  if (state.result.status < 0) {
+    closeSocket(state);
+    complete(state, Idle, "Malformed response");
+    return;
+  }
+
+  // The check is done once the status is known; the body is only read so
+  // the connection can carry the next request
+  Phase next = Idle;
+  if (!state.keepAlive)
+    closeSocket(state);
+  else if (drainBody(state))
+    state.reusable = (state.socket != nullptr);
+  else if (state.socket)
+    next = Draining;
+  complete(state, next);
+}
+
+void HealthChecker::parseHeader(State &state, int headerEnd) {
+  const QList<QByteArray> lines = state.buffer.left(headerEnd).split('\n');
+  state.buffer.remove(0, headerEnd + 4);
+
+  // "HTTP/1.1 200 OK"
+  const QList<QByteArray> statusLine = lines.value(0).trimmed().split(' ');
+  if (statusLine.size() < 2 || !statusLine[0].startsWith("HTTP/"))
+    return;
+  bool ok = false;
+  int status = statusLine[1].toInt(&ok);
+  if (!ok)
+    return;
+  state.result.status = status;
+
+  // HTTP/1.0 closes unless asked otherwise
+  state.keepAlive = (statusLine[0] != "HTTP/1.0");
+  bool hasLength = false;
+  for (int i = 1; i < lines.size(); ++i) {
+    const QByteArray line = lines[i].trimmed();
+    int colon = line.indexOf(':');
+    if (colon <= 0)
+      continue;
+    const QByteArray name = line.left(colon).trimmed().toLower();
+    const QByteArray value = line.mid(colon + 1).trimmed().toLower();
+    if (name == "content-length") {
+      state.bodyRemaining = value.toLongLong(&hasLength);
+    } else if (name == "transfer-encoding") {
+      state.chunked = value.contains("chunked");
+    } else if (name == "connection") {
+      if (value.contains("close"))
+        state.keepAlive = false;
+      else if (value.contains("keep-alive"))
+        state.keepAlive = true;
+    }
+  }
+
+  const bool noBody = (status / 100 == 1 || status == 204 || status == 304);
+  if (noBody) {
+    state.bodyRemaining = 0;
+    state.chunked = false;
+  } else if (!state.chunked && !hasLength) {
+    state.keepAlive = false; // Body runs until close
+  } else if (state.bodyRemaining > kMaxDrainBytes) {
+    state.keepAlive = false;
+  }
+}
+
+bool HealthChecker::drainBody(State &state) {
+  if (!state.chunked) {
+    qint64 take = qMin<qint64>(state.bodyRemaining, state.buffer.size());
+    state.buffer.remove(0, int(take));
+    state.bodyRemaining -= take;
+    return state.bodyRemaining == 0;
+  }
+
+  // Chunked: "<hex size>\r\n<data>\r\n" ... "0\r\n\r\n"
+  qint64 drained = 0;
+  while (true) {
+    if (state.bodyRemaining > 0) {
+      qint64 take = qMin<qint64>(state.bodyRemaining, state.buffer.size());
+      state.buffer.remove(0, int(take));
+      state.bodyRemaining -= take;
+      drained += take;
+      if (state.bodyRemaining > 0)
+        return false;
+      state.bodyRemaining = -2; // Expect the chunk's trailing CRLF
+    }
+    if (state.bodyRemaining == -2) {
+      if (state.buffer.size() < 2)
+        return false;
+      state.buffer.remove(0, 2);
+      state.bodyRemaining = -1;
+    }
+    int lineEnd = state.buffer.indexOf("\r\n");
+    if (lineEnd < 0)
+      return false;
+    bool ok = false;
+    qint64 size = state.buffer.left(lineEnd).split(';').value(0).trimmed()
+                      .toLongLong(&ok, 16);
+    state.buffer.remove(0, lineEnd + 2);
+    if (!ok || drained + size > kMaxDrainBytes) {
+      closeSocket(state);
+      return false;
+    }
+    if (size == 0) {
+      // Last chunk; no trailers expected from a dev server
+      if (state.buffer.startsWith("\r\n"))
+        state.buffer.remove(0, 2);
+      state.buffer.clear();
+      state.bodyRemaining = -1;
+      state.chunked = false;
+      return true;
+    }
+    state.bodyRemaining = size;
+  }
+}
+
+void HealthChecker::onSocketError(int port) {
+  auto it = m_checks.find(port);
+  if (it == m_checks.end())
+    return;
+  State &state = it.value();
+  const QString error = state.socket ? state.socket->errorString() : QString();
+
+  if (state.phase == AwaitingResponse && state.result.reused &&
+      state.buffer.isEmpty() && !state.retried) {
+    // The server dropped the idle connection as we reused it; retry once on
+    // a fresh one
+    closeSocket(state);
+    start(port);
+    state.retried = true;
+    return;
+  }
+
+  closeSocket(state);
+  if (state.phase == Connecting || state.phase == AwaitingResponse)
+    complete(state, Idle, error);
+  else if (state.phase == Draining)
+    state.phase = Idle; // Read-until-close body, or the server hung up
+}
+
+void HealthChecker::complete(State &state, Phase next,
+                             const QString &error) {
+  HealthResult &result = state.result;
+  result.error = error;
+  if (error.isEmpty()) {
+    result.healthy = (state.check.expectedStatus == 0)
+                         ? (result.status > 0 && result.status < 400)
+                         : (result.status == state.check.expectedStatus);
+  }
+  state.phase = next;
+  state.nextDueMs = m_clock.elapsed() + m_intervalMs;
+  const HealthResult copy = result;
+  emit resultReady(copy);
+}
+
+void HealthChecker::closeSocket(State &state) {
+  if (!state.socket)
+    return;
+  state.socket->disconnect(this);
+  state.socket->abort();
+  state.socket->deleteLater();
+  state.socket = nullptr;
+  state.buffer.clear();
+  state.reusable = false;
+}
@@ -0,0 +1,112 @@
+/*
+ * Copyright 2025 Kadir Mert Abatay
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QMetaType>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+
+class QTcpSocket;
+
+struct HealthCheck {
+  QString host;
+  int port = 0;
+  QString path = "/";
+  int expectedStatus = 200; // 0 accepts any status below 400
+};
+
+struct HealthResult {
+  int port = 0;
+  bool healthy = false;
+  int status = -1; // HTTP status, -1 when no response arrived
+  double connectMs = -1; // -1 when an open connection was reused
+  double ttfbMs = -1; // Request written to first response byte
+  bool reused = false;
+  QString error;
+};
+
+Q_DECLARE_METATYPE(HealthResult)
+
+// Periodic HTTP GET checks, one per port. Each check keeps its connection
+// open between runs (HTTP/1.1 keep-alive) so steady-state checks cost one
+// request, not a handshake. At most maxConcurrent() checks run at once;
+// the rest wait their turn.
+class HealthChecker : public QObject {
+  Q_OBJECT
+
+public:
+  explicit HealthChecker(QObject *parent = nullptr);
+  ~HealthChecker();
+
+  void setCheck(const HealthCheck &check);
+  void removeCheck(int port);
+  bool hasCheck(int port) const { return m_checks.contains(port); }
+
+  void setInterval(int ms) { m_intervalMs = ms; }
+  void setTimeout(int ms) { m_timeoutMs = ms; }
+  void setMaxConcurrent(int count) { m_maxConcurrent = qMax(1, count); }
+  int maxConcurrent() const { return m_maxConcurrent; }
+
+signals:
+  void resultReady(const HealthResult &result);
+
+private:
+  enum Phase { Idle, Queued, Connecting, AwaitingResponse, Draining };
+
+  struct State {
+    HealthCheck check;
+    QTcpSocket *socket = nullptr;
+    Phase phase = Idle;
+    qint64 nextDueMs = 0;
+    qint64 startedNs = 0;
+    qint64 requestSentNs = 0;
+    bool retried = false;
+    HealthResult result;
+    QByteArray buffer;
+    // Body framing of the response being drained
+    qint64 bodyRemaining = -1; // Content-Length left, -1 if not used
+    bool chunked = false;
+    bool keepAlive = true;
+    bool reusable = false; // Open, and the last response fully read
+  };
+
+  void tick();
+  void start(int port);
+  void sendRequest(State &state);
+  void onConnected(int port);
+  void onReadyRead(int port);
+  void onSocketError(int port);
+  void parseHeader(State &state, int headerEnd);
+  bool drainBody(State &state);
+  // Emits the result; `state` must not be used afterwards
+  void complete(State &state, Phase next, const QString &error = QString());
+  void closeSocket(State &state);
+  int running() const;
+
+  QHash<int, State> m_checks;
+  QList<int> m_queue;
+  QTimer *m_tick;
+  QElapsedTimer m_clock;
+  int m_intervalMs = 5000;
+  int m_timeoutMs = 5000;
+  int m_maxConcurrent = 4;
+};
@@ -15,23 +15,31 @@
  */
 
 #include "MainWindow.h"
+#include "PortItemDelegate.h"
 #include "PortSnifferWidget.h"
 #include "ProcessDetailsDialog.h"
+#include "ProcessInfoCache.h"
+#include "SnapshotStore.h"
+#include "StageProfiler.h"
 #include <QApplication>
 #include <QClipboard>
 #include <QCloseEvent>
 #include <QDesktopServices>
 #include <QDir>
+#include <QElapsedTimer>
+#include <QFileDialog>
 #include <QFrame>
 #include <QGridLayout>
 #include <QHBoxLayout>
 #include <QHeaderView>
 #include <QIcon>
 #include <QLabel>
+#include <QLocale>
 #include <QMenu>
 #include <QMessageBox>
 #include <QPainter>
 #include <QScrollArea>
+#include <QScrollBar>
 #include <QSettings>
 #include <QSortFilterProxyModel>
 #include <QStatusBar>
@@ -43,15 +51,84 @@
 
 MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent) {
   loadCustomPorts();
+  loadHealthChecks();
+  loadLatencyProbes();
   setWindowIcon(QIcon(":/icon.png"));
+  // Created before the dashboard and settings tab, which use them
+  m_resourceSampler = new ResourceSampler(this);
+  m_probeEngine = new ProbeEngine(this);
+  connect(m_probeEngine, &ProbeEngine::statsUpdated, this,
+          &MainWindow::onProbeStats);
+  m_healthChecker = new HealthChecker(this);
+  connect(m_healthChecker, &HealthChecker::resultReady, this,
+          &MainWindow::onHealthResult);
+  m_snapshotServer = new SnapshotServer(this);
+  m_metricsExporter = new MetricsExporter(this);
+  m_alertEngine = new AlertEngine(this);
+  connect(m_alertEngine, &AlertEngine::alertRaised, this, &MainWindow::onAlert);
+  connect(m_alertEngine, &AlertEngine::alertResolved, this,
+          &MainWindow::onAlert);
+  // Agents can report many times a second between them; the table follows
+  // at most four times a second
+  m_agentCollector = new AgentCollector(this);
+  m_agentUpdateTimer = new QTimer(this);
+  m_agentUpdateTimer->setSingleShot(true);
+  m_agentUpdateTimer->setInterval(250);
+  connect(m_agentUpdateTimer, &QTimer::timeout, this, &MainWindow::showPorts);
+  connect(m_agentCollector, &AgentCollector::hostUpdated, m_agentUpdateTimer,
+          qOverload<>(&QTimer::start));
+  connect(m_agentCollector, &AgentCollector::hostUpdated, m_alertEngine,
+          [this](const QString &, const SnapshotDelta &delta) {
+            m_alertEngine->apply(delta);
+          });
+  connect(m_agentCollector, &AgentCollector::hostConnected, this,
+          [this](const QString &host) {
+            statusBar()->showMessage("Agent connected: " + host, 3000);
+          });
+  connect(m_agentCollector, &AgentCollector::hostDisconnected, this,
+          [this](const QString &host, const QString &reason) {
+            m_alertEngine->forgetHost(host);
+            statusBar()->showMessage(
+                QString("Agent %1 disconnected: %2").arg(host, reason), 5000);
+          });
+  loadSettings();
   setupUi();
 
   m_model = new PortTableModel(this);
+  m_model->setResourceSampler(m_resourceSampler);
   m_portTable->setModel(m_model);
+  // Shown once agents report (see showPorts)
+  m_portTable->setColumnHidden(PortTableModel::Host, true);
+
+  // Resource metrics follow the rows on screen; scrolling and model resets
+  // are coalesced into one update of the watched PIDs
+  m_watchedPidsTimer = new QTimer(this);
+  m_watchedPidsTimer->setSingleShot(true);
+  m_watchedPidsTimer->setInterval(100);
+  connect(m_watchedPidsTimer, &QTimer::timeout, this,
+          &MainWindow::updateWatchedPids);
+  connect(m_portTable->verticalScrollBar(), &QScrollBar::valueChanged,
+          m_watchedPidsTimer, qOverload<>(&QTimer::start));
+  connect(m_model, &QAbstractItemModel::modelReset, m_watchedPidsTimer,
+          qOverload<>(&QTimer::start));
+  connect(m_model, &QAbstractItemModel::layoutChanged, m_watchedPidsTimer,
+          qOverload<>(&QTimer::start));
+
+  // Group header rows span the whole table
+  connect(m_model, &QAbstractItemModel::modelReset, this,
+          &MainWindow::applyGroupSpans);
+  connect(m_model, &QAbstractItemModel::layoutChanged, this,
+          &MainWindow::applyGroupSpans);
+  connect(m_groupByUnitCheck, &QCheckBox::toggled, m_model,
+          &PortTableModel::setGroupByUnit);
+  // No indicator until a header is clicked keeps the default priority order
+  m_portTable->horizontalHeader()->setSortIndicator(-1, Qt::AscendingOrder);
+  m_portTable->setSortingEnabled(true);
   connect(
       m_portTable, &QTableView::clicked, this,
       [this](const QModelIndex &index) {
-        if (index.column() == PortTableModel::Action) {
+        if (index.column() == PortTableModel::Action &&
+            !m_model->isRemoteRow(index.row())) {
           int port =
               m_model->data(m_model->index(index.row(), PortTableModel::Port))
                   .toInt();
@@ -68,36 +145,57 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent) {
   m_portMonitor = new PortMonitor(this);
   connect(m_portMonitor, &PortMonitor::portsUpdated, this,
           &MainWindow::onPortsUpdated);
-  connect(m_portMonitor, &PortMonitor::newPortDetected, this,
-          [this](const PortInfo &info) {
-            if (m_trayIcon && m_trayIcon->isVisible() && m_notificationsCheck &&
-                m_notificationsCheck->isChecked()) {
-              QString msg = QString("Process: %1\nPort: %2 (%3)")
-                                .arg(info.processName)
-                                .arg(info.port)
-                                .arg(info.protocol);
-              m_trayIcon->showMessage("New Listener Detected", msg,
-                                      QSystemTrayIcon::Information, 3000);
-            }
-            // Log to activity tab
-            addLogEntry("New Port", info);
-          });
-
+  connect(m_portMonitor, &PortMonitor::errorOccurred, m_metricsExporter,
+          &MetricsExporter::recordScanError);
   connect(m_portMonitor, &PortMonitor::portClosed, this,
           [this](const PortInfo &info) { addLogEntry("Port Closed", info); });
+  connect(m_portMonitor, &PortMonitor::processKilled, this,
+          &MainWindow::onProcessKilled);
+  connect(m_portMonitor, &PortMonitor::namespaceScanFinished, this,
+          [this](int namespaces, qint64 elapsedMs) {
+            m_namespaceSummary =
+                namespaces > 0
+                    ? QString(" · %1 namespaces scanned in %2 ms")
+                          .arg(namespaces)
+                          .arg(elapsedMs)
+                    : QString();
+          });
 
+  // Object names here and on the widgets below let bench/GuiHarness.cpp
+  // find them
   m_refreshTimer = new QTimer(this);
+  m_refreshTimer->setObjectName("refreshTimer");
   connect(m_refreshTimer, &QTimer::timeout, this,
           &MainWindow::onRefreshClicked);
   m_refreshTimer->start(5000);
 
   createTrayIcon();
 
-  onRefreshClicked();
+  // Show what the last session saw right away; the first scan runs once the
+  // event loop is up and replaces it
+  showSnapshot();
+  QTimer::singleShot(0, this, &MainWindow::onRefreshClicked);
+  connect(qApp, &QCoreApplication::aboutToQuit, this,
+          &MainWindow::saveSnapshot);
 }
 
 MainWindow::~MainWindow() {}
 
+void MainWindow::enableStartupTiming(const QElapsedTimer &clock) {
+  m_startupClock = clock;
+}
+
+bool MainWindow::event(QEvent *event) {
+  const bool handled = QMainWindow::event(event);
+  // The top-level UpdateRequest is where the window's widgets get painted
+  if (event->type() == QEvent::UpdateRequest && m_startupClock.isValid() &&
+      !m_firstPaintReported) {
+    m_firstPaintReported = true;
+    qInfo("startup: first paint after %lld ms", m_startupClock.elapsed());
+  }
+  return handled;
+}
+
 void MainWindow::closeEvent(QCloseEvent *event) {
   if (m_trayIcon->isVisible()) {
     QMessageBox::information(this, "Port Monitor",
@@ -109,12 +207,45 @@ void MainWindow::closeEvent(QCloseEvent *event) {
   }
 }
 
+// Filled circle used for online ports in the tray menu; 32x32 for Retina
+static QIcon trayStatusIcon(const QColor &color) {
+  QPixmap pixmap(32, 32);
+  pixmap.fill(Qt::transparent);
+  QPainter painter(&pixmap);
+  painter.setRenderHint(QPainter::Antialiasing);
+  painter.setBrush(color);
+  painter.setPen(Qt::NoPen);
+  painter.drawEllipse(4, 4, 24, 24);
+  painter.end();
+  return QIcon(pixmap);
+}
+
 void MainWindow::createTrayIcon() {
+  // Drawn once; every port entry shares them
+  m_trayOnlineIcon = trayStatusIcon(QColor("#2ecc71"));
+  m_trayUnhealthyIcon = trayStatusIcon(QColor("#f39c12"));
+
+  // Fixed skeleton; port entries are inserted before the separator
   m_trayMenu = new QMenu(this);
-  QAction *restoreAction =
-      m_trayMenu->addAction("Restore", this, &QWidget::showNormal);
-  QAction *quitAction =
-      m_trayMenu->addAction("Quit", qApp, &QApplication::quit);
+  m_trayMenu->setObjectName("trayMenu");
+  QAction *headerAction = m_trayMenu->addAction("ACTIVE PORTS");
+  headerAction->setEnabled(
+      false); // Functions as a visual header in native menus
+  m_trayEmptyAction = m_trayMenu->addAction("No active developer ports");
+  m_trayEmptyAction->setEnabled(false);
+  m_traySeparator = m_trayMenu->addSeparator();
+  m_trayMenu->addAction("Restore", this, &QWidget::showNormal);
+  m_trayMenu->addAction("Quit", qApp, &QApplication::quit);
+
+  // Changing a menu while it is open makes it flicker or close on some
+  // desktops; updates wait until it is dismissed
+  connect(m_trayMenu, &QMenu::aboutToShow, this,
+          [this]() { m_trayMenuOpen = true; });
+  connect(m_trayMenu, &QMenu::aboutToHide, this, [this]() {
+    m_trayMenuOpen = false;
+    if (m_trayMenuDirty)
+      QTimer::singleShot(0, this, &MainWindow::updateTrayMenu);
+  });
 
   m_trayIcon = new QSystemTrayIcon(this);
   m_trayIcon->setContextMenu(m_trayMenu);
@@ -173,14 +304,33 @@ void MainWindow::setupUi() {
                            "border-radius: 8px; padding: 10px; }");
   m_dashboardLayout = new FlowLayout(dashFrame);
   m_dashboardLayout->setSpacing(10);
+  m_dashboardLayout->setWidgetFactory(
+      [this](int index) { return createCard(index); });
+  m_dashboardLayout->setWidgetReleaser(
+      [this](int index) { releaseCard(index); });
+
+  // Scrolls once the cards need more than a few rows; the layout is told
+  // what is on screen so it only creates those cards
+  m_dashboardScroll = new QScrollArea(this);
+  m_dashboardScroll->setWidget(dashFrame);
+  m_dashboardScroll->setWidgetResizable(true);
+  m_dashboardScroll->setFrameShape(QFrame::NoFrame);
+  m_dashboardScroll->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+  m_dashboardScroll->setStyleSheet("QScrollArea { background: transparent; }");
+  m_dashboardScroll->viewport()->setAutoFillBackground(false);
+  m_dashboardScroll->viewport()->installEventFilter(this);
+  connect(m_dashboardScroll->verticalScrollBar(), &QScrollBar::valueChanged,
+          this, &MainWindow::updateDashboardViewport);
 
   setupDashboard();
-  monitorLayout->addWidget(dashFrame);
+  monitorLayout->addWidget(m_dashboardScroll);
 
   // --- Control Section ---
   QHBoxLayout *topLayout = new QHBoxLayout();
   m_searchBox = new QLineEdit(this);
-  m_searchBox->setPlaceholderText("Search processes or ports...");
+  m_searchBox->setObjectName("searchBox");
+  m_searchBox->setPlaceholderText(
+      "Search processes or ports... (unit:<name> filters by unit)");
   connect(m_searchBox, &QLineEdit::textChanged, this,
           &MainWindow::onFilterTextChanged);
 
@@ -189,7 +339,13 @@ void MainWindow::setupUi() {
   connect(m_refreshBtn, &QPushButton::clicked, this,
           &MainWindow::onRefreshClicked);
 
+  m_groupByUnitCheck = new QCheckBox("Group by unit", this);
+  m_groupByUnitCheck->setCursor(Qt::PointingHandCursor);
+  m_groupByUnitCheck->setToolTip(
+      "Group sockets by systemd unit or container, with per-unit totals");
+
   topLayout->addWidget(m_searchBox, 1);
+  topLayout->addWidget(m_groupByUnitCheck);
   topLayout->addWidget(m_refreshBtn);
   // Settings button removed as it is now a tab
 
@@ -197,12 +353,14 @@ void MainWindow::setupUi() {
 
   // --- Table Section ---
   m_portTable = new QTableView(this);
+  m_portTable->setObjectName("portTable");
   m_portTable->setAlternatingRowColors(true);
   m_portTable->horizontalHeader()->setStretchLastSection(true);
   m_portTable->verticalHeader()->setVisible(false);
   m_portTable->setShowGrid(false);
+  m_portTable->setItemDelegate(new PortItemDelegate(m_portTable));
   m_portTable->setSelectionBehavior(QAbstractItemView::SelectRows);
-  m_portTable->setSelectionMode(QAbstractItemView::SingleSelection);
+  m_portTable->setSelectionMode(QAbstractItemView::ExtendedSelection);
   m_portTable->setContextMenuPolicy(Qt::CustomContextMenu);
   connect(m_portTable, &QTableView::customContextMenuRequested, this,
           &MainWindow::onCustomContextMenuRequested);
@@ -267,15 +425,137 @@ void MainWindow::setupUi() {
   m_tabWidget->addTab(logTab, "Activity Log");
 
   // --- Tab 3: Detailed Monitor ---
-  PortSnifferWidget *snifferTab = new PortSnifferWidget(this);
-  m_tabWidget->addTab(snifferTab, "Deep Monitor");
+  addLazyTab("Deep Monitor", [this]() { return new PortSnifferWidget(this); });
 
   // --- Tab 4: Settings ---
-  setupSettingsTab(m_tabWidget);
+  addLazyTab("Settings", [this]() { return createSettingsTab(); });
+
+  // --- Tab 5: Diagnostics ---
+  addLazyTab("Diagnostics", [this]() { return createDiagnosticsTab(); });
+
+  connect(m_tabWidget, &QTabWidget::currentChanged, this,
+          &MainWindow::buildLazyTab);
 
   statusBar()->showMessage("System Ready");
 }
 
+void MainWindow::addLazyTab(const QString &title,
+                            std::function<QWidget *()> factory) {
+  QWidget *page = new QWidget();
+  QVBoxLayout *layout = new QVBoxLayout(page);
+  layout->setContentsMargins(0, 0, 0, 0);
+  m_tabWidget->addTab(page, title);
+  m_lazyTabs.insert(page, std::move(factory));
+}
+
+void MainWindow::buildLazyTab(int index) {
+  QWidget *page = m_tabWidget->widget(index);
+  const std::function<QWidget *()> factory = m_lazyTabs.take(page);
+  if (factory)
+    page->layout()->addWidget(factory());
+}
+
+QWidget *MainWindow::createDiagnosticsTab() {
+  QWidget *tab = new QWidget();
+  QVBoxLayout *layout = new QVBoxLayout(tab);
+  layout->setContentsMargins(15, 15, 15, 15);
+  layout->setSpacing(10);
+
+  QHBoxLayout *toolLayout = new QHBoxLayout();
+  QLabel *desc = new QLabel(
+      "Time spent in each stage of a refresh over the last runs. A trace "
+      "records every run and opens in chrome://tracing or Perfetto.");
+  desc->setWordWrap(true);
+  toolLayout->addWidget(desc, 1);
+
+  m_traceButton = new QPushButton(tab);
+  connect(m_traceButton, &QPushButton::clicked, this,
+          &MainWindow::toggleTrace);
+  toolLayout->addWidget(m_traceButton);
+
+  QPushButton *resetBtn = new QPushButton("Reset", tab);
+  connect(resetBtn, &QPushButton::clicked, this, [this]() {
+    StageProfiler::instance()->reset();
+    updateDiagnostics();
+  });
+  toolLayout->addWidget(resetBtn);
+  layout->addLayout(toolLayout);
+
+  m_diagnosticsTable = new QTableWidget(0, 7, tab);
+  m_diagnosticsTable->setHorizontalHeaderLabels(
+      {"Stage", "Runs", "Last (ms)", "p50 (ms)", "p95 (ms)", "p99 (ms)",
+       "Max (ms)"});
+  m_diagnosticsTable->horizontalHeader()->setSectionResizeMode(
+      QHeaderView::Stretch);
+  m_diagnosticsTable->verticalHeader()->setVisible(false);
+  m_diagnosticsTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+  m_diagnosticsTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+  m_diagnosticsTable->setAlternatingRowColors(true);
+  layout->addWidget(m_diagnosticsTable);
+
+  // Refreshed only while the tab is on screen
+  QTimer *timer = new QTimer(tab);
+  connect(timer, &QTimer::timeout, this, &MainWindow::updateDiagnostics);
+  timer->start(1000);
+  updateDiagnostics();
+  return tab;
+}
+
+void MainWindow::updateDiagnostics() {
+  StageProfiler *profiler = StageProfiler::instance();
+  m_traceButton->setText(
+      profiler->isTracing()
+          ? QString("Save Trace (%1 events)...").arg(profiler->traceEvents())
+          : QString("Record Trace"));
+  if (!m_diagnosticsTable->isVisible())
+    return;
+
+  const QList<StageStats> stats = profiler->stats();
+  m_diagnosticsTable->setRowCount(stats.size());
+  for (int row = 0; row < stats.size(); ++row) {
+    const StageStats &stage = stats[row];
+    const QStringList cells = {stage.stage,
+                               QString::number(stage.count),
+                               QString::number(stage.lastMs, 'f', 2),
+                               QString::number(stage.p50Ms, 'f', 2),
+                               QString::number(stage.p95Ms, 'f', 2),
+                               QString::number(stage.p99Ms, 'f', 2),
+                               QString::number(stage.maxMs, 'f', 2)};
+    for (int column = 0; column < cells.size(); ++column) {
+      QTableWidgetItem *item = m_diagnosticsTable->item(row, column);
+      if (!item) {
+        item = new QTableWidgetItem();
+        if (column > 0)
+          item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+        m_diagnosticsTable->setItem(row, column, item);
+      }
+      item->setText(cells[column]);
+    }
+  }
+}
+
+void MainWindow::toggleTrace() {
+  StageProfiler *profiler = StageProfiler::instance();
+  if (!profiler->isTracing()) {
+    profiler->startTrace();
+    statusBar()->showMessage("Recording a trace of every refresh stage", 3000);
+    updateDiagnostics();
+    return;
+  }
+
+  // Cancelling keeps the recording going
+  const QString path = QFileDialog::getSaveFileName(
+      this, "Save Trace", QDir::home().filePath("portmonitor-trace.json"),
+      "Chrome trace (*.json)");
+  if (path.isEmpty())
+    return;
+  if (profiler->stopTrace(path))
+    statusBar()->showMessage("Trace saved to " + path, 5000);
+  else
+    QMessageBox::warning(this, "Save Trace", "Could not write " + path);
+  updateDiagnostics();
+}
+
 void MainWindow::addLogEntry(const QString &event, const PortInfo &info) {
   int row = 0;
   m_logTable->insertRow(row);
@@ -301,6 +581,11 @@ void MainWindow::setupDashboard() {
     }
     delete child;
   }
+  for (const auto &tracked : m_trackedPorts) {
+    if (!tracked.probeKey.isEmpty())
+      m_probeEngine->unwatch(tracked.probeHost, tracked.port);
+    m_healthChecker->removeCheck(tracked.port);
+  }
   m_trackedPorts.clear();
 
   // 1. Default Ports
@@ -316,108 +601,25 @@ void MainWindow::setupDashboard() {
   // 2. Append Custom Ports
   defs.append(m_customPorts);
 
-  int col = 0;
-  int row = 0;
   QWidget *parentWidget = m_dashboardLayout->parentWidget();
   int defaultPortCount = defs.size() - m_customPorts.size();
 
+  // Only placeholders here; createCard builds a card's widgets once it
+  // comes into view, so hundreds of custom ports stay cheap
   for (int i = 0; i < defs.size(); ++i) {
     const auto &def = defs[i];
-    bool isCustom = (i >= defaultPortCount);
-
-    QWidget *container = new QWidget(parentWidget);
-    container->setProperty("class", "dashboardCard");
-    container->setFixedSize(160, 110);
-    QVBoxLayout *layout = new QVBoxLayout(container);
-    layout->setContentsMargins(10, 10, 10, 10);
-    layout->setSpacing(5);
-
-    QLabel *nameLabel =
-        new QLabel(QString("%1 (%2)").arg(def.name).arg(def.port), container);
-    nameLabel->setObjectName("dashPortName");
-    nameLabel->setWordWrap(true);
-
-    QLabel *statusLabel = new QLabel("OFFLINE", container);
-    statusLabel->setObjectName("dashStatusLabel");
-    statusLabel->setStyleSheet("color: #888888;");
-    statusLabel->setToolTip(def.desc);
-
-    QPushButton *openBtn = new QPushButton("Launch", container);
-    openBtn->setObjectName("dashOpenBtn");
-    openBtn->setCursor(Qt::PointingHandCursor);
-    openBtn->setVisible(false);
-    connect(openBtn, &QPushButton::clicked, this, [this, def]() {
-      QDesktopServices::openUrl(
-          QUrl(QString("http://localhost:%1").arg(def.port)));
-    });
-
-    // Add delete button for custom ports (positioned in top-right corner)
-    QPushButton *deleteBtn = nullptr;
-    if (isCustom) {
-      deleteBtn = new QPushButton(container);
-      deleteBtn->setObjectName("dashDeleteBtn");
-      deleteBtn->setFixedSize(24, 24);
-      deleteBtn->setStyleSheet(
-          "QPushButton { background-color: transparent; border: none; }"
-          "QPushButton:hover { background-color: rgba(231, 76, 60, 0.2); "
-          "border-radius: 12px; }");
-      deleteBtn->setCursor(Qt::PointingHandCursor);
-      deleteBtn->setToolTip("Remove this custom port");
-
-      // Create red trash icon programmatically
-      QPixmap trashIcon(24, 24);
-      trashIcon.fill(Qt::transparent);
-      QPainter painter(&trashIcon);
-      painter.setRenderHint(QPainter::Antialiasing);
-      painter.setPen(QPen(QColor("#e74c3c"), 2.0));
-      painter.setBrush(Qt::NoBrush);
-
-      // Draw trash can body
-      painter.drawRect(7, 10, 10, 10);
-      // Draw trash can lid
-      painter.drawLine(6, 9, 18, 9);
-      painter.drawLine(8, 7, 16, 7);
-      // Draw vertical lines inside
-      painter.drawLine(10, 12, 10, 18);
-      painter.drawLine(14, 12, 14, 18);
-
-      painter.end();
-      deleteBtn->setIcon(QIcon(trashIcon));
-
-      // Position in top-right corner using absolute positioning
-      deleteBtn->move(container->width() - 28, 4);
-      deleteBtn->raise(); // Ensure it's on top
-
-      int portToDelete = def.port;
-      connect(deleteBtn, &QPushButton::clicked, this, [this, portToDelete]() {
-        // Remove from custom ports list
-        for (int j = 0; j < m_customPorts.size(); ++j) {
-          if (m_customPorts[j].port == portToDelete) {
-            m_customPorts.removeAt(j);
-            break;
-          }
-        }
-        saveCustomPorts();
-        setupDashboard();
-        onRefreshClicked();
-      });
-    }
-
-    layout->addWidget(nameLabel);
-    layout->addWidget(statusLabel);
-    layout->addStretch();
-    layout->addWidget(openBtn);
-
-    m_dashboardLayout->addWidget(container);
-    container->show();
-
-    m_trackedPorts.append({def.port, def.name, def.desc, statusLabel, container,
-                           openBtn, deleteBtn, isCustom});
+    PortStatus tracked;
+    tracked.port = def.port;
+    tracked.name = def.name;
+    tracked.description = def.desc;
+    tracked.isCustom = (i >= defaultPortCount);
+    m_trackedPorts.append(tracked);
+    m_dashboardLayout->addPlaceholder(QSize(160, 155));
   }
 
   // 3. Add "Add New Port" Card
   QPushButton *addPortBtn = new QPushButton(parentWidget);
-  addPortBtn->setFixedSize(160, 110);
+  addPortBtn->setFixedSize(160, 155);
   addPortBtn->setStyleSheet("QPushButton { "
                             "  background-color: transparent; "
                             "  border: 2px dashed #555555; "
@@ -443,6 +645,198 @@ void MainWindow::setupDashboard() {
   // Force layout update
   m_dashboardLayout->update();
   m_dashboardLayout->activate();
+  fitDashboardHeight();
+  // Entries of ports that are no longer tracked go away
+  updateTrayMenu();
+}
+
+QWidget *MainWindow::createCard(int index) {
+  if (index < 0 || index >= m_trackedPorts.size())
+    return nullptr;
+  PortStatus &tracked = m_trackedPorts[index];
+
+  QWidget *container = new QWidget(m_dashboardLayout->parentWidget());
+  container->setProperty("class", "dashboardCard");
+  container->setFixedSize(160, 155);
+  QVBoxLayout *layout = new QVBoxLayout(container);
+  layout->setContentsMargins(10, 10, 10, 10);
+  layout->setSpacing(5);
+
+  QLabel *nameLabel = new QLabel(
+      QString("%1 (%2)").arg(tracked.name).arg(tracked.port), container);
+  nameLabel->setObjectName("dashPortName");
+  nameLabel->setWordWrap(true);
+
+  QLabel *statusLabel = new QLabel("OFFLINE", container);
+  statusLabel->setObjectName("dashStatusLabel");
+  statusLabel->setStyleSheet("color: #888888;");
+  statusLabel->setToolTip(tracked.description);
+
+  QLabel *metricsLabel = new QLabel(container);
+  metricsLabel->setObjectName("dashMetricsLabel");
+  metricsLabel->setStyleSheet("color: #888888; font-size: 10px;");
+  metricsLabel->setToolTip("Accept queue depth / configured backlog and "
+                           "half-open (SYN_RECV) connections");
+  metricsLabel->setVisible(false);
+
+  QLabel *latencyLabel = new QLabel(container);
+  latencyLabel->setObjectName("dashLatencyLabel");
+  latencyLabel->setStyleSheet("color: #888888; font-size: 10px;");
+  latencyLabel->setToolTip("TCP connect latency, median / 99th percentile "
+                           "over the last one to two minutes");
+  latencyLabel->setVisible(false);
+
+  QLabel *healthLabel = new QLabel(container);
+  healthLabel->setObjectName("dashHealthLabel");
+  healthLabel->setStyleSheet("color: #888888; font-size: 10px;");
+  healthLabel->setVisible(false);
+
+  // Right-click a card to configure its latency probe and HTTP health check
+  container->setContextMenuPolicy(Qt::CustomContextMenu);
+  int cardPort = tracked.port;
+  connect(container, &QWidget::customContextMenuRequested, this,
+          [this, container, cardPort](const QPoint &pos) {
+            QMenu menu(this);
+            QAction *probe = menu.addAction("Probe Connect Latency");
+            probe->setCheckable(true);
+            probe->setChecked(m_latencyProbes.contains(cardPort));
+            connect(probe, &QAction::toggled, this,
+                    [this, cardPort](bool on) {
+                      setLatencyProbe(cardPort, on);
+                    });
+            menu.addAction("Health Check...", this, [this, cardPort]() {
+              configureHealthCheck(cardPort);
+            });
+            menu.exec(container->mapToGlobal(pos));
+          });
+
+  QPushButton *openBtn = new QPushButton("Launch", container);
+  openBtn->setObjectName("dashOpenBtn");
+  openBtn->setCursor(Qt::PointingHandCursor);
+  openBtn->setVisible(false);
+  connect(openBtn, &QPushButton::clicked, this, [cardPort]() {
+    QDesktopServices::openUrl(
+        QUrl(QString("http://localhost:%1").arg(cardPort)));
+  });
+
+  // Add delete button for custom ports (positioned in top-right corner)
+  QPushButton *deleteBtn = nullptr;
+  if (tracked.isCustom) {
+    deleteBtn = new QPushButton(container);
+    deleteBtn->setObjectName("dashDeleteBtn");
+    deleteBtn->setFixedSize(24, 24);
+    deleteBtn->setStyleSheet(
+        "QPushButton { background-color: transparent; border: none; }"
+        "QPushButton:hover { background-color: rgba(231, 76, 60, 0.2); "
+        "border-radius: 12px; }");
+    deleteBtn->setCursor(Qt::PointingHandCursor);
+    deleteBtn->setToolTip("Remove this custom port");
+
+    // Create red trash icon programmatically
+    QPixmap trashIcon(24, 24);
+    trashIcon.fill(Qt::transparent);
+    QPainter painter(&trashIcon);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setPen(QPen(QColor("#e74c3c"), 2.0));
+    painter.setBrush(Qt::NoBrush);
+
+    // Draw trash can body
+    painter.drawRect(7, 10, 10, 10);
+    // Draw trash can lid
+    painter.drawLine(6, 9, 18, 9);
+    painter.drawLine(8, 7, 16, 7);
+    // Draw vertical lines inside
+    painter.drawLine(10, 12, 10, 18);
+    painter.drawLine(14, 12, 14, 18);
+
+    painter.end();
+    deleteBtn->setIcon(QIcon(trashIcon));
+
+    // Position in top-right corner using absolute positioning
+    deleteBtn->move(container->width() - 28, 4);
+    deleteBtn->raise(); // Ensure it's on top
+
+    int portToDelete = tracked.port;
+    connect(deleteBtn, &QPushButton::clicked, this, [this, portToDelete]() {
+      // Remove from custom ports list
+      for (int j = 0; j < m_customPorts.size(); ++j) {
+        if (m_customPorts[j].port == portToDelete) {
+          m_customPorts.removeAt(j);
+          break;
+        }
+      }
+      saveCustomPorts();
+      setupDashboard();
+      onRefreshClicked();
+    });
+  }
+
+  layout->addWidget(nameLabel);
+  layout->addWidget(statusLabel);
+  layout->addWidget(metricsLabel);
+  layout->addWidget(latencyLabel);
+  layout->addWidget(healthLabel);
+  layout->addStretch();
+  layout->addWidget(openBtn);
+
+  tracked.container = container;
+  tracked.label = statusLabel;
+  tracked.metricsLabel = metricsLabel;
+  tracked.latencyLabel = latencyLabel;
+  tracked.healthLabel = healthLabel;
+  tracked.openButton = openBtn;
+
+  // Catch up with whatever happened while the card was off screen
+  tracked.shownOnline = -1;
+  tracked.shownProcess.clear();
+  tracked.shownMetrics.clear();
+  renderCard(tracked);
+  renderLatency(tracked);
+  renderHealth(tracked);
+  return container;
+}
+
+void MainWindow::releaseCard(int index) {
+  if (index < 0 || index >= m_trackedPorts.size())
+    return;
+  // The layout deletes the widgets; the card's state stays for next time
+  PortStatus &tracked = m_trackedPorts[index];
+  tracked.container = nullptr;
+  tracked.label = nullptr;
+  tracked.metricsLabel = nullptr;
+  tracked.latencyLabel = nullptr;
+  tracked.healthLabel = nullptr;
+  tracked.openButton = nullptr;
+}
+
+void MainWindow::fitDashboardHeight() {
+  if (!m_dashboardScroll)
+    return;
+  // As tall as the cards need, up to about three rows; the rest scrolls
+  static const int kMaxDashboardHeight = 520;
+  QWidget *frame = m_dashboardScroll->widget();
+  const int width = m_dashboardScroll->viewport()->width();
+  const int height = frame->hasHeightForWidth() ? frame->heightForWidth(width)
+                                                : frame->sizeHint().height();
+  m_dashboardScroll->setFixedHeight(qMin(height, kMaxDashboardHeight));
+}
+
+void MainWindow::updateDashboardViewport() {
+  if (!m_dashboardScroll)
+    return;
+  QWidget *viewport = m_dashboardScroll->viewport();
+  m_dashboardLayout->setVisibleRect(
+      QRect(0, m_dashboardScroll->verticalScrollBar()->value(),
+            viewport->width(), viewport->height()));
+}
+
+bool MainWindow::eventFilter(QObject *watched, QEvent *event) {
+  if (m_dashboardScroll && watched == m_dashboardScroll->viewport() &&
+      event->type() == QEvent::Resize) {
+    fitDashboardHeight();
+    updateDashboardViewport();
+  }
+  return QMainWindow::eventFilter(watched, event);
 }
 
 void MainWindow::onAddPortClicked() {
@@ -505,6 +899,55 @@ void MainWindow::saveCustomPorts() {
   settings.setValue("customPorts", list);
 }
 
+void MainWindow::saveHealthChecks() {
+  QSettings settings("KadirMertAbatay", "PortMonitor");
+  QStringList list;
+  for (const auto &check : m_healthChecks) {
+    list << QString("%1:%2:%3")
+                .arg(check.port)
+                .arg(check.expectedStatus)
+                .arg(check.path);
+  }
+  settings.setValue("healthChecks", list);
+}
+
+void MainWindow::loadHealthChecks() {
+  QSettings settings("KadirMertAbatay", "PortMonitor");
+  QStringList list = settings.value("healthChecks").toStringList();
+  m_healthChecks.clear();
+
+  // "port:expectedStatus:path", the path may contain colons
+  for (const QString &item : list) {
+    QStringList parts = item.split(":");
+    if (parts.size() < 3)
+      continue;
+    HealthCheck check;
+    check.port = parts[0].toInt();
+    check.expectedStatus = parts[1].toInt();
+    check.path = parts.mid(2).join(":");
+    if (check.port > 0)
+      m_healthChecks.insert(check.port, check);
+  }
+}
+
+void MainWindow::saveLatencyProbes() {
+  QSettings settings("KadirMertAbatay", "PortMonitor");
+  QStringList list;
+  for (int port : m_latencyProbes)
+    list << QString::number(port);
+  settings.setValue("latencyProbes", list);
+}
+
+void MainWindow::loadLatencyProbes() {
+  QSettings settings("KadirMertAbatay", "PortMonitor");
+  m_latencyProbes.clear();
+  for (const QString &item : settings.value("latencyProbes").toStringList()) {
+    const int port = item.toInt();
+    if (port > 0)
+      m_latencyProbes.insert(port);
+  }
+}
+
 void MainWindow::loadCustomPorts() {
   QSettings settings("KadirMertAbatay", "PortMonitor");
   QStringList list = settings.value("customPorts").toStringList();
@@ -525,85 +968,627 @@ void MainWindow::loadCustomPorts() {
 }
 
 void MainWindow::updateDashboard(const QList<PortInfo> &ports) {
-  qDebug() << "Updating dashboard with" << ports.size() << "ports";
+  StageProfiler::Scope stage("updateDashboard");
+  QElapsedTimer timer;
+  timer.start();
+
+  // Port -> the socket a card shows: the listener if there is one (it
+  // carries the backlog metrics), else the first socket on the port
+  QHash<int, const PortInfo *> byPort;
+  byPort.reserve(ports.size());
+  for (const PortInfo &p : ports) {
+    const PortInfo *&shown = byPort[p.port];
+    if (!shown || (p.state == "LISTEN" && shown->state != "LISTEN"))
+      shown = &p;
+  }
+
+  // Port -> agents' hosts listening on it
+  QHash<int, QStringList> remoteHosts;
+  if (!m_agentCollector->hosts().isEmpty()) {
+    for (const PortInfo &p : m_agentCollector->ports()) {
+      QStringList &hosts = remoteHosts[p.port];
+      if (p.state == "LISTEN" && !hosts.contains(p.host))
+        hosts.append(p.host);
+    }
+  }
+
+  // Last session's rows only fill in the cards; their PIDs and listeners
+  // may be gone or reused, so nothing is sampled, probed or checked
+  // until the first scan
+  const bool stale = m_model->isStale();
+  int touched = 0;
+  bool onlineChanged = false;
   for (auto &tracked : m_trackedPorts) {
-    bool found = false;
-    QString process;
-    for (const auto &p : ports) {
-      if (p.port == tracked.port) {
-        qDebug() << "Matched port" << tracked.port << "with process"
-                 << p.processName;
-        found = true;
-        process = p.processName;
-        break;
-      }
+    const PortInfo *match = byPort.value(tracked.port, nullptr);
+    const PortInfo *listener =
+        (match && match->state == "LISTEN") ? match : nullptr;
+    tracked.ownerPid = (match && !stale) ? match->pid.toLongLong() : -1;
+
+    QString metrics;
+    if (listener && listener->acceptQueue >= 0) {
+      QString queue =
+          (listener->backlog >= 0)
+              ? QString("%1/%2").arg(listener->acceptQueue).arg(
+                    listener->backlog)
+              : QString::number(listener->acceptQueue);
+      metrics = QString("Queue %1 · SYN %2").arg(queue).arg(listener->synRecv);
+    }
+    QStringList hosts = remoteHosts.value(tracked.port);
+    if (!hosts.isEmpty()) {
+      hosts.sort();
+      QString up = "Up on " + hosts.mid(0, 3).join(", ");
+      if (hosts.size() > 3)
+        up += QString(" +%1").arg(hosts.size() - 3);
+      metrics = metrics.isEmpty() ? up : metrics + " · " + up;
     }
 
-    if (found) {
-      tracked.label->setText(QString("● ONLINE (%1)").arg(process));
+    if (tracked.online != (match != nullptr))
+      onlineChanged = true;
+    tracked.online = (match != nullptr);
+    tracked.process = match ? match->processName : QString();
+    tracked.metrics = metrics;
+    // Cards off screen have no widgets; they render when created
+    if (tracked.container && renderCard(tracked))
+      touched++;
+
+    if (stale)
+      continue;
+    checkBacklogAlert(tracked, listener);
+    updateCardProbe(tracked, listener);
+    updateCardHealthCheck(tracked);
+  }
+  if (!stale)
+    m_watchedPidsTimer->start();
+  // The tray menu only lists which ports are online
+  if (onlineChanged)
+    updateTrayMenu();
+
+  m_dashboardUpdateUs = timer.nsecsElapsed() / 1000;
+  m_dashboardCardsTouched = touched;
+}
+
+bool MainWindow::renderCard(PortStatus &tracked) {
+  // Labels, and above all the stylesheet re-polish, are only redone for
+  // cards that changed since the last refresh
+  const int online = tracked.online ? 1 : 0;
+  bool changed = false;
+  if (online != tracked.shownOnline ||
+      tracked.process != tracked.shownProcess) {
+    if (tracked.online) {
+      tracked.label->setText(QString("● ONLINE (%1)").arg(tracked.process));
       tracked.label->setStyleSheet("color: #81c784; font-weight: bold;");
-      tracked.openButton->setVisible(true);
-      tracked.container->setProperty("online", true);
     } else {
       tracked.label->setText("○ OFFLINE");
       tracked.label->setStyleSheet("color: #666666;");
-      tracked.openButton->setVisible(false);
-      tracked.container->setProperty("online", false);
     }
-    // Refresh style
-    tracked.container->style()->unpolish(tracked.container);
-    tracked.container->style()->polish(tracked.container);
+    tracked.openButton->setVisible(tracked.online);
+    if (online != tracked.shownOnline) {
+      tracked.container->setProperty("online", tracked.online);
+      // Refresh style
+      tracked.container->style()->unpolish(tracked.container);
+      tracked.container->style()->polish(tracked.container);
+    }
+    tracked.shownOnline = online;
+    tracked.shownProcess = tracked.process;
+    changed = true;
   }
-  updateTrayMenu();
+
+  if (tracked.metrics != tracked.shownMetrics) {
+    tracked.metricsLabel->setText(tracked.metrics);
+    tracked.metricsLabel->setVisible(!tracked.metrics.isEmpty());
+    tracked.shownMetrics = tracked.metrics;
+    changed = true;
+  }
+  return changed;
+}
+
+void MainWindow::updateCardProbe(PortStatus &tracked,
+                                 const PortInfo *listener) {
+  // Only TCP listeners can be connect-probed
+  QString host;
+  if (listener && listener->protocol == "TCP")
+    host = ProbeEngine::probeHost(listener->localAddress);
+  if (host != tracked.probeHost) {
+    if (!tracked.probeKey.isEmpty())
+      m_probeEngine->unwatch(tracked.probeHost, tracked.port);
+    tracked.probeHost = host;
+    tracked.probeKey.clear();
+    tracked.probe = ProbeStats();
+    renderLatency(tracked);
+  }
+  applyCardProbe(tracked);
+}
+
+void MainWindow::applyCardProbe(PortStatus &tracked) {
+  // Opt-in per card: every probe is a real connection, which services such
+  // as PostgreSQL log as an incomplete startup
+  const bool wanted =
+      !tracked.probeHost.isEmpty() && m_latencyProbes.contains(tracked.port);
+  if (wanted == !tracked.probeKey.isEmpty())
+    return;
+
+  if (!wanted) {
+    m_probeEngine->unwatch(tracked.probeHost, tracked.port);
+    tracked.probeKey.clear();
+    tracked.probe = ProbeStats();
+    renderLatency(tracked);
+    return;
+  }
+  tracked.probeKey = ProbeEngine::targetKey(tracked.probeHost, tracked.port);
+  m_probeEngine->resetStats(tracked.probeKey);
+  m_probeEngine->watch(tracked.probeHost, tracked.port);
+}
+
+void MainWindow::setLatencyProbe(int port, bool enabled) {
+  if (enabled)
+    m_latencyProbes.insert(port);
+  else
+    m_latencyProbes.remove(port);
+  saveLatencyProbes();
+
+  for (auto &tracked : m_trackedPorts) {
+    if (tracked.port == port)
+      applyCardProbe(tracked);
+  }
+}
+
+void MainWindow::onProbeStats(const ProbeStats &stats) {
+  for (auto &tracked : m_trackedPorts) {
+    if (tracked.probeKey != stats.target)
+      continue;
+    tracked.probe = stats;
+    renderLatency(tracked);
+  }
+}
+
+void MainWindow::renderLatency(PortStatus &tracked) {
+  if (!tracked.latencyLabel)
+    return;
+  const ProbeStats &stats = tracked.probe;
+  if (stats.target.isEmpty()) {
+    tracked.latencyLabel->clear();
+    tracked.latencyLabel->setVisible(false);
+    return;
+  }
+  if (stats.lastMs < 0) {
+    tracked.latencyLabel->setText("Connect failed");
+    tracked.latencyLabel->setStyleSheet("color: #e57373; font-size: 10px;");
+  } else {
+    tracked.latencyLabel->setText(QString("Connect %1 / %2 ms")
+                                      .arg(stats.p50Ms, 0, 'f', 2)
+                                      .arg(stats.p99Ms, 0, 'f', 2));
+    tracked.latencyLabel->setStyleSheet("color: #888888; font-size: 10px;");
+  }
+  tracked.latencyLabel->setVisible(true);
+}
+
+void MainWindow::updateCardHealthCheck(PortStatus &tracked) {
+  auto config = m_healthChecks.constFind(tracked.port);
+  if (config == m_healthChecks.constEnd() || tracked.probeHost.isEmpty()) {
+    if (tracked.healthActive) {
+      m_healthChecker->removeCheck(tracked.port);
+      tracked.healthActive = false;
+      tracked.health = HealthResult();
+      renderHealth(tracked);
+    }
+    return;
+  }
+
+  // Same host as the connect probe; unchanged checks keep their connection
+  HealthCheck check = config.value();
+  check.host = tracked.probeHost;
+  check.port = tracked.port;
+  m_healthChecker->setCheck(check);
+  if (!tracked.healthActive) {
+    tracked.healthActive = true;
+    renderHealth(tracked);
+  }
+}
+
+void MainWindow::onHealthResult(const HealthResult &result) {
+  bool matched = false;
+  for (auto &tracked : m_trackedPorts) {
+    if (tracked.port != result.port || !tracked.healthActive)
+      continue;
+    tracked.health = result;
+    renderHealth(tracked);
+    matched = true;
+  }
+
+  // The tray shows the latest latency too; the update is incremental and
+  // only relabels entries whose text changed
+  if (matched)
+    updateTrayMenu();
+}
+
+void MainWindow::renderHealth(PortStatus &tracked) {
+  if (!tracked.healthLabel)
+    return;
+  if (!tracked.healthActive) {
+    tracked.healthLabel->clear();
+    tracked.healthLabel->setVisible(false);
+    return;
+  }
+
+  const HealthResult &result = tracked.health;
+  if (result.port == 0) {
+    // Configured, no result yet
+    tracked.healthLabel->setText("HTTP ...");
+    tracked.healthLabel->setStyleSheet("color: #888888; font-size: 10px;");
+    tracked.healthLabel->setToolTip(QString());
+    tracked.healthLabel->setVisible(true);
+    return;
+  }
+
+  QString text;
+  if (result.status < 0)
+    text = QString("HTTP %1").arg(result.error.isEmpty() ? "failed"
+                                                         : result.error);
+  else
+    text = QString("HTTP %1 · TTFB %2 ms")
+               .arg(result.status)
+               .arg(result.ttfbMs, 0, 'f', 1);
+  tracked.healthLabel->setText(text);
+  tracked.healthLabel->setStyleSheet(result.healthy
+                                         ? "color: #81c784; font-size: 10px;"
+                                         : "color: #e57373; font-size: 10px;");
+  if (result.status < 0) {
+    tracked.healthLabel->setToolTip(result.error);
+  } else {
+    tracked.healthLabel->setToolTip(
+        QString("Connect: %1\nTime to first byte: %2 ms")
+            .arg(result.reused
+                     ? QString("reused connection")
+                     : QString("%1 ms").arg(result.connectMs, 0, 'f', 1))
+            .arg(result.ttfbMs, 0, 'f', 1));
+  }
+  tracked.healthLabel->setVisible(true);
+}
+
+void MainWindow::configureHealthCheck(int port) {
+  QDialog dialog(this);
+  dialog.setWindowTitle(QString("Health Check (%1)").arg(port));
+  dialog.setModal(true);
+  dialog.setStyleSheet("background-color: #2b2b2b; color: #ffffff;");
+
+  QFormLayout form(&dialog);
+  const QString editStyle =
+      "padding: 5px; border: 1px solid #555; border-radius: 4px; background: "
+      "#1e1e1e; color: white;";
+
+  const bool configured = m_healthChecks.contains(port);
+  const HealthCheck current = m_healthChecks.value(port);
+
+  QCheckBox *enabledCheck = new QCheckBox("Check over HTTP", &dialog);
+  enabledCheck->setChecked(configured);
+
+  QLineEdit *pathEdit = new QLineEdit(current.path, &dialog);
+  pathEdit->setPlaceholderText("/health");
+  pathEdit->setStyleSheet(editStyle);
+
+  QSpinBox *statusEdit = new QSpinBox(&dialog);
+  statusEdit->setRange(0, 599);
+  statusEdit->setSpecialValueText("Any below 400");
+  statusEdit->setValue(current.expectedStatus);
+  statusEdit->setStyleSheet(editStyle);
+
+  form.addRow(enabledCheck);
+  form.addRow("Path:", pathEdit);
+  form.addRow("Expected Status:", statusEdit);
+
+  QDialogButtonBox buttonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel,
+                             Qt::Horizontal, &dialog);
+  buttonBox.setStyleSheet("QPushButton { padding: 5px 15px; }");
+  connect(&buttonBox, &QDialogButtonBox::accepted, &dialog, &QDialog::accept);
+  connect(&buttonBox, &QDialogButtonBox::rejected, &dialog, &QDialog::reject);
+  form.addRow(&buttonBox);
+
+  if (dialog.exec() != QDialog::Accepted)
+    return;
+
+  if (enabledCheck->isChecked()) {
+    HealthCheck check;
+    check.port = port;
+    check.path = pathEdit->text().trimmed();
+    if (!check.path.startsWith('/'))
+      check.path.prepend('/');
+    check.expectedStatus = statusEdit->value();
+    m_healthChecks.insert(port, check);
+  } else {
+    m_healthChecks.remove(port);
+  }
+  saveHealthChecks();
+
+  for (auto &tracked : m_trackedPorts) {
+    if (tracked.port == port)
+      updateCardHealthCheck(tracked);
+  }
+}
+
+void MainWindow::applyGroupSpans() {
+  m_portTable->clearSpans();
+  if (!m_model->groupByUnit())
+    return;
+  for (int row = 0; row < m_model->rowCount(); ++row) {
+    if (m_model->isGroupRow(row))
+      m_portTable->setSpan(row, 0, 1, PortTableModel::ColumnCount);
+  }
+}
+
+void MainWindow::updateWatchedPids() {
+  // Only rows inside the viewport, plus the dashboard owners, are sampled;
+  // none while the rows are last session's
+  QSet<qint64> pids;
+  int first = m_model->isStale() ? -1 : m_portTable->rowAt(0);
+  if (first >= 0) {
+    int last = m_portTable->rowAt(m_portTable->viewport()->height() - 1);
+    if (last < 0)
+      last = m_model->rowCount() - 1;
+    for (int row = first; row <= last; ++row)
+      pids.insert(m_model->pidAt(row));
+  }
+  for (const auto &tracked : m_trackedPorts) {
+    if (tracked.ownerPid > 0)
+      pids.insert(tracked.ownerPid);
+  }
+  pids.remove(-1);
+  m_resourceSampler->setWatchedPids(pids);
+}
+
+void MainWindow::checkBacklogAlert(PortStatus &tracked,
+                                   const PortInfo *listener) {
+  bool high = listener && listener->backlog > 0 &&
+              listener->acceptQueue * 100 >=
+                  listener->backlog * m_backlogAlertPercent;
+  if (!high) {
+    tracked.backlogHighSince = QDateTime();
+    tracked.backlogAlerted = false;
+    return;
+  }
+
+  QDateTime now = QDateTime::currentDateTime();
+  if (!tracked.backlogHighSince.isValid())
+    tracked.backlogHighSince = now;
+
+  if (tracked.backlogAlerted ||
+      tracked.backlogHighSince.secsTo(now) < m_backlogAlertSeconds)
+    return;
+
+  // Alert once per saturation episode; it re-arms when the queue drains
+  tracked.backlogAlerted = true;
+  Alert alert;
+  alert.rule = "Accept backlog saturated";
+  alert.port = tracked.port;
+  alert.socket = *listener;
+  alert.message = QString("%1 (%2): accept queue %3/%4, %5 SYN_RECV")
+                      .arg(tracked.name)
+                      .arg(tracked.port)
+                      .arg(listener->acceptQueue)
+                      .arg(listener->backlog)
+                      .arg(listener->synRecv);
+  // Each port already alerts once per episode; this only caps a burst
+  m_alertEngine->raise(alert, 60);
+}
+
+void MainWindow::onAlert(const Alert &alert) {
+  PortInfo info = alert.socket;
+  info.port = alert.port;
+  addLogEntry((alert.firing ? "Alert: " : "Resolved: ") + alert.rule, info);
+  if (!alert.firing || !m_trayIcon || !m_trayIcon->isVisible() ||
+      !m_notificationsEnabled) {
+    return;
+  }
+  QString message = alert.message;
+  if (alert.suppressed > 0)
+    message += QString("\n(%1 more since the last one)").arg(alert.suppressed);
+  m_trayIcon->showMessage(alert.rule, message, QSystemTrayIcon::Warning, 5000);
+}
+
+void MainWindow::reloadAlertRules() {
+  QString error;
+  QList<AlertRule> rules =
+      AlertEngine::load(AlertEngine::defaultPath(), &error);
+  if (!error.isEmpty()) {
+    statusBar()->showMessage(
+        QString("Alert rules: %1; using the defaults").arg(error), 5000);
+    rules = AlertEngine::defaultRules();
+  }
+  m_alertEngine->setRules(rules);
 }
 
 void MainWindow::onRefreshClicked() {
-  statusBar()->showMessage("Scanning ports...");
+  if (m_model->isStale()) {
+    statusBar()->showMessage(
+        QString("Last session's %1 connections from %2 (stale) · Scanning "
+                "ports...")
+            .arg(m_localPorts.size())
+            .arg(QLocale().toString(m_snapshotTakenAt.toLocalTime(),
+                                    QLocale::ShortFormat)));
+  } else {
+    statusBar()->showMessage("Scanning ports...");
+  }
   m_portMonitor->refresh();
 }
 
-void MainWindow::onPortsUpdated(const QList<PortInfo> &ports) {
+void MainWindow::showSnapshot() {
+  const QList<PortInfo> ports =
+      SnapshotStore::load(SnapshotStore::defaultPath(), &m_snapshotTakenAt);
+  if (ports.isEmpty())
+    return;
+
+  // Displayed like a scan result, minus the status bar summary, and greyed
+  // out until the first scan replaces it
+  m_localPorts = ports;
   m_allPorts = ports;
-  updateDashboard(ports);
+  m_model->setStale(true);
+  QList<PortInfo> hostPorts;
+  for (const PortInfo &info : ports) {
+    if (info.netnsOwner.isEmpty() || info.netnsOwner == "host")
+      hostPorts.append(info);
+  }
+  updateDashboard(hostPorts);
   onFilterTextChanged(m_searchBox->text());
-  statusBar()->showMessage(QString("Active connections: %1").arg(ports.size()));
+}
+
+void MainWindow::saveSnapshot() {
+  if (m_model->isStale())
+    return; // Nothing new since the last session
+  SnapshotStore::save(SnapshotStore::defaultPath(), m_localPorts);
+  m_snapshotSaved.start();
+}
+
+void MainWindow::setShareScans(bool enabled) {
+  m_shareScans = enabled;
+  if (!enabled) {
+    m_snapshotServer->close();
+    return;
+  }
+  if (m_snapshotServer->isListening())
+    return;
+  if (!m_snapshotServer->listen(SnapshotServer::defaultPath())) {
+    statusBar()->showMessage(
+        "Could not share scans: " + m_snapshotServer->errorString(), 5000);
+    return;
+  }
+  // Viewers that connect now get the current scan, not the next one
+  if (!m_localPorts.isEmpty() && !m_model->isStale())
+    m_snapshotServer->publish(m_localPorts);
+}
+
+void MainWindow::setMetricsPort(int port) {
+  if (port == m_metricsPort && m_metricsExporter->isListening())
+    return;
+  m_metricsPort = port;
+  m_metricsExporter->close();
+  if (port <= 0)
+    return;
+  if (!m_metricsExporter->listen(quint16(port))) {
+    statusBar()->showMessage(
+        "Could not export metrics: " + m_metricsExporter->errorString(),
+        5000);
+    return;
+  }
+  if (!m_localPorts.isEmpty() && !m_model->isStale())
+    m_metricsExporter->recordScan(m_localPorts, m_portMonitor->lastScanMs());
+}
+
+void MainWindow::setAgentPort(int port, const QString &token) {
+  if (port == m_agentPort && token == m_agentToken &&
+      m_agentCollector->isListening()) {
+    return;
+  }
+  m_agentPort = port;
+  m_agentToken = token;
+  m_agentCollector->close(); // Agents reconnect on their own
+  if (port <= 0)
+    return;
+  if (!m_agentCollector->listen(quint16(port), token)) {
+    statusBar()->showMessage(
+        "Could not accept agents: " + m_agentCollector->errorString(), 5000);
+  }
+}
+
+void MainWindow::onPortsUpdated(const QList<PortInfo> &ports) {
+  StageProfiler::Scope stage("onPortsUpdated");
+  m_localPorts = ports;
+  m_alertEngine->update(ports);
+  m_model->setStale(false);
+  if (m_startupClock.isValid() && !m_freshDataReported) {
+    m_freshDataReported = true;
+    qInfo("startup: fresh data after %lld ms", m_startupClock.elapsed());
+  }
+  // Kept current for the next launch, without rewriting it every scan
+  if (!m_snapshotSaved.isValid() || m_snapshotSaved.elapsed() >= 60000)
+    saveSnapshot();
+  if (m_snapshotServer->isListening())
+    m_snapshotServer->publish(ports);
+  if (m_metricsExporter->isListening())
+    m_metricsExporter->recordScan(ports, m_portMonitor->lastScanMs());
+
+  // Processes that no longer own a socket may have exited; forget them so a
+  // reused PID is always looked up afresh
+  QSet<qint64> livePids;
+  for (const PortInfo &info : ports) {
+    livePids.insert(info.pid.toLongLong());
+  }
+  ProcessInfoCache::instance()->retainOnly(livePids);
+  m_resourceSampler->retainOnly(livePids);
+  showPorts();
+}
+
+void MainWindow::showPorts() {
+  m_agentUpdateTimer->stop();
+  m_allPorts = m_localPorts;
+  const QStringList hosts = m_agentCollector->hosts();
+  if (!hosts.isEmpty())
+    m_allPorts += m_agentCollector->ports();
+  m_portTable->setColumnHidden(PortTableModel::Host, hosts.isEmpty());
+
+  // Cards track ports reachable from this host; other namespaces and
+  // hosts only show up in the table
+  QList<PortInfo> hostPorts;
+  for (const PortInfo &info : m_localPorts) {
+    if (info.netnsOwner.isEmpty() || info.netnsOwner == "host")
+      hostPorts.append(info);
+  }
+  updateDashboard(hostPorts);
+  onFilterTextChanged(m_searchBox->text());
+  const QString agents =
+      hosts.isEmpty() ? QString() : QString(" · %1 agents").arg(hosts.size());
+  statusBar()->showMessage(
+      QString("Active connections: %1%2%3 · Dashboard %4 ms, %5/%6 cards "
+              "updated")
+          .arg(m_allPorts.size())
+          .arg(m_namespaceSummary)
+          .arg(agents)
+          .arg(m_dashboardUpdateUs / 1000.0, 0, 'f', 2)
+          .arg(m_dashboardCardsTouched)
+          .arg(m_trackedPorts.size()));
 }
 
 void MainWindow::onFilterTextChanged(const QString &text) {
-  // Filter Dashboard Cards
-  for (const auto &tracked : m_trackedPorts) {
-    bool match = text.isEmpty() ||
+  StageProfiler::Scope stage("onFilterTextChanged");
+  // Filter Dashboard Cards (a unit: filter only applies to the table)
+  const bool unitFilter = text.startsWith("unit:", Qt::CaseInsensitive);
+  for (int i = 0; i < m_trackedPorts.size(); ++i) {
+    const PortStatus &tracked = m_trackedPorts[i];
+    bool match = text.isEmpty() || unitFilter ||
                  tracked.name.contains(text, Qt::CaseInsensitive) ||
                  tracked.description.contains(text, Qt::CaseInsensitive) ||
                  QString::number(tracked.port).contains(text);
-    tracked.container->setVisible(match);
+    // Card items line up with m_trackedPorts; off-screen ones have no widget
+    m_dashboardLayout->setItemHidden(i, !match);
   }
+  fitDashboardHeight();
 
   // Filter Table
-  if (text.isEmpty()) {
-    m_model->setPorts(m_allPorts);
-    return;
-  }
-  QList<PortInfo> filtered;
-  for (const PortInfo &info : m_allPorts) {
-    if (info.processName.contains(text, Qt::CaseInsensitive) ||
-        info.pid.contains(text, Qt::CaseInsensitive) ||
-        QString::number(info.port).contains(text) ||
-        info.protocol.contains(text, Qt::CaseInsensitive)) {
-      filtered.append(info);
-    }
-  }
-  m_model->setPorts(filtered);
+  m_model->setPorts(PortTableModel::filter(m_allPorts, text));
 }
 
 void MainWindow::onCustomContextMenuRequested(const QPoint &pos) {
   QModelIndex index = m_portTable->indexAt(pos);
-  if (!index.isValid())
+  if (!index.isValid() || m_model->isGroupRow(index.row()))
     return;
 
+  QSet<QString> pids;
+  bool remote = false;
+  for (const QModelIndex &row : m_portTable->selectionModel()->selectedRows()) {
+    remote = remote || m_model->isRemoteRow(row.row());
+    if (!m_model->isGroupRow(row.row()))
+      pids.insert(
+          m_model->data(m_model->index(row.row(), PortTableModel::PID))
+              .toString());
+  }
+
   QMenu contextMenu(this);
-  contextMenu.addAction(QIcon::fromTheme("application-exit"), "End Process",
-                        this, &MainWindow::onKillProcessRequested);
+  QAction *endAction = contextMenu.addAction(
+      QIcon::fromTheme("application-exit"),
+      pids.size() > 1 ? QString("End %1 Processes").arg(pids.size())
+                      : QString("End Process"),
+      this, &MainWindow::onKillProcessRequested);
+  // A PID from the last session may belong to another process by now, and
+  // other hosts' processes are out of reach
+  endAction->setEnabled(!m_model->isStale() && !remote);
   contextMenu.addAction(
       QIcon::fromTheme("edit-copy"), "Copy PID", this, [this, index]() {
         int row = index.row();
@@ -620,52 +1605,94 @@ void MainWindow::onCustomContextMenuRequested(const QPoint &pos) {
 
 void MainWindow::onKillProcessRequested() {
   QModelIndexList selection = m_portTable->selectionModel()->selectedRows();
-  if (selection.isEmpty())
+  if (selection.isEmpty() || m_model->isStale())
     return;
 
-  int row = selection.first().row();
-  QString pidStr =
-      m_model->data(m_model->index(row, PortTableModel::PID)).toString();
-  QString name = m_model->data(m_model->index(row, PortTableModel::ProcessName))
-                     .toString();
-  bool ok;
-  qint64 pid = pidStr.toLongLong(&ok);
-
-  if (ok) {
-    QMessageBox::StandardButton reply;
-    reply = QMessageBox::question(
-        this, "End Process",
-        QString("Are you sure you want to end process '%1' (PID: %2)?")
-            .arg(name)
-            .arg(pid),
-        QMessageBox::Yes | QMessageBox::No);
-
-    if (reply == QMessageBox::Yes) {
-      connect(m_portMonitor, &PortMonitor::processKilled, this,
-              [this, name, pid](qint64, bool success, const QString &msg) {
-                if (!success) {
-                  QMessageBox::critical(this, "Error",
-                                        "Failed to kill process: " + msg);
-                } else {
-                  statusBar()->showMessage("Process killed successfully.");
-
-                  // Manually create info for log since port closed might come
-                  // later or not carry same details immediately
-                  PortInfo info;
-                  info.processName = name;
-                  info.pid = QString::number(pid);
-                  addLogEntry("Process Killed", info);
-
-                  onRefreshClicked();
-                }
-                // Disconnect to avoid multiple slots overlapping on
-                // subsequent calls
-                disconnect(m_portMonitor, &PortMonitor::processKilled, this,
-                           nullptr);
-              });
-      m_portMonitor->killProcess(pid);
-    }
+  // One entry per process, however many of its sockets are selected
+  QMap<qint64, QString> targets;
+  for (const QModelIndex &index : selection) {
+    const int row = index.row();
+    if (m_model->isGroupRow(row) || m_model->isRemoteRow(row))
+      continue;
+    bool ok;
+    qint64 pid = m_model->data(m_model->index(row, PortTableModel::PID))
+                     .toString()
+                     .toLongLong(&ok);
+    if (!ok || m_pendingKills.contains(pid))
+      continue;
+    targets.insert(
+        pid, m_model->data(m_model->index(row, PortTableModel::ProcessName))
+                 .toString());
+  }
+  if (targets.isEmpty())
+    return;
+
+  QString question;
+  if (targets.size() == 1) {
+    question = QString("Are you sure you want to end process '%1' (PID: %2)?")
+                   .arg(targets.first())
+                   .arg(targets.firstKey());
+  } else {
+    QStringList names;
+    for (auto it = targets.cbegin(); it != targets.cend(); ++it)
+      names << QString("%1 (%2)").arg(it.value()).arg(it.key());
+    question = QString("Are you sure you want to end %1 processes?\n\n%2")
+                   .arg(targets.size())
+                   .arg(names.join("\n"));
+  }
+
+  QSettings settings("KadirMertAbatay", "PortMonitor");
+  QMessageBox box(QMessageBox::Question, "End Process", question,
+                  QMessageBox::Yes | QMessageBox::No, this);
+  QCheckBox *graceful =
+      new QCheckBox("Let it shut down first (SIGTERM, SIGKILL after 3 s)");
+  graceful->setChecked(settings.value("gracefulTermination", true).toBool());
+  box.setCheckBox(graceful);
+  if (box.exec() != QMessageBox::Yes)
+    return;
+  settings.setValue("gracefulTermination", graceful->isChecked());
+
+  for (auto it = targets.cbegin(); it != targets.cend(); ++it)
+    m_pendingKills.insert(it.key(), it.value());
+  statusBar()->showMessage(targets.size() == 1
+                               ? QString("Ending process...")
+                               : QString("Ending %1 processes...")
+                                     .arg(targets.size()));
+  // Results may arrive synchronously; everything is queued up by now
+  for (auto it = targets.cbegin(); it != targets.cend(); ++it)
+    m_portMonitor->killProcess(it.key(), graceful->isChecked());
+}
+
+void MainWindow::onProcessKilled(qint64 pid, bool success,
+                                 const QString &message) {
+  auto it = m_pendingKills.find(pid);
+  if (it == m_pendingKills.end())
+    return;
+  const QString name = it.value();
+  m_pendingKills.erase(it);
+
+  if (success) {
+    // Manually create info for log since port closed might come
+    // later or not carry same details immediately
+    PortInfo info;
+    info.processName = name;
+    info.pid = QString::number(pid);
+    addLogEntry("Process Killed", info);
+  } else {
+    m_killFailures << QString("%1 (%2): %3").arg(name).arg(pid).arg(message);
   }
+
+  if (!m_pendingKills.isEmpty())
+    return;
+  // The monitor rescans the ports the processes held on its own
+  if (m_killFailures.isEmpty()) {
+    statusBar()->showMessage("Process killed successfully.");
+    return;
+  }
+  const QStringList failures = m_killFailures;
+  m_killFailures.clear();
+  QMessageBox::critical(this, "Error",
+                        "Failed to kill process:\n" + failures.join("\n"));
 }
 
 void MainWindow::showProcessDetails() {
@@ -674,6 +1701,8 @@ void MainWindow::showProcessDetails() {
     return;
 
   int row = selection.first().row();
+  if (m_model->isGroupRow(row) || m_model->isRemoteRow(row))
+    return;
 
   PortInfo info;
   info.processName =
@@ -695,7 +1724,7 @@ void MainWindow::showProcessDetails() {
   dialog.exec();
 }
 
-void MainWindow::setupSettingsTab(QWidget *parent) {
+QWidget *MainWindow::createSettingsTab() {
   QWidget *settingsTab = new QWidget();
   QVBoxLayout *mainLayout = new QVBoxLayout(settingsTab);
   mainLayout->setSpacing(0);
@@ -726,19 +1755,128 @@ void MainWindow::setupSettingsTab(QWidget *parent) {
 
   m_notificationsCheck = new QCheckBox("Enable Desktop Notifications");
   m_notificationsCheck->setCursor(Qt::PointingHandCursor);
-  connect(m_notificationsCheck, &QCheckBox::checkStateChanged, this,
-          &MainWindow::saveSettings);
   notifLayout->addWidget(m_notificationsCheck);
 
   QLabel *notifDesc = new QLabel(
-      "Show system notifications when a new developer port starts listening.");
+      "Show a system notification when an alert fires. Alerts are also "
+      "written to the activity log.");
   notifDesc->setProperty("class", "settingsDesc");
   notifDesc->setWordWrap(true);
   notifLayout->addWidget(notifDesc);
 
   layout->addWidget(notifGroup);
 
-  // --- Group 3: System ---
+  // --- Group 2: Alerts ---
+  QFrame *alertGroup = new QFrame();
+  alertGroup->setProperty("class", "settingsGroup");
+  QVBoxLayout *alertLayout = new QVBoxLayout(alertGroup);
+
+  QLabel *alertHeader = new QLabel("Alerts");
+  alertHeader->setProperty("class", "settingsGroupHeader");
+  alertLayout->addWidget(alertHeader);
+
+  QFormLayout *alertForm = new QFormLayout();
+  m_backlogThresholdSpin = new QSpinBox();
+  m_backlogThresholdSpin->setRange(1, 100);
+  m_backlogThresholdSpin->setSuffix(" %");
+  alertForm->addRow("Backlog threshold:", m_backlogThresholdSpin);
+
+  m_backlogDurationSpin = new QSpinBox();
+  m_backlogDurationSpin->setRange(0, 3600);
+  m_backlogDurationSpin->setSuffix(" s");
+  alertForm->addRow("Sustained for:", m_backlogDurationSpin);
+
+  m_alertCommandEdit = new QLineEdit();
+  m_alertCommandEdit->setPlaceholderText("None");
+  alertForm->addRow("Alert command:", m_alertCommandEdit);
+  alertLayout->addLayout(alertForm);
+
+  QHBoxLayout *rulesLayout = new QHBoxLayout();
+  QPushButton *editRulesBtn = new QPushButton("Edit Rules");
+  connect(editRulesBtn, &QPushButton::clicked, this, [this]() {
+    const QString path = AlertEngine::defaultPath();
+    if (!QFile::exists(path))
+      AlertEngine::save(path, m_alertEngine->rules());
+    QDesktopServices::openUrl(QUrl::fromLocalFile(path));
+  });
+  QPushButton *reloadRulesBtn = new QPushButton("Reload Rules");
+  connect(reloadRulesBtn, &QPushButton::clicked, this, [this]() {
+    reloadAlertRules();
+    statusBar()->showMessage(
+        QString("%1 alert rules loaded").arg(m_alertEngine->rules().size()),
+        2000);
+  });
+  rulesLayout->addWidget(editRulesBtn);
+  rulesLayout->addWidget(reloadRulesBtn);
+  rulesLayout->addStretch();
+  alertLayout->addLayout(rulesLayout);
+
+  QLabel *alertDesc =
+      new QLabel("Notify when a dashboard port's accept queue stays above the "
+                 "threshold of its listen backlog for the given time. Other "
+                 "alerts (new listeners, ports down, sockets piling up in a "
+                 "state) are rules in alerts.json. The command runs for "
+                 "every alert and resolution, with the details in "
+                 "PORTMONITOR_ALERT_* environment variables.");
+  alertDesc->setProperty("class", "settingsDesc");
+  alertDesc->setWordWrap(true);
+  alertLayout->addWidget(alertDesc);
+
+  layout->addWidget(alertGroup);
+
+  // --- Group 3: Monitoring ---
+  QFrame *monitoringGroup = new QFrame();
+  monitoringGroup->setProperty("class", "settingsGroup");
+  QVBoxLayout *monitoringLayout = new QVBoxLayout(monitoringGroup);
+
+  QLabel *monitoringHeader = new QLabel("Monitoring");
+  monitoringHeader->setProperty("class", "settingsGroupHeader");
+  monitoringLayout->addWidget(monitoringHeader);
+
+  QFormLayout *monitoringForm = new QFormLayout();
+  m_samplingIntervalSpin = new QSpinBox();
+  m_samplingIntervalSpin->setRange(1, 60);
+  m_samplingIntervalSpin->setSuffix(" s");
+  monitoringForm->addRow("Resource sampling:", m_samplingIntervalSpin);
+
+  m_healthConcurrencySpin = new QSpinBox();
+  m_healthConcurrencySpin->setRange(1, 32);
+  monitoringForm->addRow("Parallel health checks:", m_healthConcurrencySpin);
+
+  m_metricsPortSpin = new QSpinBox();
+  m_metricsPortSpin->setRange(0, 65535);
+  m_metricsPortSpin->setSpecialValueText("Off");
+  monitoringForm->addRow("Metrics port:", m_metricsPortSpin);
+
+  m_agentPortSpin = new QSpinBox();
+  m_agentPortSpin->setRange(0, 65535);
+  m_agentPortSpin->setSpecialValueText("Off");
+  monitoringForm->addRow("Agent port:", m_agentPortSpin);
+
+  m_agentTokenEdit = new QLineEdit();
+  m_agentTokenEdit->setEchoMode(QLineEdit::Password);
+  m_agentTokenEdit->setPlaceholderText("None");
+  monitoringForm->addRow("Agent token:", m_agentTokenEdit);
+  monitoringLayout->addLayout(monitoringForm);
+
+  QLabel *monitoringDesc =
+      new QLabel("How often CPU, memory, open files and threads are read for "
+                 "the processes visible in the table and on the dashboard, "
+                 "and how many HTTP health checks may run at once. With a "
+                 "metrics port, Prometheus can scrape "
+                 "http://127.0.0.1:<port>/metrics. With an agent port, "
+                 "\"portmonitor-cli agent --collector <host>:<port>\" on "
+                 "other machines adds their sockets to the table. Without a "
+                 "token only agents on this machine or tunnelled to it can "
+                 "connect; with one, any host that can reach the port can "
+                 "try, and traffic is not encrypted.");
+  monitoringDesc->setProperty("class", "settingsDesc");
+  monitoringDesc->setWordWrap(true);
+  monitoringLayout->addWidget(monitoringDesc);
+
+  layout->addWidget(monitoringGroup);
+
+  // --- Group 4: System ---
   QFrame *systemGroup = new QFrame();
   systemGroup->setProperty("class", "settingsGroup");
   QVBoxLayout *systemLayout = new QVBoxLayout(systemGroup);
@@ -749,8 +1887,6 @@ void MainWindow::setupSettingsTab(QWidget *parent) {
 
   m_autoStartCheck = new QCheckBox("Launch on Startup");
   m_autoStartCheck->setCursor(Qt::PointingHandCursor);
-  connect(m_autoStartCheck, &QCheckBox::checkStateChanged, this,
-          &MainWindow::saveSettings);
   systemLayout->addWidget(m_autoStartCheck);
 
   QLabel *systemDesc = new QLabel(
@@ -759,6 +1895,17 @@ void MainWindow::setupSettingsTab(QWidget *parent) {
   systemDesc->setWordWrap(true);
   systemLayout->addWidget(systemDesc);
 
+  m_shareScansCheck = new QCheckBox("Share scans with local viewers");
+  m_shareScansCheck->setCursor(Qt::PointingHandCursor);
+  systemLayout->addWidget(m_shareScansCheck);
+
+  QLabel *shareDesc = new QLabel(
+      "Other sessions of yours can follow this window's scans with "
+      "\"portmonitor-cli watch --connect\" instead of scanning themselves.");
+  shareDesc->setProperty("class", "settingsDesc");
+  shareDesc->setWordWrap(true);
+  systemLayout->addWidget(shareDesc);
+
   layout->addWidget(systemGroup);
 
   // --- Footer ---
@@ -773,28 +1920,94 @@ void MainWindow::setupSettingsTab(QWidget *parent) {
   scrollArea->setWidget(scrollContent);
   mainLayout->addWidget(scrollArea);
 
-  if (auto castedParent = qobject_cast<QTabWidget *>(parent)) {
-    castedParent->addTab(settingsTab, "Settings");
-  }
-
-  loadSettings();
-}
-
-void MainWindow::loadSettings() {
-  QSettings settings("KadirMertAbatay", "PortMonitor");
-  m_notificationsCheck->setChecked(
-      settings.value("notifications", true).toBool());
-
+  m_notificationsCheck->setChecked(m_notificationsEnabled);
+  m_backlogThresholdSpin->setValue(m_backlogAlertPercent);
+  m_backlogDurationSpin->setValue(m_backlogAlertSeconds);
+  m_alertCommandEdit->setText(m_alertCommand);
+  m_samplingIntervalSpin->setValue(m_resourceSampler->interval() / 1000);
+  m_healthConcurrencySpin->setValue(m_healthChecker->maxConcurrent());
+  m_metricsPortSpin->setValue(m_metricsPort);
+  m_agentPortSpin->setValue(m_agentPort);
+  m_agentTokenEdit->setText(m_agentToken);
   // Check if plist exists for auto-start
   QString plistPath =
       QDir::homePath() +
       "/Library/LaunchAgents/com.kadirmertabatay.portmonitor.plist";
   m_autoStartCheck->setChecked(QFile::exists(plistPath));
+  m_shareScansCheck->setChecked(m_shareScans);
+
+  // Connected after loading so restoring values does not write them back
+  connect(m_notificationsCheck, &QCheckBox::checkStateChanged, this,
+          &MainWindow::saveSettings);
+  connect(m_autoStartCheck, &QCheckBox::checkStateChanged, this,
+          &MainWindow::saveSettings);
+  connect(m_shareScansCheck, &QCheckBox::checkStateChanged, this,
+          &MainWindow::saveSettings);
+  connect(m_backlogThresholdSpin, &QSpinBox::valueChanged, this,
+          &MainWindow::saveSettings);
+  connect(m_backlogDurationSpin, &QSpinBox::valueChanged, this,
+          &MainWindow::saveSettings);
+  connect(m_samplingIntervalSpin, &QSpinBox::valueChanged, this,
+          &MainWindow::saveSettings);
+  connect(m_healthConcurrencySpin, &QSpinBox::valueChanged, this,
+          &MainWindow::saveSettings);
+  // Applied when editing ends, not on every digit typed
+  connect(m_metricsPortSpin, &QSpinBox::editingFinished, this,
+          &MainWindow::saveSettings);
+  connect(m_agentPortSpin, &QSpinBox::editingFinished, this,
+          &MainWindow::saveSettings);
+  connect(m_agentTokenEdit, &QLineEdit::editingFinished, this,
+          &MainWindow::saveSettings);
+  connect(m_alertCommandEdit, &QLineEdit::editingFinished, this,
+          &MainWindow::saveSettings);
+  return settingsTab;
+}
+
+void MainWindow::loadSettings() {
+  // Applied to the components directly; the settings tab reads them back
+  // when it is built
+  QSettings settings("KadirMertAbatay", "PortMonitor");
+  m_notificationsEnabled = settings.value("notifications", true).toBool();
+  m_backlogAlertPercent = settings.value("backlogAlertPercent", 80).toInt();
+  m_backlogAlertSeconds = settings.value("backlogAlertSeconds", 10).toInt();
+  m_alertCommand = settings.value("alertCommand").toString();
+  m_alertEngine->setCommand(m_alertCommand);
+  reloadAlertRules();
+  m_resourceSampler->setInterval(
+      settings.value("resourceSampleSeconds", 2).toInt() * 1000);
+  m_healthChecker->setMaxConcurrent(
+      settings.value("healthCheckConcurrency", 4).toInt());
+  setShareScans(settings.value("shareScans", false).toBool());
+  setMetricsPort(settings.value("metricsPort", 0).toInt());
+  setAgentPort(settings.value("agentPort", 0).toInt(),
+               settings.value("agentToken").toString());
 }
 
 void MainWindow::saveSettings() {
+  if (!m_notificationsCheck)
+    return; // Settings tab not built; nothing can have changed
+
+  m_notificationsEnabled = m_notificationsCheck->isChecked();
+  m_backlogAlertPercent = m_backlogThresholdSpin->value();
+  m_backlogAlertSeconds = m_backlogDurationSpin->value();
   QSettings settings("KadirMertAbatay", "PortMonitor");
-  settings.setValue("notifications", m_notificationsCheck->isChecked());
+  settings.setValue("notifications", m_notificationsEnabled);
+  settings.setValue("backlogAlertPercent", m_backlogAlertPercent);
+  settings.setValue("backlogAlertSeconds", m_backlogAlertSeconds);
+  m_alertCommand = m_alertCommandEdit->text().trimmed();
+  settings.setValue("alertCommand", m_alertCommand);
+  m_alertEngine->setCommand(m_alertCommand);
+  settings.setValue("resourceSampleSeconds", m_samplingIntervalSpin->value());
+  m_resourceSampler->setInterval(m_samplingIntervalSpin->value() * 1000);
+  settings.setValue("healthCheckConcurrency", m_healthConcurrencySpin->value());
+  m_healthChecker->setMaxConcurrent(m_healthConcurrencySpin->value());
+  settings.setValue("shareScans", m_shareScansCheck->isChecked());
+  setShareScans(m_shareScansCheck->isChecked());
+  settings.setValue("metricsPort", m_metricsPortSpin->value());
+  setMetricsPort(m_metricsPortSpin->value());
+  settings.setValue("agentPort", m_agentPortSpin->value());
+  settings.setValue("agentToken", m_agentTokenEdit->text());
+  setAgentPort(m_agentPortSpin->value(), m_agentTokenEdit->text());
 
   // Auto-start logic
   QString plistPath =
@@ -880,35 +2093,50 @@ void MainWindow::filterActivityLog() {
 void MainWindow::updateTrayMenu() {
   if (!m_trayMenu)
     return;
-
-  m_trayMenu->clear();
-
-  // 1. Add Developer Ports Status
-  QAction *headerAction = m_trayMenu->addAction("ACTIVE PORTS");
-  headerAction->setEnabled(
-      false); // Functions as a visual header in native menus
-
-  bool anyActive = false;
-  for (const auto &tracked : m_trackedPorts) {
-    bool isActive = tracked.container->property("online").toBool();
-
-    if (isActive) {
-      anyActive = true;
-      // Use Unicode circle for reliable "green icon" visual
-      QString text = QString("🟢 %1 (%2)").arg(tracked.name).arg(tracked.port);
-      QAction *action = m_trayMenu->addAction(text);
-
-      // Still attempt to set a proper QIcon for consistency, using larger size
-      // for Retina
-      QPixmap pixmap(32, 32);
-      pixmap.fill(Qt::transparent);
-      QPainter painter(&pixmap);
-      painter.setRenderHint(QPainter::Antialiasing);
-      painter.setBrush(QColor("#2ecc71"));
-      painter.setPen(Qt::NoPen);
-      painter.drawEllipse(4, 4, 24, 24);
-      painter.end();
-      action->setIcon(QIcon(pixmap));
+  if (m_trayMenuOpen) {
+    m_trayMenuDirty = true;
+    return;
+  }
+  m_trayMenuDirty = false;
+  StageProfiler::Scope stage("updateTrayMenu");
+
+  QSet<int> active;
+  for (int i = 0; i < m_trackedPorts.size(); ++i) {
+    const PortStatus &tracked = m_trackedPorts[i];
+    bool isActive = tracked.online;
+    if (!isActive || active.contains(tracked.port))
+      continue;
+    active.insert(tracked.port);
+
+    // Use Unicode circle for reliable "green icon" visual; amber when the
+    // port is held but its HTTP health check fails
+    const bool checked = tracked.healthActive && tracked.health.port != 0;
+    const bool unhealthy = checked && !tracked.health.healthy;
+    QString text = QString("%1 %2 (%3)")
+                       .arg(unhealthy ? "🟠" : "🟢")
+                       .arg(tracked.name)
+                       .arg(tracked.port);
+    if (checked && tracked.health.status > 0)
+      text += QString(" · %1 · %2 ms")
+                  .arg(tracked.health.status)
+                  .arg(tracked.health.ttfbMs, 0, 'f', 0);
+    else if (checked)
+      text += " · " + tracked.health.error;
+
+    auto entry = m_trayEntries.find(tracked.port);
+    if (entry == m_trayEntries.end()) {
+      // Keep dashboard order: insert before the next tracked port's entry
+      QAction *before = m_traySeparator;
+      for (int j = i + 1; j < m_trackedPorts.size(); ++j) {
+        auto next = m_trayEntries.constFind(m_trackedPorts[j].port);
+        if (next != m_trayEntries.constEnd()) {
+          before = next->action;
+          break;
+        }
+      }
+      QAction *action = new QAction(text, m_trayMenu);
+      action->setIcon(unhealthy ? m_trayUnhealthyIcon : m_trayOnlineIcon);
+      m_trayMenu->insertAction(before, action);
 
       // Make clickable to open localhost
       int port = tracked.port;
@@ -916,17 +2144,29 @@ void MainWindow::updateTrayMenu() {
         QDesktopServices::openUrl(
             QUrl(QString("http://localhost:%1").arg(port)));
       });
+      m_trayEntries.insert(port, {action, unhealthy});
+      continue;
     }
-  }
 
-  if (!anyActive) {
-    QAction *empty = m_trayMenu->addAction("No active developer ports");
-    empty->setEnabled(false);
+    if (entry->action->text() != text)
+      entry->action->setText(text);
+    if (entry->unhealthy != unhealthy) {
+      entry->action->setIcon(unhealthy ? m_trayUnhealthyIcon
+                                       : m_trayOnlineIcon);
+      entry->unhealthy = unhealthy;
+    }
   }
 
-  m_trayMenu->addSeparator();
+  // Ports that went offline or are no longer tracked
+  for (auto it = m_trayEntries.begin(); it != m_trayEntries.end();) {
+    if (active.contains(it.key())) {
+      ++it;
+      continue;
+    }
+    m_trayMenu->removeAction(it->action);
+    delete it->action;
+    it = m_trayEntries.erase(it);
+  }
 
-  // 2. Standard Actions
-  m_trayMenu->addAction("Restore", this, &QWidget::showNormal);
-  m_trayMenu->addAction("Quit", qApp, &QApplication::quit);
+  m_trayEmptyAction->setVisible(m_trayEntries.isEmpty());
 }
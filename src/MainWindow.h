@@ -17,25 +17,35 @@
 #pragma once
 
 #include "FlowLayout.h"
+#include "HealthChecker.h"
+#include "AgentCollector.h"
+#include "AlertEngine.h"
+#include "MetricsExporter.h"
 #include "PortMonitor.h"
 #include "PortTableModel.h"
+#include "ProbeEngine.h"
+#include "ResourceSampler.h"
+#include "SnapshotServer.h"
 #include <QCheckBox>
 #include <QComboBox>
 #include <QDateTime>
 #include <QDialog>
 #include <QDialogButtonBox>
+#include <QElapsedTimer>
 #include <QFormLayout>
 #include <QGridLayout>
 #include <QLabel>
 #include <QLineEdit>
 #include <QMainWindow>
 #include <QPushButton>
+#include <QScrollArea>
 #include <QSpinBox>
 #include <QSystemTrayIcon>
 #include <QTabWidget>
 #include <QTableView>
 #include <QTableWidget>
 #include <QTimer>
+#include <functional>
 
 struct PortDef {
   int port;
@@ -47,11 +57,43 @@ struct PortStatus {
   int port;
   QString name;
   QString description;
-  QLabel *label;
-  QWidget *container;
-  QPushButton *openButton;
-  QPushButton *deleteButton;
-  bool isCustom;
+  bool isCustom = false;
+
+  // Card widgets; null while the card is off screen, since the dashboard
+  // only keeps cards near the screen (see createCard and releaseCard)
+  QWidget *container = nullptr;
+  QLabel *label = nullptr;
+  QLabel *metricsLabel = nullptr;
+  QLabel *latencyLabel = nullptr;
+  QLabel *healthLabel = nullptr;
+  QPushButton *openButton = nullptr;
+
+  // What the card should show, kept whether or not its widgets exist
+  bool online = false;
+  QString process;
+  QString metrics;
+
+  // Accept backlog alert state (see checkBacklogAlert)
+  QDateTime backlogHighSince;
+  bool backlogAlerted = false;
+
+  qint64 ownerPid = -1; // Process holding the port, -1 while offline
+
+  // What the card currently shows, so a refresh only touches cards whose
+  // state changed (see updateDashboard); -1 until first rendered
+  int shownOnline = -1;
+  QString shownProcess;
+  QString shownMetrics;
+
+  // Host the listener is reached on (empty while offline), and the connect
+  // latency probe (see ProbeEngine), empty unless probing is on for the card
+  QString probeHost;
+  QString probeKey;
+  ProbeStats probe; // Latest stats, empty target until the first result
+
+  // Last HTTP health check result, if a check is configured and running
+  bool healthActive = false;
+  HealthResult health;
 };
 
 class MainWindow : public QMainWindow {
@@ -61,8 +103,17 @@ public:
   explicit MainWindow(QWidget *parent = nullptr);
   ~MainWindow();
 
+  // Reports time to first paint and to the first scan result on stderr,
+  // measured on `clock` (started as the process begins)
+  void enableStartupTiming(const QElapsedTimer &clock);
+
+  // How long the last dashboard update took, for the benchmarks
+  qint64 dashboardUpdateUs() const { return m_dashboardUpdateUs; }
+
 protected:
+  bool event(QEvent *event) override;
   void closeEvent(QCloseEvent *event) override;
+  bool eventFilter(QObject *watched, QEvent *event) override;
 
 private slots:
   void onRefreshClicked();
@@ -70,15 +121,21 @@ private slots:
   void onFilterTextChanged(const QString &text);
   void onCustomContextMenuRequested(const QPoint &pos);
   void onKillProcessRequested();
+  void onProcessKilled(qint64 pid, bool success, const QString &message);
   void showProcessDetails();
   void onTrayIconActivated(QSystemTrayIcon::ActivationReason reason);
   void addLogEntry(const QString &event, const PortInfo &info);
+  void onAlert(const Alert &alert);
 
   // Settings Slots
   void saveSettings();
   void loadSettings();
   void saveCustomPorts();
   void loadCustomPorts();
+  void saveHealthChecks();
+  void loadHealthChecks();
+  void saveLatencyProbes();
+  void loadLatencyProbes();
 
   // Log Slots
   void filterActivityLog();
@@ -88,14 +145,46 @@ private slots:
 
 private:
   void setupUi();
-  void setupSettingsTab(QWidget *parent);
+  QWidget *createSettingsTab();
+  QWidget *createDiagnosticsTab();
+  void updateDiagnostics();
+  void toggleTrace();
+  void addLazyTab(const QString &title, std::function<QWidget *()> factory);
+  void buildLazyTab(int index);
+  void showSnapshot();
+  void saveSnapshot();
+  void setShareScans(bool enabled);
+  void setMetricsPort(int port);
+  void setAgentPort(int port, const QString &token);
+  void reloadAlertRules();
+  // Local scan plus agents' sockets: table, dashboard and status bar
+  void showPorts();
   void setupDashboard();
+  QWidget *createCard(int index);
+  void releaseCard(int index);
+  bool renderCard(PortStatus &tracked);
+  void renderLatency(PortStatus &tracked);
+  void renderHealth(PortStatus &tracked);
+  void fitDashboardHeight();
+  void updateDashboardViewport();
   void createTrayIcon();
   void updateTrayMenu();
   void updateDashboard(const QList<PortInfo> &ports);
+  void checkBacklogAlert(PortStatus &tracked, const PortInfo *listener);
+  void updateWatchedPids();
+  void applyGroupSpans();
+  void updateCardProbe(PortStatus &tracked, const PortInfo *listener);
+  void applyCardProbe(PortStatus &tracked);
+  void setLatencyProbe(int port, bool enabled);
+  void onProbeStats(const ProbeStats &stats);
+  void updateCardHealthCheck(PortStatus &tracked);
+  void onHealthResult(const HealthResult &result);
+  void configureHealthCheck(int port);
   bool isDarkTheme();
 
   QTabWidget *m_tabWidget;
+  // Tab pages whose content is only built when first shown
+  QHash<QWidget *, std::function<QWidget *()>> m_lazyTabs;
   QTableWidget *m_logTable;
 
   // Log Filter Widgets
@@ -104,19 +193,83 @@ private:
 
   QTableView *m_portTable;
   QLineEdit *m_searchBox;
+  QCheckBox *m_groupByUnitCheck;
   QPushButton *m_refreshBtn;
-  QSystemTrayIcon *m_trayIcon;
-  QMenu *m_trayMenu;
+  QSystemTrayIcon *m_trayIcon = nullptr;
+  QMenu *m_trayMenu = nullptr;
+
+  // Tray entries for online ports, kept across updates and only relabelled
+  // when they change (see updateTrayMenu)
+  struct TrayEntry {
+    QAction *action;
+    bool unhealthy;
+  };
+  QHash<int, TrayEntry> m_trayEntries;
+  QAction *m_trayEmptyAction = nullptr;
+  QAction *m_traySeparator = nullptr;
+  QIcon m_trayOnlineIcon;
+  QIcon m_trayUnhealthyIcon;
+  bool m_trayMenuOpen = false;
+  bool m_trayMenuDirty = false; // Changed while open; applied on close
   FlowLayout *m_dashboardLayout;
+  QScrollArea *m_dashboardScroll = nullptr;
   QList<PortStatus> m_trackedPorts;
 
   PortMonitor *m_portMonitor;
   PortTableModel *m_model;
   QTimer *m_refreshTimer;
-  QList<PortInfo> m_allPorts;
+  ResourceSampler *m_resourceSampler;
+  ProbeEngine *m_probeEngine;
+  HealthChecker *m_healthChecker;
+  SnapshotServer *m_snapshotServer; // Listening while scans are shared
+  MetricsExporter *m_metricsExporter; // Listening when a port is set
+  AgentCollector *m_agentCollector;   // Listening when an agent port is set
+  QTimer *m_agentUpdateTimer; // Coalesces agents' deltas into one showPorts
+  AlertEngine *m_alertEngine;
+  QHash<int, HealthCheck> m_healthChecks; // Configured checks by port
+  QSet<int> m_latencyProbes; // Ports whose cards probe connect latency
+  QTimer *m_watchedPidsTimer;
+  QList<PortInfo> m_localPorts; // This host's last scan
+  QList<PortInfo> m_allPorts;   // The same plus every agent's sockets
+  QString m_namespaceSummary; // " · N namespaces scanned in X ms"
+  qint64 m_dashboardUpdateUs = 0; // Duration of the last updateDashboard
+  int m_dashboardCardsTouched = 0;
+  QHash<qint64, QString> m_pendingKills; // PID -> process name
+  QStringList m_killFailures;             // Reported once the batch is done
   QList<PortDef> m_customPorts;
 
-  // Settings Widgets
-  QCheckBox *m_notificationsCheck;
-  QCheckBox *m_autoStartCheck;
+  // Last session's ports are shown until the first scan (see showSnapshot)
+  QDateTime m_snapshotTakenAt;
+  QElapsedTimer m_snapshotSaved;
+
+  QElapsedTimer m_startupClock; // Valid only in startup timing mode
+  bool m_firstPaintReported = false;
+  bool m_freshDataReported = false;
+
+  // Settings, applied whether or not the settings tab was built yet
+  bool m_notificationsEnabled = true;
+  int m_backlogAlertPercent = 80;
+  int m_backlogAlertSeconds = 10;
+  QString m_alertCommand; // Run for every alert; empty: none
+  bool m_shareScans = false;
+  int m_metricsPort = 0; // 0: off
+  int m_agentPort = 0;   // 0: off
+  QString m_agentToken;
+
+  // Settings Widgets; null until the settings tab is first shown
+  QCheckBox *m_notificationsCheck = nullptr;
+  QCheckBox *m_autoStartCheck = nullptr;
+  QCheckBox *m_shareScansCheck = nullptr;
+  QSpinBox *m_backlogThresholdSpin = nullptr;
+  QSpinBox *m_backlogDurationSpin = nullptr;
+  QSpinBox *m_samplingIntervalSpin = nullptr;
+  QSpinBox *m_healthConcurrencySpin = nullptr;
+  QSpinBox *m_metricsPortSpin = nullptr;
+  QSpinBox *m_agentPortSpin = nullptr;
+  QLineEdit *m_agentTokenEdit = nullptr;
+  QLineEdit *m_alertCommandEdit = nullptr;
+
+  // Diagnostics tab; null until first shown
+  QTableWidget *m_diagnosticsTable = nullptr;
+  QPushButton *m_traceButton = nullptr;
 };
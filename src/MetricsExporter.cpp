@@ -0,0 +1,215 @@
+/*
+ * Copyright 2025 Kadir Mert Abatay
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "MetricsExporter.h"
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTimer>
+
+// Scrapers send a short GET; anything longer is not one
+static const int kMaxRequestBytes = 8 * 1024;
+// Connections that send nothing useful are dropped after this
+static const int kIdleTimeoutMs = 10000;
+
+// Label values may contain quotes, backslashes and newlines
+static QByteArray label(const QString &value) {
+  QByteArray escaped = value.toUtf8();
+  escaped.replace('\\', "\\\\").replace('"', "\\\"").replace('\n', "\\n");
+  return escaped;
+}
+
+static void family(QByteArray &out, const char *name, const char *type,
+                   const char *help) {
+  out.append("# TYPE ").append(name).append(' ').append(type).append('\n');
+  out.append("# HELP ").append(name).append(' ').append(help).append('\n');
+}
+
+MetricsExporter::MetricsExporter(QObject *parent) : QObject(parent) {
+  m_server = new QTcpServer(this);
+  connect(m_server, &QTcpServer::newConnection, this,
+          &MetricsExporter::onNewConnection);
+  render();
+}
+
+bool MetricsExporter::listen(quint16 port) {
+  close();
+  return m_server->listen(QHostAddress::LocalHost, port);
+}
+
+void MetricsExporter::close() { m_server->close(); }
+
+bool MetricsExporter::isListening() const { return m_server->isListening(); }
+
+quint16 MetricsExporter::port() const { return m_server->serverPort(); }
+
+QString MetricsExporter::errorString() const {
+  return m_server->errorString();
+}
+
+void MetricsExporter::recordScan(const QList<PortInfo> &ports,
+                                 qint64 durationMs) {
+  m_scans++;
+  m_lastScanMs = durationMs;
+  m_lastScanAt = QDateTime::currentDateTimeUtc();
+
+  struct ProcessSockets {
+    QString name;
+    int count = 0;
+  };
+  for (auto it = m_listeners.begin(); it != m_listeners.end();) {
+    if (++it.value() > kDownScans)
+      it = m_listeners.erase(it);
+    else
+      ++it;
+  }
+  QMap<QPair<QString, QString>, int> byState;
+  QMap<qint64, ProcessSockets> byProcess;
+  for (const PortInfo &info : ports) {
+    if (info.state == "LISTEN")
+      m_listeners[{info.protocol, info.port}] = 0;
+    byState[{info.protocol, info.state}]++;
+    ProcessSockets &process = byProcess[info.pid.toLongLong()];
+    process.name = info.processName;
+    process.count++;
+  }
+
+  // Rows come sorted from the maps, so a series keeps its place between
+  // scrapes
+  QByteArray out;
+  out.reserve(64 * (m_listeners.size() + byState.size() + byProcess.size()));
+  family(out, "portmonitor_listener_up", "gauge",
+         "Whether something listens on the port (1) or no longer does (0).");
+  for (auto it = m_listeners.cbegin(); it != m_listeners.cend(); ++it) {
+    out.append("portmonitor_listener_up{protocol=\"")
+        .append(label(it.key().first))
+        .append("\",port=\"")
+        .append(QByteArray::number(it.key().second))
+        .append("\"} ")
+        .append(it.value() == 0 ? "1\n" : "0\n");
+  }
+  family(out, "portmonitor_sockets", "gauge",
+         "Sockets in the last scan by protocol and state.");
+  for (auto it = byState.cbegin(); it != byState.cend(); ++it) {
+    out.append("portmonitor_sockets{protocol=\"")
+        .append(label(it.key().first))
+        .append("\",state=\"")
+        .append(label(it.key().second))
+        .append("\"} ")
+        .append(QByteArray::number(it.value()))
+        .append('\n');
+  }
+  family(out, "portmonitor_process_sockets", "gauge",
+         "Sockets in the last scan per owning process.");
+  for (auto it = byProcess.cbegin(); it != byProcess.cend(); ++it) {
+    out.append("portmonitor_process_sockets{pid=\"")
+        .append(QByteArray::number(it.key()))
+        .append("\",process=\"")
+        .append(label(it->name))
+        .append("\"} ")
+        .append(QByteArray::number(it->count))
+        .append('\n');
+  }
+  m_scanSection = out;
+  render();
+}
+
+void MetricsExporter::recordScanError() {
+  m_scanErrors++;
+  render();
+}
+
+void MetricsExporter::render() {
+  QByteArray page = m_scanSection;
+  family(page, "portmonitor_scans", "counter", "Completed scans.");
+  page.append("portmonitor_scans_total ")
+      .append(QByteArray::number(m_scans))
+      .append('\n');
+  family(page, "portmonitor_scan_errors", "counter",
+         "Scans that failed, e.g. lsof could not run.");
+  page.append("portmonitor_scan_errors_total ")
+      .append(QByteArray::number(m_scanErrors))
+      .append('\n');
+  if (m_lastScanMs >= 0) {
+    family(page, "portmonitor_scan_duration_seconds", "gauge",
+           "Wall time of the last scan.");
+    page.append("portmonitor_scan_duration_seconds ")
+        .append(QByteArray::number(m_lastScanMs / 1000.0))
+        .append('\n');
+    family(page, "portmonitor_last_scan_timestamp_seconds", "gauge",
+           "When the last scan completed.");
+    page.append("portmonitor_last_scan_timestamp_seconds ")
+        .append(QByteArray::number(m_lastScanAt.toMSecsSinceEpoch() / 1000.0,
+                                   'f', 3))
+        .append('\n');
+  }
+  page.append("# EOF\n");
+  m_page = page;
+}
+
+void MetricsExporter::onNewConnection() {
+  while (QTcpSocket *socket = m_server->nextPendingConnection()) {
+    connect(socket, &QTcpSocket::readyRead, this,
+            [this, socket]() { onReadyRead(socket); });
+    connect(socket, &QTcpSocket::disconnected, socket,
+            &QObject::deleteLater);
+    QTimer::singleShot(kIdleTimeoutMs, socket, &QTcpSocket::abort);
+  }
+}
+
+void MetricsExporter::onReadyRead(QTcpSocket *socket) {
+  // The request is only looked at once its header is complete; the
+  // socket's own buffer holds it until then
+  const QByteArray request = socket->peek(kMaxRequestBytes);
+  const int headerEnd = request.indexOf("\r\n\r\n");
+  if (headerEnd < 0) {
+    if (request.size() >= kMaxRequestBytes)
+      socket->abort();
+    return;
+  }
+  socket->read(headerEnd + 4);
+
+  // "GET /metrics?... HTTP/1.1"
+  const QList<QByteArray> line =
+      request.left(request.indexOf("\r\n")).split(' ');
+  const QByteArray method = line.value(0);
+  const QByteArray path = line.value(1).split('?').value(0);
+
+  QByteArray status = "200 OK";
+  QByteArray type =
+      "application/openmetrics-text; version=1.0.0; charset=utf-8";
+  QByteArray body = m_page;
+  if (method != "GET" && method != "HEAD") {
+    status = "405 Method Not Allowed";
+    type = "text/plain";
+    body = "Only GET is supported\n";
+  } else if (path != "/metrics" && path != "/") {
+    status = "404 Not Found";
+    type = "text/plain";
+    body = "Metrics are at /metrics\n";
+  }
+
+  // One response per connection; the write is buffered, so a slow scraper
+  // never holds up the event loop
+  QByteArray response = "HTTP/1.1 " + status + "\r\nContent-Type: " + type +
+                        "\r\nContent-Length: " +
+                        QByteArray::number(body.size()) +
+                        "\r\nConnection: close\r\n\r\n";
+  if (method != "HEAD")
+    response += body;
+  socket->disconnect(this); // Anything sent after the request is ignored
+  socket->write(response);
+  socket->disconnectFromHost();
+}
@@ -0,0 +1,73 @@
+/*
+ * Copyright 2025 Kadir Mert Abatay
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "PortMonitor.h"
+#include <QByteArray>
+#include <QDateTime>
+#include <QHash>
+#include <QMap>
+#include <QObject>
+#include <QPair>
+
+class QTcpServer;
+class QTcpSocket;
+
+// Serves the scan results in the OpenMetrics text format on 127.0.0.1, for
+// Prometheus and compatible scrapers: listener up/down per port, sockets by
+// protocol and state, sockets per process, and the cost and failures of
+// scanning. Aggregates and the page are rebuilt once per scan; a scrape
+// only writes out the cached page and never triggers a scan.
+class MetricsExporter : public QObject {
+  Q_OBJECT
+
+public:
+  explicit MetricsExporter(QObject *parent = nullptr);
+
+  // Loopback only; 0 picks a free port
+  bool listen(quint16 port);
+  void close();
+  bool isListening() const;
+  quint16 port() const;
+  QString errorString() const;
+
+  void recordScan(const QList<PortInfo> &ports, qint64 durationMs);
+  void recordScanError();
+
+  // As served at /metrics
+  QByteArray page() const { return m_page; }
+
+private:
+  void render();
+  void onNewConnection();
+  void onReadyRead(QTcpSocket *socket);
+
+  QTcpServer *m_server;
+
+  // Protocol/port -> scans since it last listened (0: listening now). A
+  // closed listener is exported as down for kDownScans scans, then
+  // dropped, so ephemeral listeners do not pile up as series.
+  static const int kDownScans = 10;
+  QMap<QPair<QString, int>, int> m_listeners;
+  QByteArray m_scanSection; // Rendered by recordScan()
+  QByteArray m_page;
+
+  quint64 m_scans = 0;
+  quint64 m_scanErrors = 0;
+  qint64 m_lastScanMs = -1;
+  QDateTime m_lastScanAt;
+};
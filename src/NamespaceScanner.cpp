@@ -0,0 +1,237 @@
+/*
+ * Copyright 2025 Kadir Mert Abatay
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "NamespaceScanner.h"
+#include "CgroupResolver.h"
+#include "ProcessInfoCache.h"
+#include "SocketTable.h"
+#include "StageProfiler.h"
+#include <QElapsedTimer>
+#include <QFile>
+#include <QSet>
+#include <QThread>
+#include <QThreadPool>
+
+#ifdef Q_OS_LINUX
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <unistd.h>
+#endif
+
+#ifdef Q_OS_LINUX
+
+// Parses "net:[4026531840]" / "socket:[12345]" style link targets
+static quint64 linkInode(const char *path, const char *prefix) {
+  char target[64];
+  ssize_t len = readlink(path, target, sizeof(target) - 1);
+  if (len <= 0)
+    return 0;
+  target[len] = '\0';
+  const size_t prefixLen = strlen(prefix);
+  if (strncmp(target, prefix, prefixLen) != 0)
+    return 0;
+  return strtoull(target + prefixLen, nullptr, 10);
+}
+
+// Addresses as lsof prints them, so rows from both sources look alike
+static QString lsofAddress(const QString &address) {
+  if (address == "0.0.0.0" || address == "::")
+    return "*";
+  return address.contains(':') ? "[" + address + "]" : address;
+}
+
+static QString processName(qint64 pid) {
+  QFile file(QString("/proc/%1/comm").arg(pid));
+  if (!file.open(QIODevice::ReadOnly))
+    return QString::number(pid);
+  return QString::fromLocal8Bit(file.readAll()).trimmed();
+}
+
+#endif
+
+quint64 NamespaceScanner::namespaceOf(qint64 pid) {
+#ifdef Q_OS_LINUX
+  const QByteArray path = QString("/proc/%1/ns/net").arg(pid).toLatin1();
+  return linkInode(path.constData(), "net:[");
+#else
+  Q_UNUSED(pid);
+  return 0;
+#endif
+}
+
+QHash<quint64, QList<qint64>> NamespaceScanner::discover() {
+  QHash<quint64, QList<qint64>> namespaces;
+#ifdef Q_OS_LINUX
+  DIR *proc = opendir("/proc");
+  if (!proc)
+    return namespaces;
+  while (dirent *entry = readdir(proc)) {
+    char *end = nullptr;
+    const qint64 pid = strtoll(entry->d_name, &end, 10);
+    if (pid <= 0 || *end != '\0')
+      continue;
+    const quint64 inode = namespaceOf(pid);
+    if (inode != 0)
+      namespaces[inode].append(pid);
+  }
+  closedir(proc);
+#endif
+  return namespaces;
+}
+
+NamespaceScanResult NamespaceScanner::scan(quint64 skipInode,
+                                           int maxThreads) {
+  StageProfiler::Scope stage("namespaceScan");
+  NamespaceScanResult result;
+  QElapsedTimer timer;
+  timer.start();
+
+  const QHash<quint64, QList<qint64>> namespaces = discover();
+  QList<quint64> inodes;
+  for (auto it = namespaces.cbegin(); it != namespaces.cend(); ++it) {
+    if (it.key() != skipInode)
+      inodes.append(it.key());
+  }
+
+  // Namespaces are independent: one task each, every task fills its slot
+  QList<QList<PortInfo>> perNamespace(inodes.size());
+  QList<PortInfo> *slots = perNamespace.data();
+  QThreadPool pool;
+  pool.setMaxThreadCount(maxThreads > 0 ? maxThreads
+                                        : QThread::idealThreadCount());
+  for (int i = 0; i < inodes.size(); ++i) {
+    const quint64 inode = inodes[i];
+    const QList<qint64> pids = namespaces.value(inode);
+    pool.start([slots, i, inode, pids]() {
+      slots[i] = scanNamespace(inode, pids);
+    });
+  }
+  pool.waitForDone();
+
+  for (const QList<PortInfo> &ports : perNamespace)
+    result.ports += ports;
+  result.namespaces = inodes.size();
+  result.elapsedMs = timer.elapsed();
+  return result;
+}
+
+QList<PortInfo> NamespaceScanner::scanNamespace(quint64 inode,
+                                                const QList<qint64> &pids) {
+  QList<PortInfo> ports;
+#ifdef Q_OS_LINUX
+  // Every member sees the same tables through /proc/<pid>/net; take the
+  // first one that is still around
+  QList<KernelSocket> sockets;
+  qint64 reader = -1;
+  for (qint64 pid : pids) {
+    const QString base = QString("/proc/%1/net/").arg(pid);
+    if (!QFile::exists(base + "tcp"))
+      continue;
+    sockets = SocketTable::readProcNet(base + "tcp", "TCP") +
+              SocketTable::readProcNet(base + "tcp6", "TCP") +
+              SocketTable::readProcNet(base + "udp", "UDP") +
+              SocketTable::readProcNet(base + "udp6", "UDP");
+    reader = pid;
+    break;
+  }
+  if (reader < 0 || sockets.isEmpty())
+    return ports;
+
+  QSet<quint64> wanted;
+  QHash<int, int> synRecvByPort;
+  for (const KernelSocket &sock : sockets) {
+    if (sock.inode != 0)
+      wanted.insert(sock.inode);
+    if (sock.protocol == "TCP" && sock.state == SocketTable::SynRecv)
+      synRecvByPort[sock.localPort]++;
+  }
+
+  // Socket inode -> owning PID, from the fds of this namespace's processes
+  QHash<quint64, qint64> owners;
+  for (qint64 pid : pids) {
+    if (owners.size() == wanted.size())
+      break;
+    const QByteArray fdPath = QString("/proc/%1/fd").arg(pid).toLatin1();
+    DIR *dir = opendir(fdPath.constData());
+    if (!dir)
+      continue;
+    while (dirent *entry = readdir(dir)) {
+      if (entry->d_name[0] == '.')
+        continue;
+      const QByteArray link = fdPath + '/' + entry->d_name;
+      const quint64 socketInode = linkInode(link.constData(), "socket:[");
+      if (socketInode != 0 && wanted.contains(socketInode))
+        owners.insert(socketInode, pid);
+    }
+    closedir(dir);
+  }
+
+  // The namespace belongs to a container if its first process is in one
+  QString owner;
+  QFile cgroup(QString("/proc/%1/cgroup").arg(pids.first()));
+  if (cgroup.open(QIODevice::ReadOnly))
+    owner = CgroupResolver::parse(cgroup.readAll()).container;
+  if (owner.isEmpty()) {
+    const qint64 first = pids.first();
+    owner = QString("%1 (%2)").arg(processName(first)).arg(first);
+  }
+
+  QHash<qint64, QString> names;
+  for (const KernelSocket &sock : sockets) {
+    const qint64 pid = owners.value(sock.inode, -1);
+    if (pid < 0)
+      continue; // TIME_WAIT and other orphans have no owner to show
+
+    auto name = names.constFind(pid);
+    if (name == names.constEnd())
+      name = names.insert(pid, processName(pid));
+
+    PortInfo info;
+    info.protocol = sock.protocol;
+    info.localAddress = lsofAddress(sock.localAddress);
+    info.port = sock.localPort;
+    if (sock.remotePort != 0) {
+      info.remoteAddress = QString("%1:%2")
+                               .arg(lsofAddress(sock.remoteAddress))
+                               .arg(sock.remotePort);
+    }
+    if (sock.protocol == "TCP")
+      info.state = SocketTable::stateName(sock.state);
+    else
+      info.state = (sock.remotePort != 0) ? "ESTABLISHED" : "NONE";
+    info.pid = QString::number(pid);
+    info.processName = name.value();
+    info.user = ProcessInfoCache::userName(sock.uid);
+    info.netns = inode;
+    info.netnsOwner = owner;
+
+    if (info.state == "LISTEN") {
+      info.acceptQueue = int(sock.rxQueue);
+      info.synRecv = synRecvByPort.value(sock.localPort);
+    } else {
+      info.rxQueue = sock.rxQueue;
+      info.txQueue = sock.txQueue;
+      info.drops = sock.drops;
+    }
+    ports.append(info);
+  }
+#else
+  Q_UNUSED(inode);
+  Q_UNUSED(pids);
+#endif
+  return ports;
+}
@@ -0,0 +1,48 @@
+/*
+ * Copyright 2025 Kadir Mert Abatay
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "PortMonitor.h"
+#include <QHash>
+#include <QList>
+
+struct NamespaceScanResult {
+  QList<PortInfo> ports; // Sockets of every namespace but the skipped one
+  int namespaces = 0;    // Namespaces scanned
+  qint64 elapsedMs = 0;  // Discovery plus all scans, wall clock
+};
+
+// Finds the network namespaces in use (distinct /proc/<pid>/ns/net inodes)
+// and reads each one's socket table once, through /proc/<pid>/net/* of any
+// member process, on a thread pool. Sockets are attributed to processes by
+// walking the fds of that namespace's processes only. Linux only; without
+// root just the caller's own processes' namespaces are visible.
+class NamespaceScanner {
+public:
+  // Network namespace inode of a process, 0 when it cannot be read
+  static quint64 namespaceOf(qint64 pid);
+
+  // Namespace inode -> member PIDs
+  static QHash<quint64, QList<qint64>> discover();
+
+  // Scans every namespace except `skipInode` (the one lsof already covers)
+  // with up to `maxThreads` namespaces in flight (0: one per core)
+  static NamespaceScanResult scan(quint64 skipInode, int maxThreads = 0);
+
+  static QList<PortInfo> scanNamespace(quint64 inode,
+                                       const QList<qint64> &pids);
+};
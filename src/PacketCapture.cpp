@@ -0,0 +1,438 @@
+/*
+ * Copyright 2025 Kadir Mert Abatay
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "PacketCapture.h"
+#include <QElapsedTimer>
+#include <QHash>
+#include <algorithm>
+#include <cstring>
+
+#ifdef Q_OS_LINUX
+#include <arpa/inet.h>
+#include <cerrno>
+#include <ctime>
+#include <linux/filter.h>
+#include <linux/if_ether.h>
+#include <linux/if_packet.h>
+#include <net/if.h>
+#include <net/if_arp.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+PacketCapture::PacketCapture(QObject *parent) : QThread(parent) {
+  qRegisterMetaType<PacketCaptureStats>();
+}
+
+PacketCapture::~PacketCapture() { stop(); }
+
+void PacketCapture::stop() {
+  requestInterruption();
+  wait();
+}
+
+bool PacketCapture::isSupported() {
+#ifdef Q_OS_LINUX
+  return true;
+#else
+  return false;
+#endif
+}
+
+#ifdef Q_OS_LINUX
+
+namespace {
+
+// Ring geometry: 8 x 1 MiB blocks, retired after 50 ms even if not full so
+// quiet ports still report promptly.
+const unsigned kBlockSize = 1 << 20;
+const unsigned kBlockCount = 8;
+const unsigned kFrameSize = 2048;
+const unsigned kBlockTimeoutMs = 50;
+const int kReportIntervalMs = 1000;
+const int kMaxTrackedConnections = 65536;
+// Closed flows stay through TIME_WAIT so late ACKs and retransmits do not
+// bring them back; flows with no packets for kIdleNs are dropped
+const qint64 kClosedLingerNs = 60 * 1000000000LL;
+const qint64 kIdleNs = 300 * 1000000000LL;
+const int kTopConnections = 5;
+
+struct FlowKey {
+  quint8 addr[16];
+  quint16 port;
+  bool v6;
+
+  bool operator==(const FlowKey &other) const {
+    return port == other.port && v6 == other.v6 &&
+           std::memcmp(addr, other.addr, sizeof(addr)) == 0;
+  }
+};
+
+size_t qHash(const FlowKey &key, size_t seed = 0) {
+  return qHashBits(key.addr, key.v6 ? 16 : 4, seed) ^ key.port;
+}
+
+struct FlowState {
+  qint64 synTimeNs = 0;
+  qint64 lastSeenNs = 0;
+  quint64 bytesIn = 0;
+  quint64 bytesOut = 0;
+  bool closed = false;
+};
+
+// Only Ethernet and loopback devices carry the 14-byte Ethernet header the
+// rest of the filter and the parser assume; tun, WireGuard and other raw IP
+// links are skipped
+bool hasEthernetHeader(unsigned short hatype) {
+  return hatype == ARPHRD_ETHER || hatype == ARPHRD_LOOPBACK;
+}
+
+// Equivalent of `tcpdump -dd "tcp port N"` for Ethernet framing, which is
+// also what AF_PACKET presents on loopback, behind a link type check.
+QList<sock_filter> tcpPortFilter(quint16 port) {
+  return {
+      {0x20, 0, 0, quint32(SKF_AD_OFF + SKF_AD_HATYPE)}, // ld hatype
+      {0x15, 1, 0, ARPHRD_ETHER},               // jeq #ARPHRD_ETHER
+      {0x15, 0, 19, ARPHRD_LOOPBACK},           // jeq #ARPHRD_LOOPBACK : reject
+      {0x28, 0, 0, 0x0000000c},  // ldh [12]            ; ethertype
+      {0x15, 0, 6, 0x000086dd},  // jeq #ETH_P_IPV6
+      {0x30, 0, 0, 0x00000014},  // ldb [20]            ; ip6 next header
+      {0x15, 0, 15, 0x00000006}, // jeq #IPPROTO_TCP
+      {0x28, 0, 0, 0x00000036},  // ldh [54]            ; tcp sport
+      {0x15, 12, 0, port},       // jeq #port -> accept
+      {0x28, 0, 0, 0x00000038},  // ldh [56]            ; tcp dport
+      {0x15, 10, 11, port},      // jeq #port -> accept : reject
+      {0x15, 0, 10, 0x00000800}, // jeq #ETH_P_IP
+      {0x30, 0, 0, 0x00000017},  // ldb [23]            ; ip protocol
+      {0x15, 0, 8, 0x00000006},  // jeq #IPPROTO_TCP
+      {0x28, 0, 0, 0x00000014},  // ldh [20]            ; ip frag offset
+      {0x45, 6, 0, 0x00001fff},  // jset #0x1fff -> reject
+      {0xb1, 0, 0, 0x0000000e},  // ldxb 4*([14]&0xf)   ; ip header length
+      {0x48, 0, 0, 0x0000000e},  // ldh [x + 14]        ; tcp sport
+      {0x15, 2, 0, port},        // jeq #port -> accept
+      {0x48, 0, 0, 0x00000010},  // ldh [x + 16]        ; tcp dport
+      {0x15, 0, 1, port},        // jeq #port -> accept : reject
+      {0x06, 0, 0, 0x00040000},  // ret #262144         ; accept
+      {0x06, 0, 0, 0x00000000},  // ret #0              ; reject
+  };
+}
+
+class CaptureSession {
+public:
+  explicit CaptureSession(quint16 port) : m_port(port) {}
+
+  void processFrame(const tpacket3_hdr *hdr, int loopbackIndex) {
+    const auto *base = reinterpret_cast<const quint8 *>(hdr);
+    const auto *sll = reinterpret_cast<const sockaddr_ll *>(
+        base + TPACKET_ALIGN(sizeof(tpacket3_hdr)));
+
+    if (!hasEthernetHeader(sll->sll_hatype))
+      return;
+    // Loopback delivers every packet twice (outgoing + host); count it once
+    if (sll->sll_ifindex == loopbackIndex &&
+        sll->sll_pkttype == PACKET_OUTGOING)
+      return;
+
+    const quint8 *frame = base + hdr->tp_mac;
+    const quint32 caplen = hdr->tp_snaplen;
+    if (caplen < ETH_HLEN)
+      return;
+
+    const quint16 ethType = (frame[12] << 8) | frame[13];
+    const quint8 *ip = frame + ETH_HLEN;
+    const quint32 ipLen = caplen - ETH_HLEN;
+
+    const quint8 *srcAddr = nullptr;
+    const quint8 *dstAddr = nullptr;
+    const quint8 *tcp = nullptr;
+    quint32 segmentLen = 0; // TCP header + payload, from the IP header
+    bool v6 = false;
+
+    if (ethType == ETH_P_IP) {
+      if (ipLen < 20)
+        return;
+      const quint32 ihl = (ip[0] & 0x0f) * 4;
+      const quint32 totalLen = (ip[2] << 8) | ip[3];
+      if (ihl < 20 || ipLen < ihl + 20 || totalLen < ihl)
+        return;
+      srcAddr = ip + 12;
+      dstAddr = ip + 16;
+      tcp = ip + ihl;
+      segmentLen = totalLen - ihl;
+    } else if (ethType == ETH_P_IPV6) {
+      if (ipLen < 40 + 20)
+        return;
+      srcAddr = ip + 8;
+      dstAddr = ip + 24;
+      tcp = ip + 40;
+      segmentLen = (ip[4] << 8) | ip[5];
+      v6 = true;
+    } else {
+      return;
+    }
+
+    const quint16 srcPort = (tcp[0] << 8) | tcp[1];
+    const quint16 dstPort = (tcp[2] << 8) | tcp[3];
+    const quint32 doff = (tcp[12] >> 4) * 4;
+    const quint8 flags = tcp[13];
+    const quint32 payload = segmentLen > doff ? segmentLen - doff : 0;
+
+    // The client is whichever side is not bound to the watched port
+    const bool toServer = (dstPort == m_port);
+    FlowKey key;
+    std::memset(&key, 0, sizeof(key));
+    std::memcpy(key.addr, toServer ? srcAddr : dstAddr, v6 ? 16 : 4);
+    key.port = toServer ? srcPort : dstPort;
+    key.v6 = v6;
+
+    const qint64 tsNs = qint64(hdr->tp_sec) * 1000000000LL + hdr->tp_nsec;
+    const bool syn = flags & 0x02;
+    const bool ack = flags & 0x10;
+
+    ++m_stats.packets;
+    m_stats.bytes += payload;
+    const bool fin = flags & 0x01;
+    const bool rst = flags & 0x04;
+    // Totals count every packet, tracked or not
+    if (syn && !ack)
+      ++m_stats.syn;
+    else if (syn && ack)
+      ++m_stats.synAck;
+    if (fin)
+      ++m_stats.fin;
+    if (rst)
+      ++m_stats.rst;
+
+    auto it = m_flows.find(key);
+    if (it == m_flows.end()) {
+      if (m_flows.size() >= kMaxTrackedConnections)
+        return; // Table full: no per-flow state for newcomers
+      it = m_flows.insert(key, FlowState());
+    }
+    FlowState &flow = it.value();
+    flow.lastSeenNs = tsNs;
+
+    if (toServer)
+      flow.bytesIn += payload;
+    else
+      flow.bytesOut += payload;
+
+    if (syn && !ack) {
+      flow.synTimeNs = tsNs;
+      flow.closed = false;
+    } else if (syn && ack && flow.synTimeNs > 0) {
+      double ms = (tsNs - flow.synTimeNs) / 1e6;
+      ++m_stats.handshakes;
+      m_handshakeTotalMs += ms;
+      m_stats.maxHandshakeMs = qMax(m_stats.maxHandshakeMs, ms);
+      flow.synTimeNs = 0;
+    }
+    if (fin || rst)
+      flow.closed = true;
+  }
+
+  void addRingDrops(quint64 drops) { m_stats.ringDrops += drops; }
+
+  // `nowNs` is on the packet timestamp clock (CLOCK_REALTIME)
+  PacketCaptureStats takeReport(qint64 nowNs) {
+    // Closed flows leave after their linger period, silent ones when idle
+    for (auto it = m_flows.begin(); it != m_flows.end();) {
+      const qint64 quietNs = nowNs - it->lastSeenNs;
+      if (quietNs >= (it->closed ? kClosedLingerNs : kIdleNs))
+        it = m_flows.erase(it);
+      else
+        ++it;
+    }
+
+    PacketCaptureStats report = m_stats;
+    report.avgHandshakeMs =
+        m_stats.handshakes ? m_handshakeTotalMs / m_stats.handshakes : 0.0;
+
+    QList<QPair<quint64, FlowKey>> ranked;
+    ranked.reserve(m_flows.size());
+    int active = 0;
+    for (auto it = m_flows.cbegin(); it != m_flows.cend(); ++it) {
+      if (!it->closed)
+        ++active;
+      ranked.append({it->bytesIn + it->bytesOut, it.key()});
+    }
+    report.activeConnections = active;
+
+    const int top = qMin<int>(kTopConnections, ranked.size());
+    std::partial_sort(ranked.begin(), ranked.begin() + top, ranked.end(),
+                      [](const auto &a, const auto &b) {
+                        return a.first > b.first;
+                      });
+    for (int i = 0; i < top; ++i) {
+      const FlowKey &key = ranked[i].second;
+      const FlowState &flow = m_flows[key];
+      char addr[INET6_ADDRSTRLEN] = {};
+      inet_ntop(key.v6 ? AF_INET6 : AF_INET, key.addr, addr, sizeof(addr));
+      PacketConnectionStats conn;
+      conn.client = key.v6 ? QString("[%1]:%2").arg(addr).arg(key.port)
+                           : QString("%1:%2").arg(addr).arg(key.port);
+      conn.bytesIn = flow.bytesIn;
+      conn.bytesOut = flow.bytesOut;
+      report.topConnections.append(conn);
+    }
+    return report;
+  }
+
+private:
+  quint16 m_port;
+  PacketCaptureStats m_stats;
+  double m_handshakeTotalMs = 0;
+  QHash<FlowKey, FlowState> m_flows;
+};
+
+} // namespace
+
+void PacketCapture::run() {
+  if (m_targetPort <= 0 || m_targetPort > 65535) {
+    emit captureError("Invalid port number");
+    return;
+  }
+
+  // Protocol 0 receives nothing until bind(), so no unfiltered frames can
+  // sneak into the ring before the BPF program is attached.
+  int fd = socket(AF_PACKET, SOCK_RAW, 0);
+  if (fd < 0) {
+    if (errno == EPERM || errno == EACCES) {
+      emit captureError("Packet capture requires CAP_NET_RAW (run as root or "
+                        "grant the capability with setcap)");
+    } else {
+      emit captureError(QString("AF_PACKET socket failed: %1")
+                            .arg(QString::fromLocal8Bit(strerror(errno))));
+    }
+    return;
+  }
+
+  auto fail = [this, fd](const QString &what) {
+    emit captureError(QString("%1 failed: %2")
+                          .arg(what)
+                          .arg(QString::fromLocal8Bit(strerror(errno))));
+    close(fd);
+  };
+
+  int version = TPACKET_V3;
+  if (setsockopt(fd, SOL_PACKET, PACKET_VERSION, &version, sizeof(version)) <
+      0) {
+    fail("PACKET_VERSION");
+    return;
+  }
+
+  QList<sock_filter> code = tcpPortFilter(quint16(m_targetPort));
+  sock_fprog program;
+  program.len = static_cast<unsigned short>(code.size());
+  program.filter = code.data();
+  if (setsockopt(fd, SOL_SOCKET, SO_ATTACH_FILTER, &program, sizeof(program)) <
+      0) {
+    fail("SO_ATTACH_FILTER");
+    return;
+  }
+
+  tpacket_req3 req;
+  std::memset(&req, 0, sizeof(req));
+  req.tp_block_size = kBlockSize;
+  req.tp_block_nr = kBlockCount;
+  req.tp_frame_size = kFrameSize;
+  req.tp_frame_nr = (kBlockSize * kBlockCount) / kFrameSize;
+  req.tp_retire_blk_tov = kBlockTimeoutMs;
+  if (setsockopt(fd, SOL_PACKET, PACKET_RX_RING, &req, sizeof(req)) < 0) {
+    fail("PACKET_RX_RING");
+    return;
+  }
+
+  const size_t ringSize = size_t(kBlockSize) * kBlockCount;
+  void *ring =
+      mmap(nullptr, ringSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (ring == MAP_FAILED) {
+    fail("mmap");
+    return;
+  }
+
+  sockaddr_ll addr;
+  std::memset(&addr, 0, sizeof(addr));
+  addr.sll_family = AF_PACKET;
+  addr.sll_protocol = htons(ETH_P_ALL);
+  addr.sll_ifindex = 0; // All interfaces; the filter keeps Ethernet framing
+  if (bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0) {
+    munmap(ring, ringSize);
+    fail("bind");
+    return;
+  }
+
+  const int loopbackIndex = int(if_nametoindex("lo"));
+  auto *blocks = static_cast<quint8 *>(ring);
+  unsigned current = 0;
+  CaptureSession session(quint16(m_targetPort));
+  QElapsedTimer reportTimer;
+  reportTimer.start();
+
+  while (!isInterruptionRequested()) {
+    auto *block =
+        reinterpret_cast<tpacket_block_desc *>(blocks + current * kBlockSize);
+
+    if ((block->hdr.bh1.block_status & TP_STATUS_USER) == 0) {
+      pollfd pfd;
+      pfd.fd = fd;
+      pfd.events = POLLIN | POLLERR;
+      pfd.revents = 0;
+      poll(&pfd, 1, 100);
+    } else {
+      // Walk the retired block in place; nothing is copied out of the ring
+      const quint32 count = block->hdr.bh1.num_pkts;
+      auto *hdr = reinterpret_cast<const tpacket3_hdr *>(
+          reinterpret_cast<const quint8 *>(block) +
+          block->hdr.bh1.offset_to_first_pkt);
+      for (quint32 i = 0; i < count; ++i) {
+        session.processFrame(hdr, loopbackIndex);
+        hdr = reinterpret_cast<const tpacket3_hdr *>(
+            reinterpret_cast<const quint8 *>(hdr) + hdr->tp_next_offset);
+      }
+
+      __sync_synchronize();
+      block->hdr.bh1.block_status = TP_STATUS_KERNEL;
+      current = (current + 1) % kBlockCount;
+    }
+
+    if (reportTimer.elapsed() >= kReportIntervalMs) {
+      tpacket_stats_v3 kstats;
+      socklen_t len = sizeof(kstats);
+      if (getsockopt(fd, SOL_PACKET, PACKET_STATISTICS, &kstats, &len) == 0) {
+        session.addRingDrops(kstats.tp_drops); // Counters reset on read
+      }
+      timespec now;
+      clock_gettime(CLOCK_REALTIME, &now);
+      emit statsUpdated(
+          session.takeReport(qint64(now.tv_sec) * 1000000000LL + now.tv_nsec));
+      reportTimer.restart();
+    }
+  }
+
+  munmap(ring, ringSize);
+  close(fd);
+}
+
+#else
+
+void PacketCapture::run() {
+  emit captureError("Packet capture is only available on Linux");
+}
+
+#endif
@@ -0,0 +1,73 @@
+/*
+ * Copyright 2025 Kadir Mert Abatay
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <QList>
+#include <QMetaType>
+#include <QString>
+#include <QThread>
+
+struct PacketConnectionStats {
+  QString client; // "address:port" of the side not bound to the target port
+  quint64 bytesIn = 0;  // Payload sent to the target port
+  quint64 bytesOut = 0; // Payload sent from the target port
+};
+
+// Cumulative counters since the capture started
+struct PacketCaptureStats {
+  quint64 packets = 0;
+  quint64 bytes = 0; // TCP payload bytes, both directions
+  quint64 syn = 0;
+  quint64 synAck = 0;
+  quint64 fin = 0;
+  quint64 rst = 0;
+  quint64 ringDrops = 0; // Frames the kernel dropped because the ring was full
+  int activeConnections = 0;
+  quint64 handshakes = 0; // SYN -> SYN/ACK pairs seen
+  double avgHandshakeMs = 0;
+  double maxHandshakeMs = 0;
+  QList<PacketConnectionStats> topConnections; // By total bytes, descending
+};
+
+Q_DECLARE_METATYPE(PacketCaptureStats)
+
+// Packet-level capture of a single TCP port using an AF_PACKET TPACKET_V3
+// memory-mapped ring with a kernel BPF filter. Frames are parsed in place in
+// the ring on a dedicated thread; aggregated counters are published through
+// statsUpdated() about once per second. Requires CAP_NET_RAW and Linux.
+class PacketCapture : public QThread {
+  Q_OBJECT
+
+public:
+  explicit PacketCapture(QObject *parent = nullptr);
+  ~PacketCapture() override;
+
+  void setTargetPort(int port) { m_targetPort = port; }
+  void stop();
+
+  static bool isSupported();
+
+signals:
+  void statsUpdated(const PacketCaptureStats &stats);
+  void captureError(const QString &msg);
+
+protected:
+  void run() override;
+
+private:
+  int m_targetPort = 0;
+};
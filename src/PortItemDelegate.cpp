@@ -0,0 +1,78 @@
+/*
+ * Copyright 2025 Kadir Mert Abatay
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "PortItemDelegate.h"
+#include <QPainter>
+
+// Horizontal padding on each side of the text
+static const int kPadding = 6;
+
+PortItemDelegate::PortItemDelegate(QObject *parent)
+    : QStyledItemDelegate(parent) {}
+
+void PortItemDelegate::paint(QPainter *painter,
+                             const QStyleOptionViewItem &option,
+                             const QModelIndex &index) const {
+  const bool selected = option.state & QStyle::State_Selected;
+  const QVariant background = index.data(Qt::BackgroundRole);
+  if (selected)
+    painter->fillRect(option.rect, option.palette.highlight());
+  else if (background.isValid())
+    painter->fillRect(option.rect, background.value<QBrush>());
+  else if (option.features & QStyleOptionViewItem::Alternate)
+    painter->fillRect(option.rect, option.palette.alternateBase());
+
+  const QString text = index.data(Qt::DisplayRole).toString();
+  if (text.isEmpty())
+    return;
+
+  const QVariant foreground = index.data(Qt::ForegroundRole);
+  const QVariant font = index.data(Qt::FontRole);
+  const int alignment = index.data(Qt::TextAlignmentRole).toInt();
+
+  // Font and pen are set for every cell, so no save()/restore() (which
+  // allocates a state each time) is needed
+  if (font.isValid())
+    painter->setFont(font.value<QFont>());
+  else
+    painter->setFont(option.font);
+  if (selected)
+    painter->setPen(option.palette.color(QPalette::HighlightedText));
+  else if (foreground.isValid())
+    painter->setPen(foreground.value<QBrush>().color());
+  else
+    painter->setPen(option.palette.color(QPalette::Text));
+
+  const QRect rect = option.rect.adjusted(kPadding, 0, -kPadding, 0);
+  const QFontMetrics metrics = painter->fontMetrics();
+  // Most cells fit; only eliding needs a new string
+  if (metrics.horizontalAdvance(text) <= rect.width()) {
+    painter->drawText(rect, alignment | Qt::TextSingleLine, text);
+  } else {
+    painter->drawText(rect, alignment | Qt::TextSingleLine,
+                      metrics.elidedText(text, Qt::ElideRight, rect.width()));
+  }
+}
+
+QSize PortItemDelegate::sizeHint(const QStyleOptionViewItem &option,
+                                 const QModelIndex &index) const {
+  const QVariant font = index.data(Qt::FontRole);
+  const QFontMetrics metrics(font.isValid() ? font.value<QFont>()
+                                            : option.font);
+  const QString text = index.data(Qt::DisplayRole).toString();
+  return QSize(metrics.horizontalAdvance(text) + 2 * kPadding,
+               metrics.height() + kPadding);
+}
@@ -15,57 +15,32 @@
  */
 
 #include "PortMonitor.h"
-#include <QDebug>
+#include "NamespaceScanner.h"
+#include "ProcessInfoCache.h"
+#include "ProcessTerminator.h"
+#include "SocketTable.h"
+#include "StageProfiler.h"
+#include <QCoreApplication>
+#include <QHash>
 #include <QProcess>
+#include <QPromise>
 #include <QRegularExpression>
+#include <QThreadPool>
+#include <algorithm>
+#include <memory>
 
-PortMonitor::PortMonitor(QObject *parent) : QObject(parent) {}
+// Samples of per-process queued bytes kept to detect steady growth
+static const int kQueueHistoryLength = 3;
 
-void PortMonitor::refresh() {
-  QProcess *process = new QProcess(this);
-  connect(process,
-          QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
-          [this, process](int exitCode, QProcess::ExitStatus exitStatus) {
-            if (exitStatus == QProcess::NormalExit && exitCode == 0) {
-              parseLsofOutput(process->readAllStandardOutput());
-            } else {
-              emit errorOccurred(process->readAllStandardError());
-            }
-            process->deleteLater();
-          });
-
-  // Command to list Internet files, no host names, no service names
-  process->start("lsof", QStringList() << "-i" << "-P" << "-n");
+static QString connectionKey(int localPort, QString remoteHost,
+                             int remotePort) {
+  if (remoteHost.startsWith('[') && remoteHost.endsWith(']'))
+    remoteHost = remoteHost.mid(1, remoteHost.size() - 2);
+  return QString("%1|%2|%3").arg(localPort).arg(remoteHost).arg(remotePort);
 }
 
-void PortMonitor::killProcess(qint64 pid) {
-  qDebug() << "Attempting to kill process:" << pid;
-  QString program = "kill";
-  QStringList arguments;
-  arguments << "-9" << QString::number(pid);
-
-  QProcess *process = new QProcess(this);
-  connect(
-      process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
-      [this, pid, process](int exitCode, QProcess::ExitStatus exitStatus) {
-        bool success = (exitStatus == QProcess::NormalExit && exitCode == 0);
-        QString message =
-            success ? "Process killed successfully"
-                    : QString::fromUtf8(process->readAllStandardError());
-        emit processKilled(pid, success, message);
-        process->deleteLater();
-        // Trigger a refresh after killing
-        if (success) {
-          refresh();
-        }
-      });
-  process->start(program, arguments);
-}
-
-void PortMonitor::parseLsofOutput(const QByteArray &output) {
+QList<PortInfo> PortMonitor::parseLsof(const QByteArray &output) {
   QList<PortInfo> ports;
-  QMap<QString, PortInfo> currentPorts;
-
   QString data = QString::fromUtf8(output);
   QStringList lines = data.split('\n', Qt::SkipEmptyParts);
 
@@ -114,6 +89,7 @@ void PortMonitor::parseLsofOutput(const QByteArray &output) {
     QString localSegment = nameField;
     if (nameField.contains("->")) {
       localSegment = nameField.split("->").first();
+      info.remoteAddress = nameField.section("->", 1);
       if (info.state == "NONE")
         info.state = "ESTABLISHED";
     }
@@ -125,26 +101,441 @@ void PortMonitor::parseLsofOutput(const QByteArray &output) {
         (lastColon != -1) ? localSegment.left(lastColon) : localSegment;
 
     ports.append(info);
+  }
+  return ports;
+}
+
+PortMonitor::PortMonitor(QObject *parent) : QObject(parent) {
+  m_clock.start();
+  m_hostNamespace =
+      NamespaceScanner::namespaceOf(QCoreApplication::applicationPid());
+
+  m_namespaceWatcher = new QFutureWatcher<NamespaceScanResult>(this);
+  connect(m_namespaceWatcher, &QFutureWatcherBase::finished, this, [this]() {
+    onNamespacesScanned(m_namespaceWatcher->result());
+  });
 
-    // Track unique listeners
-    if (info.state == "LISTEN") {
-      QString key = QString("%1:%2").arg(info.protocol).arg(info.port);
-      currentPorts.insert(key, info);
+  m_terminator = new ProcessTerminator(this);
+  connect(m_terminator, &ProcessTerminator::finished, this,
+          &PortMonitor::onProcessFinished);
 
-      // Check if new
-      if (!m_knownPorts.contains(key)) {
-        emit newPortDetected(info);
-      }
+  // Exits that land together (a bulk kill) share one rescan
+  m_rescanTimer = new QTimer(this);
+  m_rescanTimer->setSingleShot(true);
+  m_rescanTimer->setInterval(50);
+  connect(m_rescanTimer, &QTimer::timeout, this, &PortMonitor::rescanExited);
+}
+
+void PortMonitor::refresh() {
+  StageProfiler *profiler = StageProfiler::instance();
+  const qint64 startNs = profiler->now();
+  QProcess *process = new QProcess(this);
+  connect(process,
+          QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
+          [this, process, profiler, startNs](int exitCode,
+                                             QProcess::ExitStatus exitStatus) {
+            profiler->record("lsof", startNs, profiler->now(), true);
+            if (exitStatus == QProcess::NormalExit && exitCode == 0) {
+              parseLsofOutput(process->readAllStandardOutput(), startNs);
+            } else {
+              emit errorOccurred(process->readAllStandardError());
+            }
+            process->deleteLater();
+          });
+  // finished() never comes for a command that could not be started
+  connect(process, &QProcess::errorOccurred, this,
+          [this, process](QProcess::ProcessError error) {
+            if (error != QProcess::FailedToStart)
+              return;
+            emit errorOccurred("Could not run lsof: " +
+                               process->errorString());
+            process->deleteLater();
+          });
+
+  // Command to list Internet files, no host names, no service names
+  process->start("lsof", QStringList() << "-i" << "-P" << "-n");
+}
+
+void PortMonitor::killProcess(qint64 pid, bool graceful) {
+  // The start time recorded with the socket guards against PID reuse
+  quint64 startTime = 0;
+  for (const PortInfo &info : m_lastPorts) {
+    if (info.pid.toLongLong() == pid) {
+      startTime = info.startTime;
+      break;
     }
   }
+  m_terminator->terminate(pid, startTime, graceful);
+}
+
+void PortMonitor::setGracePeriod(int ms) { m_terminator->setGracePeriod(ms); }
+
+void PortMonitor::onProcessFinished(qint64 pid, bool success,
+                                    const QString &message) {
+  if (success) {
+    m_exitedPids.insert(pid);
+    m_rescanTimer->start();
+  }
+  emit processKilled(pid, success, message);
+}
+
+void PortMonitor::rescanExited() {
+  const QSet<qint64> pids = m_exitedPids;
+  m_exitedPids.clear();
+
+  // Only the host ports the processes held need a fresh look; the rest of
+  // the snapshot stays as it is until the next full scan
+  QSet<int> ports;
+  for (const PortInfo &info : m_lastPorts) {
+    const bool host = info.netnsOwner.isEmpty() || info.netnsOwner == "host";
+    if (host && pids.contains(info.pid.toLongLong()))
+      ports.insert(info.port);
+  }
+  if (ports.isEmpty()) {
+    mergeRescan(pids, ports, QList<PortInfo>());
+    return;
+  }
+
+  QList<int> sorted(ports.cbegin(), ports.cend());
+  std::sort(sorted.begin(), sorted.end());
+  QStringList portList;
+  for (int port : sorted)
+    portList << QString::number(port);
+
+  QProcess *process = new QProcess(this);
+  connect(process,
+          QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
+          [this, process, pids, ports](int exitCode,
+                                       QProcess::ExitStatus exitStatus) {
+            // lsof exits with 1 when nothing matched, i.e. all ports closed
+            const QByteArray output = process->readAllStandardOutput();
+            if (exitStatus == QProcess::NormalExit &&
+                (exitCode == 0 || (exitCode == 1 && output.isEmpty()))) {
+              QList<PortInfo> fresh;
+              for (const PortInfo &info : parseLsof(output)) {
+                // -i :port also matches the remote side of connections
+                if (ports.contains(info.port))
+                  fresh.append(info);
+              }
+              mergeRescan(pids, ports, fresh);
+            } else {
+              emit errorOccurred(process->readAllStandardError());
+            }
+            process->deleteLater();
+          });
+  process->start("lsof", QStringList() << "-P" << "-n" << "-i"
+                                       << ":" + portList.join(','));
+}
+
+void PortMonitor::mergeRescan(const QSet<qint64> &pids,
+                              const QSet<int> &ports,
+                              const QList<PortInfo> &fresh) {
+  // Merged into the newest snapshot, which may be a full scan that landed
+  // while lsof ran
+  QList<PortInfo> merged;
+  QList<PortInfo> foreign; // Other namespaces, which lsof did not rescan
+  for (const PortInfo &info : m_lastPorts) {
+    const bool host = info.netnsOwner.isEmpty() || info.netnsOwner == "host";
+    if (pids.contains(info.pid.toLongLong()) ||
+        (host && ports.contains(info.port)))
+      continue;
+    (host ? merged : foreign).append(info);
+  }
+  for (PortInfo info : fresh) {
+    info.netns = m_hostNamespace;
+    info.netnsOwner = "host";
+    merged.append(info);
+  }
+
+  if (!ports.isEmpty())
+    updateListeners(fresh, ports);
+  // The fresh rows need backlog, queue and drop figures like the rest; the
+  // host's per-process totals are redone over all of its rows
+  if (!fresh.isEmpty())
+    applyKernelStats(merged, false);
+  merged += foreign;
+  applyProcessInfo(merged);
+  m_lastPorts = merged;
+  emit portsUpdated(merged);
+}
+
+void PortMonitor::parseLsofOutput(const QByteArray &output,
+                                  qint64 startNs) {
+  StageProfiler::Scope stage("parseLsofOutput");
+  QList<PortInfo> ports = parseLsof(output);
+  updateListeners(ports);
+  applyKernelStats(ports);
+  scanNamespaces(ports, startNs);
+}
 
-  // Check for closed ports (in known but not in current)
-  for (const QString &key : m_knownPorts.keys()) {
-    if (!currentPorts.contains(key)) {
-      emit portClosed(m_knownPorts.value(key));
+void PortMonitor::updateListeners(const QList<PortInfo> &ports,
+                                  const QSet<int> &scope) {
+  // Track unique listeners
+  QMap<QString, PortInfo> currentPorts;
+  for (const PortInfo &info : ports) {
+    if (info.state != "LISTEN")
+      continue;
+    QString key = QString("%1:%2").arg(info.protocol).arg(info.port);
+    currentPorts.insert(key, info);
+
+    // Check if new
+    if (!m_knownPorts.contains(key)) {
+      emit newPortDetected(info);
     }
   }
 
-  m_knownPorts = currentPorts;
+  // Check for closed ports (in known but not in current); a targeted rescan
+  // only speaks for the ports in its scope
+  QMap<QString, PortInfo> known = currentPorts;
+  for (auto it = m_knownPorts.cbegin(); it != m_knownPorts.cend(); ++it) {
+    if (!scope.isEmpty() && !scope.contains(it->port))
+      known.insert(it.key(), it.value());
+    else if (!currentPorts.contains(it.key()))
+      emit portClosed(it.value());
+  }
+
+  m_knownPorts = known;
+}
+
+void PortMonitor::scanNamespaces(const QList<PortInfo> &hostPorts,
+                                 qint64 startNs) {
+#ifdef Q_OS_LINUX
+  // A scan still running picks up the newest host ports when it finishes
+  m_pendingPorts = hostPorts;
+  m_pendingStartNs = startNs;
+  if (m_namespaceScanRunning)
+    return;
+  m_namespaceScanRunning = true;
+
+  const quint64 host = m_hostNamespace;
+  // The worker only holds the promise, never `this`
+  auto promise = std::make_shared<QPromise<NamespaceScanResult>>();
+  promise->start();
+  m_namespaceWatcher->setFuture(promise->future());
+  QThreadPool::globalInstance()->start([promise, host]() {
+    promise->addResult(NamespaceScanner::scan(host));
+    promise->finish();
+  });
+#else
+  QList<PortInfo> ports = hostPorts;
+  applyProcessInfo(ports);
+  m_lastPorts = ports;
+  recordScan(startNs);
+  emit portsUpdated(ports);
+#endif
+}
+
+void PortMonitor::onNamespacesScanned(const NamespaceScanResult &result) {
+  m_namespaceScanRunning = false;
+  QList<PortInfo> ports = m_pendingPorts;
+  m_pendingPorts.clear();
+
+  for (PortInfo &info : ports) {
+    info.netns = m_hostNamespace;
+    info.netnsOwner = "host";
+  }
+  ports += result.ports;
+  applyProcessInfo(ports);
+  m_lastPorts = ports;
+  recordScan(m_pendingStartNs);
+
+  emit namespaceScanFinished(result.namespaces, result.elapsedMs);
   emit portsUpdated(ports);
 }
+
+void PortMonitor::recordScan(qint64 startNs) {
+  StageProfiler *profiler = StageProfiler::instance();
+  const qint64 endNs = profiler->now();
+  profiler->record("refresh", startNs, endNs, true);
+  m_lastScanMs = (endNs - startNs) / 1000000;
+}
+
+void PortMonitor::applyProcessInfo(QList<PortInfo> &ports) {
+  StageProfiler::Scope stage("applyProcessInfo");
+  struct Identity {
+    quint64 startTime;
+    QString unit;
+  };
+
+  // One lookup per process; the stat read that rules out PID reuse for the
+  // cgroup cache also gives the start time a later kill is checked against
+  QHash<qint64, Identity> identities;
+  for (PortInfo &info : ports) {
+    const qint64 pid = info.pid.toLongLong();
+    auto it = identities.constFind(pid);
+    if (it == identities.constEnd()) {
+      Identity identity = {0, QString()};
+#ifdef Q_OS_LINUX
+      identity.startTime = ProcessInfoCache::readStartTime(pid);
+      identity.unit = m_cgroups.lookup(pid, identity.startTime).label();
+#endif
+      it = identities.insert(pid, identity);
+    }
+    info.startTime = it->startTime;
+    info.unit = it->unit;
+  }
+
+  QSet<qint64> livePids(identities.keyBegin(), identities.keyEnd());
+  m_cgroups.retainOnly(livePids);
+}
+
+void PortMonitor::applyKernelStats(QList<PortInfo> &ports, bool sample) {
+  StageProfiler::Scope stage("applyKernelStats");
+  // One read of each kernel table per scan feeds every metric below
+  const QList<KernelSocket> tcp = SocketTable::readTcp();
+  applyListenerStats(ports, tcp);
+  applyUdpStats(ports, SocketTable::readUdp(), sample);
+  applyQueueStats(ports, sample, tcp);
+}
+
+void PortMonitor::applyListenerStats(QList<PortInfo> &ports,
+                                     const QList<KernelSocket> &tcp) {
+  struct ListenerStats {
+    int acceptQueue = 0;
+    int backlog = 0;
+    int synRecv = 0;
+    bool listening = false;
+  };
+
+  // lsof cannot tell IPv4 and IPv6 wildcard listeners apart, so aggregate
+  // per port: depth and backlog are both summed, keeping the ratio honest
+  QHash<int, ListenerStats> byPort;
+  for (const KernelSocket &sock : tcp) {
+    if (sock.state == SocketTable::Listen) {
+      ListenerStats &stats = byPort[sock.localPort];
+      stats.listening = true;
+      stats.acceptQueue += int(sock.rxQueue);
+      if (sock.txQueue < 0 || stats.backlog < 0)
+        stats.backlog = -1;
+      else
+        stats.backlog += int(sock.txQueue);
+    } else if (sock.state == SocketTable::SynRecv ||
+               sock.state == SocketTable::NewSynRecv) {
+      ++byPort[sock.localPort].synRecv;
+    }
+  }
+
+  for (PortInfo &info : ports) {
+    if (info.protocol != "TCP" || info.state != "LISTEN")
+      continue;
+    auto it = byPort.constFind(info.port);
+    if (it == byPort.constEnd() || !it->listening)
+      continue;
+    info.acceptQueue = it->acceptQueue;
+    info.backlog = it->backlog;
+    info.synRecv = it->synRecv;
+  }
+}
+
+void PortMonitor::applyUdpStats(QList<PortInfo> &ports,
+                                const QList<KernelSocket> &udp, bool sample) {
+  struct UdpStats {
+    qint64 rxQueue = 0;
+    qint64 txQueue = 0;
+    quint64 drops = 0;
+  };
+
+  QHash<int, UdpStats> byPort;
+  for (const KernelSocket &sock : udp) {
+    UdpStats &stats = byPort[sock.localPort];
+    stats.rxQueue += sock.rxQueue;
+    stats.txQueue += sock.txQueue;
+    stats.drops += sock.drops;
+  }
+
+  // Turn the kernel's cumulative counters into per-port rates
+  const qint64 now = m_clock.elapsed();
+  QHash<int, DropSample> samples;
+  QHash<int, double> rates;
+  for (auto it = byPort.cbegin(); it != byPort.cend(); ++it) {
+    samples.insert(it.key(), {it->drops, now});
+    auto prev = m_udpDropSamples.constFind(it.key());
+    if (prev == m_udpDropSamples.constEnd() || now <= prev->timestampMs)
+      continue;
+    // A smaller counter means the sockets were recreated; start over
+    quint64 delta = (it->drops >= prev->drops) ? it->drops - prev->drops : 0;
+    rates.insert(it.key(), delta * 1000.0 / (now - prev->timestampMs));
+  }
+  if (sample)
+    m_udpDropSamples = samples;
+
+  for (PortInfo &info : ports) {
+    if (info.protocol != "UDP")
+      continue;
+    auto it = byPort.constFind(info.port);
+    if (it == byPort.constEnd())
+      continue;
+    info.rxQueue = it->rxQueue;
+    info.txQueue = it->txQueue;
+    info.drops = it->drops;
+    info.dropRate = rates.value(info.port, 0.0);
+    info.dropsIncreasing = info.dropRate > 0.0;
+  }
+}
+
+void PortMonitor::applyQueueStats(QList<PortInfo> &ports, bool sample,
+                                  const QList<KernelSocket> &tcp) {
+  QHash<QString, const KernelSocket *> connections;
+  for (const KernelSocket &sock : tcp) {
+    if (sock.state == SocketTable::Listen || sock.remotePort == 0)
+      continue;
+    connections.insert(
+        connectionKey(sock.localPort, sock.remoteAddress, sock.remotePort),
+        &sock);
+  }
+
+  QHash<QString, qint64> perProcess;
+  QHash<int, qint64> perPort;
+  for (PortInfo &info : ports) {
+    if (info.protocol != "TCP" || info.remoteAddress.isEmpty())
+      continue;
+    int colon = info.remoteAddress.lastIndexOf(':');
+    if (colon < 0)
+      continue;
+    auto it = connections.constFind(
+        connectionKey(info.port, info.remoteAddress.left(colon),
+                      info.remoteAddress.mid(colon + 1).toInt()));
+    if (it == connections.constEnd())
+      continue;
+
+    const KernelSocket *sock = it.value();
+    info.rxQueue = sock->rxQueue;
+    info.txQueue = sock->txQueue;
+    info.socketMemory = sock->socketMemory;
+    perProcess[info.pid] += info.queuedBytes();
+    perPort[info.port] += info.queuedBytes();
+  }
+
+  // Only a steady climb counts as pressure, a single spike does not
+  QHash<QString, QList<qint64>> history;
+  QSet<QString> growing;
+  for (auto it = perProcess.cbegin(); it != perProcess.cend(); ++it) {
+    QList<qint64> samples = m_queueHistory.value(it.key());
+    samples.append(it.value());
+    if (samples.size() > kQueueHistoryLength)
+      samples.removeFirst();
+
+    bool rising = samples.size() == kQueueHistoryLength;
+    for (int i = 1; rising && i < samples.size(); ++i) {
+      rising = samples[i] > samples[i - 1];
+    }
+    if (rising)
+      growing.insert(it.key());
+    history.insert(it.key(), samples);
+  }
+  if (sample)
+    m_queueHistory = history;
+
+  for (PortInfo &info : ports) {
+    if (info.protocol != "TCP")
+      continue;
+    auto process = perProcess.constFind(info.pid);
+    if (process != perProcess.constEnd()) {
+      info.processQueuedBytes = process.value();
+      info.queueGrowing = growing.contains(info.pid);
+    }
+    auto port = perPort.constFind(info.port);
+    if (port != perPort.constEnd())
+      info.portQueuedBytes = port.value();
+  }
+}
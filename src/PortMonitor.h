@@ -16,29 +16,90 @@
 
 #pragma once
 
+#include "CgroupResolver.h"
+#include <QElapsedTimer>
+#include <QFutureWatcher>
+#include <QHash>
 #include <QList>
 #include <QMap>
 #include <QObject>
 #include <QSet>
 #include <QString>
+#include <QTimer>
 
 struct PortInfo {
   QString protocol;
   QString localAddress;
+  QString remoteAddress; // "host:port" of the peer, empty for listeners
   QString state;
   QString pid;
   QString processName;
   QString user;
+  QString unit; // systemd unit or container owning the process, if known
   int port;
+
+  // Agent that reported the socket (see AgentCollector), empty for sockets
+  // of this machine
+  QString host;
+
+  // Network namespace inode (0 when unknown) and who owns the namespace:
+  // "host", a container, or the namespace's first process
+  quint64 netns = 0;
+  QString netnsOwner;
+
+  // /proc start time of the process when the socket was seen (0 when
+  // unknown); lets a later kill tell a reused PID apart
+  quint64 startTime = 0;
+
+  // Listener health from the kernel socket table, summed over every socket
+  // listening on the port (-1 when unknown, e.g. off Linux)
+  int acceptQueue = -1;
+  int backlog = -1;
+  int synRecv = 0;
+
+  // Socket buffer state from the kernel (-1 when unknown). For UDP the queues
+  // and drop counters are summed over every socket bound to the port.
+  qint64 rxQueue = -1;
+  qint64 txQueue = -1;
+  quint64 drops = 0;
+  double dropRate = -1; // Drops per second since the previous scan
+  bool dropsIncreasing = false;
+
+  // TCP connections: Recv-Q/Send-Q above plus buffer memory, and the queued
+  // bytes (rx + tx) of all connections of the owning process and of the port
+  qint64 socketMemory = -1;
+  qint64 processQueuedBytes = -1;
+  qint64 portQueuedBytes = -1;
+  bool queueGrowing = false; // Process total grew over the last few scans
+
+  qint64 queuedBytes() const {
+    return (rxQueue >= 0 && txQueue >= 0) ? rxQueue + txQueue : -1;
+  }
 };
 
+struct KernelSocket;
+struct NamespaceScanResult;
+class ProcessTerminator;
+
 class PortMonitor : public QObject {
   Q_OBJECT
 
 public:
   explicit PortMonitor(QObject *parent = nullptr);
   void refresh();
-  Q_INVOKABLE void killProcess(qint64 pid);
+
+  // Ends `pid` if it is still the process seen in the last scan. Graceful
+  // sends SIGTERM first and SIGKILL after the grace period. Only the ports
+  // it held are rescanned once it is gone.
+  Q_INVOKABLE void killProcess(qint64 pid, bool graceful = false);
+  void setGracePeriod(int ms);
+
+  // Wall time of the last full scan, from refresh() to portsUpdated (-1
+  // before the first)
+  qint64 lastScanMs() const { return m_lastScanMs; }
+
+  // Rows of `lsof -i -P -n` output, without kernel or process details
+  static QList<PortInfo> parseLsof(const QByteArray &output);
 
 signals:
   void portsUpdated(const QList<PortInfo> &ports);
@@ -46,8 +107,54 @@ signals:
   void portClosed(const PortInfo &port);
   void errorOccurred(const QString &error);
   void processKilled(qint64 pid, bool success, const QString &message);
+  // Foreign network namespaces read during the last scan, and how long it took
+  void namespaceScanFinished(int namespaces, qint64 elapsedMs);
 
 private:
-  void parseLsofOutput(const QByteArray &output);
+  void parseLsofOutput(const QByteArray &output, qint64 startNs);
+  void updateListeners(const QList<PortInfo> &ports,
+                       const QSet<int> &scope = QSet<int>());
+  void onProcessFinished(qint64 pid, bool success, const QString &message);
+  void rescanExited();
+  void mergeRescan(const QSet<qint64> &pids, const QSet<int> &ports,
+                   const QList<PortInfo> &fresh);
+  // `sample` records drop counters and queue totals for the next scan's
+  // rates and trends; a partial rescan reads the tables without doing so
+  void applyKernelStats(QList<PortInfo> &ports, bool sample = true);
+  void applyListenerStats(QList<PortInfo> &ports,
+                          const QList<KernelSocket> &tcp);
+  void applyUdpStats(QList<PortInfo> &ports, const QList<KernelSocket> &udp,
+                     bool sample);
+  void applyQueueStats(QList<PortInfo> &ports, bool sample,
+                       const QList<KernelSocket> &tcp);
+  void applyProcessInfo(QList<PortInfo> &ports);
+  void scanNamespaces(const QList<PortInfo> &hostPorts, qint64 startNs);
+  void recordScan(qint64 startNs);
+  void onNamespacesScanned(const NamespaceScanResult &result);
+
+  struct DropSample {
+    quint64 drops;
+    qint64 timestampMs;
+  };
+
   QMap<QString, PortInfo> m_knownPorts;
+  QHash<int, DropSample> m_udpDropSamples;        // Keyed by port
+  QHash<QString, QList<qint64>> m_queueHistory; // Keyed by PID
+  QElapsedTimer m_clock;
+  CgroupResolver m_cgroups;
+
+  // lsof sees our own namespace; the others are scanned on the thread pool
+  quint64 m_hostNamespace = 0;
+  QList<PortInfo> m_pendingPorts;
+  qint64 m_pendingStartNs = 0; // refresh() that produced them, profiler clock
+  bool m_namespaceScanRunning = false;
+  // Delivers the worker's result; going away with us, it drops a result
+  // that arrives after we are destroyed
+  QFutureWatcher<NamespaceScanResult> *m_namespaceWatcher;
+
+  QList<PortInfo> m_lastPorts; // As last emitted through portsUpdated
+  qint64 m_lastScanMs = -1;
+  ProcessTerminator *m_terminator;
+  QSet<qint64> m_exitedPids; // Awaiting the batched rescan
+  QTimer *m_rescanTimer;
 };
@@ -16,6 +16,10 @@ public:
   void stop();
   bool isRunning() const { return m_running; }
 
+  // Diffs one lsof run against the previous one and emits the changes;
+  // public so synthetic output can be fed in (see bench/)
+  void parseOutput(const QByteArray &output);
+
 signals:
   void connectionOpened(const PortInfo &info);
   void connectionClosed(const PortInfo &info);
@@ -26,8 +30,6 @@ private slots:
   void onTimeout();
 
 private:
-  void parseOutput(const QByteArray &output);
-
   int m_targetPort = 0;
   bool m_running = false;
   QTimer *m_timer;
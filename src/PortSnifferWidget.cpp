@@ -1,10 +1,19 @@
 #include "PortSnifferWidget.h"
 #include <QDateTime>
 #include <QHBoxLayout>
+#include <QHash>
 #include <QHeaderView>
+#include <QLocale>
 #include <QMessageBox>
 #include <QVBoxLayout>
 
+// Flush at most once per frame (~60 Hz)
+static const int kFrameIntervalMs = 16;
+// Events arriving within this window of the newest row extend its burst
+static const qint64 kBurstWindowMs = 1000;
+static const int kMaxLogRows = 5000;
+static const int kMaxPendingEvents = 20000;
+
 PortSnifferWidget::PortSnifferWidget(QWidget *parent) : QWidget(parent) {
   QVBoxLayout *layout = new QVBoxLayout(this);
 
@@ -30,30 +39,62 @@ PortSnifferWidget::PortSnifferWidget(QWidget *parent) : QWidget(parent) {
   connect(m_clearBtn, &QPushButton::clicked, this,
           &PortSnifferWidget::clearLogs);
 
+  m_packetModeCheck = new QCheckBox("Packet capture", this);
+  m_packetModeCheck->setToolTip(
+      "Also capture packets on this port (AF_PACKET ring, Linux only, needs "
+      "CAP_NET_RAW) for SYN/FIN/RST counts, bytes and handshake latency");
+  m_packetModeCheck->setEnabled(PacketCapture::isSupported());
+
+  // Events folded into counted rows or shed when the buffer overflows
+  m_countersLabel = new QLabel(this);
+  m_countersLabel->setStyleSheet("color: #888;");
+  updateCounters();
+
   controlsLog->addWidget(label);
   controlsLog->addWidget(m_portInput);
   controlsLog->addWidget(m_toggleBtn);
+  controlsLog->addWidget(m_packetModeCheck);
   controlsLog->addStretch();
+  controlsLog->addWidget(m_countersLabel);
   controlsLog->addWidget(m_clearBtn);
 
-  // Log Table
-  m_logTable = new QTableWidget(this);
-  m_logTable->setColumnCount(3);
-  m_logTable->setHorizontalHeaderLabels({"Time", "Event", "Details"});
-  m_logTable->horizontalHeader()->setSectionResizeMode(
-      0, QHeaderView::ResizeToContents);
-  m_logTable->horizontalHeader()->setSectionResizeMode(
-      1, QHeaderView::ResizeToContents);
-  m_logTable->horizontalHeader()->setSectionResizeMode(2, QHeaderView::Stretch);
-  m_logTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
-  m_logTable->setSelectionBehavior(QAbstractItemView::SelectRows);
-  m_logTable->setStyleSheet("QTableWidget { background-color: #1e1e1e; color: "
-                            "#dcdcdc; gridline-color: #333; }"
-                            "QHeaderView::section { background-color: #2d2d2d; "
-                            "color: white; padding: 4px; border: none; }");
+  // Log View (model-backed and capped, see flushPendingLogs)
+  m_logModel = new SnifferLogModel(this);
+  m_logModel->setMaxRows(kMaxLogRows);
+
+  m_logView = new QTableView(this);
+  m_logView->setModel(m_logModel);
+  m_logView->verticalHeader()->setVisible(false);
+  m_logView->horizontalHeader()->setSectionResizeMode(
+      SnifferLogModel::Time, QHeaderView::ResizeToContents);
+  m_logView->horizontalHeader()->setSectionResizeMode(
+      SnifferLogModel::Event, QHeaderView::ResizeToContents);
+  m_logView->horizontalHeader()->setSectionResizeMode(SnifferLogModel::Details,
+                                                      QHeaderView::Stretch);
+  // Uniform rows let the view skip per-row size queries during storms
+  m_logView->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+  m_logView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+  m_logView->setSelectionBehavior(QAbstractItemView::SelectRows);
+  m_logView->setStyleSheet("QTableView { background-color: #1e1e1e; color: "
+                           "#dcdcdc; gridline-color: #333; }"
+                           "QHeaderView::section { background-color: #2d2d2d; "
+                           "color: white; padding: 4px; border: none; }");
+
+  m_flushTimer = new QTimer(this);
+  m_flushTimer->setSingleShot(true);
+  m_flushTimer->setInterval(kFrameIntervalMs);
+  connect(m_flushTimer, &QTimer::timeout, this,
+          &PortSnifferWidget::flushPendingLogs);
+
+  m_packetStatsLabel = new QLabel(this);
+  m_packetStatsLabel->setStyleSheet(
+      "background-color: #2b2b2b; color: #ddd; border-radius: 4px; "
+      "padding: 6px; font-family: monospace;");
+  m_packetStatsLabel->setVisible(false);
 
   layout->addLayout(controlsLog);
-  layout->addWidget(m_logTable);
+  layout->addWidget(m_packetStatsLabel);
+  layout->addWidget(m_logView);
 
   // Backend
   m_sniffer = new PortSniffer(this);
@@ -65,6 +106,12 @@ PortSnifferWidget::PortSnifferWidget(QWidget *parent) : QWidget(parent) {
           &PortSnifferWidget::onConnectionClosed);
   connect(m_sniffer, &PortSniffer::stateChanged, this,
           &PortSnifferWidget::onStateChanged);
+
+  m_capture = new PacketCapture(this);
+  connect(m_capture, &PacketCapture::statsUpdated, this,
+          &PortSnifferWidget::onPacketStats);
+  connect(m_capture, &PacketCapture::captureError, this,
+          &PortSnifferWidget::onCaptureError);
 }
 
 void PortSnifferWidget::onToggleSniffing() {
@@ -80,73 +127,190 @@ void PortSnifferWidget::onToggleSniffing() {
     m_sniffer->setTargetPort(port);
     m_sniffer->start();
 
+    if (m_packetModeCheck->isChecked()) {
+      m_capture->setTargetPort(port);
+      m_capture->start();
+      m_packetStatsLabel->setText("Waiting for packets...");
+      m_packetStatsLabel->setVisible(true);
+    }
+
     m_isSniffing = true;
     m_toggleBtn->setText("Stop Monitoring");
     m_toggleBtn->setStyleSheet("background-color: #dc3545; color: white; "
                                "font-weight: bold; padding: 6px;");
     m_portInput->setEnabled(false);
+    m_packetModeCheck->setEnabled(false);
     addLog("Monitoring Started", "#4dc2fc");
   } else {
     m_sniffer->stop();
+    m_capture->stop();
     m_isSniffing = false;
     m_toggleBtn->setText("Start Monitoring");
     m_toggleBtn->setStyleSheet("background-color: #28a745; color: white; "
                                "font-weight: bold; padding: 6px;");
     m_portInput->setEnabled(true);
+    m_packetModeCheck->setEnabled(PacketCapture::isSupported());
     addLog("Monitoring Stopped", "#ffa500");
   }
 }
 
 void PortSnifferWidget::onSnifferError(const QString &msg) {
-  addLog("Error: " + msg, "#ff4444");
+  addLog("Error", "#ff4444", msg, "error|" + msg, "errors: " + msg);
   // Stop if error is severe? For now just log.
 }
 
+void PortSnifferWidget::onCaptureError(const QString &msg) {
+  // Socket-table monitoring keeps running; only packet counters are lost
+  addLog("Capture Unavailable", "#ffa500", msg + " - using socket table only");
+  m_packetModeCheck->setChecked(false);
+  m_packetStatsLabel->setVisible(false);
+}
+
+void PortSnifferWidget::onPacketStats(const PacketCaptureStats &stats) {
+  QLocale locale;
+  QString text =
+      QString("SYN %1  SYN/ACK %2  FIN %3  RST %4  |  %5 in %6 packets  |  "
+              "%7 active  |  handshake avg %8 ms, max %9 ms")
+          .arg(locale.toString(stats.syn))
+          .arg(locale.toString(stats.synAck))
+          .arg(locale.toString(stats.fin))
+          .arg(locale.toString(stats.rst))
+          .arg(locale.formattedDataSize(stats.bytes))
+          .arg(locale.toString(stats.packets))
+          .arg(stats.activeConnections)
+          .arg(stats.avgHandshakeMs, 0, 'f', 3)
+          .arg(stats.maxHandshakeMs, 0, 'f', 3);
+  if (stats.ringDrops > 0) {
+    text += QString("  |  ring drops %1").arg(locale.toString(stats.ringDrops));
+  }
+  m_packetStatsLabel->setText(text);
+
+  QStringList top;
+  for (const PacketConnectionStats &conn : stats.topConnections) {
+    top << QString("%1  in %2  out %3")
+               .arg(conn.client)
+               .arg(locale.formattedDataSize(conn.bytesIn))
+               .arg(locale.formattedDataSize(conn.bytesOut));
+  }
+  m_packetStatsLabel->setToolTip(top.isEmpty() ? QString()
+                                               : "Top connections:\n" +
+                                                     top.join('\n'));
+}
+
 void PortSnifferWidget::onConnectionOpened(const PortInfo &info) {
   QString details = QString("%1 (%2) - %3")
                         .arg(info.processName)
                         .arg(info.pid)
                         .arg(info.localAddress);
-  addLog("New Connection", "#00ff00");
-
-  // Update last row details
-  int row = 0;
-  m_logTable->item(row, 2)->setText(details);
+  QString host = remoteHost(info);
+  addLog("New Connection", "#00ff00", details, "open|" + host,
+         QString("connections opened from %1").arg(host));
 }
 
 void PortSnifferWidget::onConnectionClosed(const PortInfo &info) {
   QString details =
       QString("Process %1 (%2) closed").arg(info.processName).arg(info.pid);
-  addLog("Connection Closed", "#ff4444");
-  int row = 0;
-  m_logTable->item(row, 2)->setText(details);
+  QString host = remoteHost(info);
+  addLog("Connection Closed", "#ff4444", details, "close|" + host,
+         QString("connections closed from %1").arg(host));
 }
 
 void PortSnifferWidget::onStateChanged(const PortInfo &info,
                                        const QString &oldState) {
   QString details = QString("%1 -> %2").arg(oldState).arg(info.state);
-  addLog("State Changed", "#ffff00");
-  int row = 0;
-  m_logTable->item(row, 2)->setText(details);
+  addLog("State Changed", "#ffff00", details, "state|" + details,
+         QString("state changes %1").arg(details));
+}
+
+void PortSnifferWidget::addLog(const QString &msg, const QString &color,
+                               const QString &details,
+                               const QString &groupKey,
+                               const QString &groupLabel) {
+  // Cheap pre-merge: a storm of identical events never grows the buffer
+  if (!groupKey.isEmpty() && !m_pendingLogs.isEmpty() &&
+      m_pendingLogs.last().groupKey == groupKey) {
+    SnifferLogEntry &last = m_pendingLogs.last();
+    ++last.count;
+    last.details = details;
+    last.time = QDateTime::currentDateTime();
+    ++m_mergedEvents;
+  } else if (m_pendingLogs.size() >= kMaxPendingEvents) {
+    ++m_droppedEvents;
+  } else {
+    SnifferLogEntry entry;
+    entry.time = QDateTime::currentDateTime();
+    entry.event = msg;
+    entry.details = details;
+    entry.color = QColor(color);
+    entry.groupKey = groupKey;
+    entry.groupLabel = groupLabel;
+    m_pendingLogs.append(entry);
+  }
+
+  if (!m_flushTimer->isActive())
+    m_flushTimer->start();
 }
 
-void PortSnifferWidget::addLog(const QString &msg, const QString &color) {
-  int row = 0;
-  m_logTable->insertRow(row);
+void PortSnifferWidget::flushPendingLogs() {
+  if (m_pendingLogs.isEmpty())
+    return;
 
-  QString timestamp = QDateTime::currentDateTime().toString("HH:mm:ss");
+  // Collapse identical events of this frame into counted rows
+  QList<SnifferLogEntry> batch;
+  QHash<QString, int> groupRows;
+  for (const SnifferLogEntry &entry : std::as_const(m_pendingLogs)) {
+    if (!entry.groupKey.isEmpty()) {
+      auto it = groupRows.constFind(entry.groupKey);
+      if (it != groupRows.constEnd()) {
+        SnifferLogEntry &row = batch[it.value()];
+        row.count += entry.count;
+        row.details = entry.details;
+        row.time = entry.time;
+        // The pre-merge in addLog() already counted the rest
+        ++m_mergedEvents;
+        continue;
+      }
+      groupRows.insert(entry.groupKey, batch.size());
+    }
+    batch.append(entry);
+  }
+  m_pendingLogs.clear();
 
-  QTableWidgetItem *timeItem = new QTableWidgetItem(timestamp);
-  QTableWidgetItem *msgItem = new QTableWidgetItem(msg);
-  QTableWidgetItem *detailsItem = new QTableWidgetItem("");
+  // A burst spanning several frames keeps growing the newest row
+  const SnifferLogEntry &oldest = batch.first();
+  if (m_logModel->mergeIntoTop(oldest, kBurstWindowMs)) {
+    ++m_mergedEvents;
+    batch.removeFirst();
+  }
 
-  msgItem->setForeground(QBrush(QColor(color)));
+  m_logModel->prependEntries(batch);
+  updateCounters();
+}
 
-  m_logTable->setItem(row, 0, timeItem);
-  m_logTable->setItem(row, 1, msgItem);
-  m_logTable->setItem(row, 2, detailsItem);
+void PortSnifferWidget::updateCounters() {
+  m_countersLabel->setText(QString("Merged: %1  Dropped: %2")
+                               .arg(QLocale().toString(m_mergedEvents))
+                               .arg(QLocale().toString(m_droppedEvents)));
+}
+
+QString PortSnifferWidget::remoteHost(const PortInfo &info) {
+  // PortSniffer reports connections as "local -> remote"
+  QString remote = info.localAddress.section(" -> ", 1);
+  if (remote.isEmpty())
+    return info.localAddress;
 
-  m_logTable->scrollToTop();
+  int lastColon = remote.lastIndexOf(':');
+  QString host = (lastColon != -1) ? remote.left(lastColon) : remote;
+  if (host.startsWith('[') && host.endsWith(']'))
+    host = host.mid(1, host.size() - 2);
+  return host;
 }
 
-void PortSnifferWidget::clearLogs() { m_logTable->setRowCount(0); }
+void PortSnifferWidget::clearLogs() {
+  m_flushTimer->stop();
+  m_pendingLogs.clear();
+  m_logModel->clear();
+  m_mergedEvents = 0;
+  m_droppedEvents = 0;
+  updateCounters();
+}
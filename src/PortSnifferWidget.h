@@ -1,11 +1,15 @@
 #ifndef PORTSNIFFERWIDGET_H
 #define PORTSNIFFERWIDGET_H
 
+#include "PacketCapture.h"
 #include "PortSniffer.h"
+#include "SnifferLogModel.h"
+#include <QCheckBox>
 #include <QLabel>
 #include <QLineEdit>
 #include <QPushButton>
-#include <QTableWidget>
+#include <QTableView>
+#include <QTimer>
 #include <QWidget>
 
 class PortSnifferWidget : public QWidget {
@@ -19,17 +23,36 @@ private slots:
   void onConnectionOpened(const PortInfo &info);
   void onConnectionClosed(const PortInfo &info);
   void onStateChanged(const PortInfo &info, const QString &oldState);
+  void onPacketStats(const PacketCaptureStats &stats);
+  void onCaptureError(const QString &msg);
+  void flushPendingLogs();
   void clearLogs();
 
 private:
-  void addLog(const QString &msg, const QString &color);
+  void addLog(const QString &msg, const QString &color,
+              const QString &details = QString(),
+              const QString &groupKey = QString(),
+              const QString &groupLabel = QString());
+  void updateCounters();
+  static QString remoteHost(const PortInfo &info);
 
   QLineEdit *m_portInput;
   QPushButton *m_toggleBtn;
   QPushButton *m_clearBtn;
-  QTableWidget *m_logTable;
+  QCheckBox *m_packetModeCheck;
+  QLabel *m_packetStatsLabel;
+  QLabel *m_countersLabel;
+  QTableView *m_logView;
+  SnifferLogModel *m_logModel;
   PortSniffer *m_sniffer;
+  PacketCapture *m_capture;
   bool m_isSniffing = false;
+
+  // Events are buffered here and flushed to the model at most once per frame
+  QList<SnifferLogEntry> m_pendingLogs;
+  QTimer *m_flushTimer;
+  qint64 m_mergedEvents = 0;
+  qint64 m_droppedEvents = 0;
 };
 
 #endif // PORTSNIFFERWIDGET_H
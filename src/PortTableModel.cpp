@@ -15,8 +15,14 @@
  */
 
 #include "PortTableModel.h"
+#include "ProcessInfoCache.h"
+#include "ResourceSampler.h"
+#include "StageProfiler.h"
 #include <QBrush>
 #include <QColor>
+#include <QFont>
+#include <QLocale>
+#include <QMap>
 #include <QSet>
 #include <algorithm>
 
@@ -25,7 +31,7 @@ PortTableModel::PortTableModel(QObject *parent) : QAbstractTableModel(parent) {}
 int PortTableModel::rowCount(const QModelIndex &parent) const {
   if (parent.isValid())
     return 0;
-  return m_ports.size();
+  return m_groupByUnit ? m_rows.size() : m_ports.size();
 }
 
 int PortTableModel::columnCount(const QModelIndex &parent) const {
@@ -34,12 +40,75 @@ int PortTableModel::columnCount(const QModelIndex &parent) const {
   return ColumnCount;
 }
 
+// Text colours and tints; one shared brush each, handed out by copy
+enum Tone : quint8 {
+  NoTone,
+  Listening,
+  Established,
+  Alert,
+  Stale,
+  QueueGrowing,
+  GroupHeader,
+};
+
+static const QBrush &toneBrush(Tone tone) {
+  static const QBrush brushes[] = {
+      QBrush(),
+      QBrush(QColor("#4dc2fc")), // Light blue for listening
+      QBrush(QColor("#81c784")), // Green for established
+      QBrush(QColor("#e57373")), // Red for growing drops, full backlog
+      QBrush(QColor("#808080")), // Grey for last session's rows
+      QBrush(QColor("#4a3520")), // Amber tint: queues keep growing
+      QBrush(QColor("#333d47")),
+  };
+  return brushes[tone];
+}
+
+PortTableModel::DisplayRow PortTableModel::formatRow(const PortInfo &info) {
+  DisplayRow row;
+  row.remote = !info.host.isEmpty();
+  // Another host's PID means nothing here: never sampled or looked up
+  row.pid = row.remote ? -1 : info.pid.toLongLong();
+  row.port = QString::number(info.port);
+  row.listening = (info.state == "LISTEN");
+  if (row.listening)
+    row.tone = Listening;
+  else if (info.state == "ESTABLISHED")
+    row.tone = Established;
+
+  if (info.acceptQueue >= 0) {
+    row.backlog =
+        info.backlog < 0
+            ? QString::number(info.acceptQueue)
+            : QString("%1/%2").arg(info.acceptQueue).arg(info.backlog);
+    row.synRecv = QString::number(info.synRecv);
+  }
+  row.backlogAlert =
+      info.backlog > 0 && info.acceptQueue * 10 >= info.backlog * 8;
+  if (info.dropRate >= 0) {
+    // Flag ports whose receive drops grew since the previous scan
+    row.drops = QString(info.dropsIncreasing ? "▲ " : "") +
+                QString::number(info.dropRate, 'f', 1);
+  }
+  row.dropsAlert = info.dropsIncreasing;
+  if (info.queuedBytes() >= 0)
+    row.queued = QLocale().formattedDataSize(info.queuedBytes());
+  row.queueGrowing = info.queueGrowing;
+  return row;
+}
+
 QVariant PortTableModel::data(const QModelIndex &index, int role) const {
-  if (!index.isValid() || index.row() >= m_ports.size())
+  if (!index.isValid() || index.row() >= rowCount())
     return QVariant();
 
-  const PortInfo &info = m_ports[index.row()];
+  const int i = portIndex(index.row());
+  if (i < 0)
+    return groupData(m_groups[-m_rows[index.row()] - 1], index.column(), role);
+  const PortInfo &info = m_ports[i];
+  const DisplayRow &row = m_display[i];
 
+  // Called for every visible cell on every repaint: only shared copies of
+  // strings and brushes prepared in buildDisplay() are returned here
   if (role == Qt::DisplayRole) {
     switch (index.column()) {
     case ProcessName:
@@ -48,29 +117,93 @@ QVariant PortTableModel::data(const QModelIndex &index, int role) const {
       return info.pid;
     case User:
       return info.user;
+    case Unit:
+      return info.unit;
+    case Host:
+      return info.host;
+    case Namespace:
+      return info.netnsOwner;
     case Protocol:
       return info.protocol;
     case LocalAddress:
       return info.localAddress;
     case Port:
-      return info.port;
+      return row.port;
     case State:
       return info.state;
-    case Action:
-      return (info.state == "LISTEN") ? "🔗 Open" : "";
+    case Backlog:
+      return row.backlog;
+    case SynRecv:
+      return row.synRecv;
+    case Drops:
+      return row.drops;
+    case Queued:
+      return row.queued;
+    case Cpu:
+    case Memory:
+    case Fds:
+    case Threads: {
+      // Only rows on screen are sampled; the rest stay blank
+      auto it = m_resourceText.constFind(row.pid);
+      if (it == m_resourceText.constEnd())
+        return QString();
+      return it->cells[index.column() - Cpu];
+    }
+    case Action: {
+      static const QString openLabel = "🔗 Open";
+      return row.listening ? openLabel : QString();
+    }
     }
   } else if (role == Qt::TextAlignmentRole) {
     return Qt::AlignCenter;
-  } else if (role == Qt::ForegroundRole) {
-    if (info.state == "LISTEN") {
-      return QBrush(QColor("#4dc2fc")); // Light blue for listening
-    } else if (info.state == "ESTABLISHED") {
-      return QBrush(QColor("#81c784")); // Green for established
+  } else if (role == Qt::ToolTipRole) {
+    if (index.column() == ProcessName) {
+      const qint64 pid = row.pid;
+      ProcessDetails details =
+          ProcessInfoCache::instance()->cached(pid, info.startTime);
+      if (details.valid && !details.commandLine.isEmpty())
+        return details.commandLine;
+      // Loaded off the GUI thread; the next hover shows the command line
+      ProcessInfoCache::instance()->request(pid);
+      return info.processName;
     }
-  } else if (role == Qt::TextAlignmentRole) {
-    if (index.column() == Port || index.column() == PID)
-      return int(Qt::AlignRight | Qt::AlignVCenter);
-    return int(Qt::AlignLeft | Qt::AlignVCenter);
+    if (index.column() == Namespace && info.netns != 0)
+      return QString("net:[%1]").arg(info.netns);
+    if (index.column() == Drops && info.dropRate >= 0) {
+      return QString("Receive queue: %1 bytes\nSend queue: %2 bytes\n"
+                     "Total drops: %3")
+          .arg(info.rxQueue)
+          .arg(info.txQueue)
+          .arg(info.drops);
+    }
+    if (index.column() == Queued && info.queuedBytes() >= 0) {
+      QLocale locale;
+      QString tip = QString("Recv-Q: %1\nSend-Q: %2")
+                        .arg(locale.formattedDataSize(info.rxQueue))
+                        .arg(locale.formattedDataSize(info.txQueue));
+      if (info.socketMemory >= 0)
+        tip += "\nSocket memory: " +
+               locale.formattedDataSize(info.socketMemory);
+      if (info.processQueuedBytes >= 0)
+        tip += QString("\nProcess total: %1%2")
+                   .arg(locale.formattedDataSize(info.processQueuedBytes))
+                   .arg(info.queueGrowing ? " (growing)" : "");
+      if (info.portQueuedBytes >= 0)
+        tip += "\nPort total: " +
+               locale.formattedDataSize(info.portQueuedBytes);
+      return tip;
+    }
+  } else if (role == Qt::BackgroundRole) {
+    if (row.queueGrowing)
+      return toneBrush(QueueGrowing);
+  } else if (role == Qt::ForegroundRole) {
+    if (m_stale)
+      return toneBrush(Stale);
+    if ((index.column() == Drops && row.dropsAlert) ||
+        (index.column() == Backlog && row.backlogAlert))
+      return toneBrush(Alert);
+    if (row.tone != NoTone)
+      return toneBrush(Tone(row.tone));
   }
 
   return QVariant();
@@ -87,6 +220,12 @@ QVariant PortTableModel::headerData(int section, Qt::Orientation orientation,
         return "PID";
       case User:
         return "User";
+      case Unit:
+        return "Unit";
+      case Host:
+        return "Host";
+      case Namespace:
+        return "Namespace";
       case Protocol:
         return "Protocol";
       case LocalAddress:
@@ -95,6 +234,22 @@ QVariant PortTableModel::headerData(int section, Qt::Orientation orientation,
         return "Port";
       case State:
         return "State";
+      case Backlog:
+        return "Backlog";
+      case SynRecv:
+        return "SYN_RECV";
+      case Drops:
+        return "Drops/s";
+      case Queued:
+        return "Queued";
+      case Cpu:
+        return "CPU %";
+      case Memory:
+        return "RSS";
+      case Fds:
+        return "FDs";
+      case Threads:
+        return "Threads";
       case Action:
         return "Launch";
       }
@@ -103,9 +258,277 @@ QVariant PortTableModel::headerData(int section, Qt::Orientation orientation,
   return QVariant();
 }
 
+QVariant PortTableModel::groupData(const UnitGroup &group, int column,
+                                   int role) const {
+  if (role == Qt::DisplayRole && column == ProcessName) {
+    return QString("%1 — %2 listening · %3 connected")
+        .arg(group.unit.isEmpty() ? QString("No unit") : group.unit)
+        .arg(group.listeners)
+        .arg(group.connections);
+  } else if (role == Qt::FontRole) {
+    static const QFont bold = []() {
+      QFont font;
+      font.setBold(true);
+      return font;
+    }();
+    return bold;
+  } else if (role == Qt::BackgroundRole) {
+    return toneBrush(GroupHeader);
+  } else if (role == Qt::TextAlignmentRole) {
+    return int(Qt::AlignLeft | Qt::AlignVCenter);
+  }
+  return QVariant();
+}
+
+void PortTableModel::sort(int column, Qt::SortOrder order) {
+  emit layoutAboutToBeChanged();
+  m_sortColumn = (column == Action) ? -1 : column;
+  m_sortOrder = order;
+  sortPorts();
+  buildDisplay();
+  buildRows();
+  emit layoutChanged();
+}
+
 void PortTableModel::setPorts(const QList<PortInfo> &ports) {
+  StageProfiler::Scope stage("PortTableModel::setPorts");
   beginResetModel();
   m_ports = ports;
+  sortPorts();
+  buildDisplay();
+  buildRows();
+  endResetModel();
+}
+
+QList<PortInfo> PortTableModel::filter(const QList<PortInfo> &ports,
+                                       const QString &text) {
+  if (text.isEmpty())
+    return ports;
+  QList<PortInfo> filtered;
+  if (text.startsWith("unit:", Qt::CaseInsensitive)) {
+    // "unit:nginx" matches the unit or container column only
+    const QString unit = text.mid(5).trimmed();
+    for (const PortInfo &info : ports) {
+      if (info.unit.contains(unit, Qt::CaseInsensitive))
+        filtered.append(info);
+    }
+    return filtered;
+  }
+  for (const PortInfo &info : ports) {
+    if (info.processName.contains(text, Qt::CaseInsensitive) ||
+        info.pid.contains(text, Qt::CaseInsensitive) ||
+        QString::number(info.port).contains(text) ||
+        info.protocol.contains(text, Qt::CaseInsensitive) ||
+        info.unit.contains(text, Qt::CaseInsensitive) ||
+        info.host.contains(text, Qt::CaseInsensitive) ||
+        info.netnsOwner.contains(text, Qt::CaseInsensitive)) {
+      filtered.append(info);
+    }
+  }
+  return filtered;
+}
+
+void PortTableModel::setGroupByUnit(bool enabled) {
+  if (enabled == m_groupByUnit)
+    return;
+  beginResetModel();
+  m_groupByUnit = enabled;
+  buildRows();
+  endResetModel();
+}
+
+void PortTableModel::setStale(bool stale) {
+  if (stale == m_stale)
+    return;
+  m_stale = stale;
+  if (rowCount() > 0) {
+    emit dataChanged(index(0, 0), index(rowCount() - 1, columnCount() - 1),
+                     {Qt::ForegroundRole});
+  }
+}
+
+bool PortTableModel::isGroupRow(int row) const {
+  return m_groupByUnit && row >= 0 && row < m_rows.size() && m_rows[row] < 0;
+}
+
+int PortTableModel::portIndex(int row) const {
+  if (!m_groupByUnit)
+    return (row >= 0 && row < m_ports.size()) ? row : -1;
+  if (row < 0 || row >= m_rows.size())
+    return -1;
+  return m_rows[row]; // Negative for group headers
+}
+
+void PortTableModel::buildDisplay() {
+  m_display.clear();
+  m_display.reserve(m_ports.size());
+  for (const PortInfo &info : m_ports)
+    m_display.append(formatRow(info));
+}
+
+void PortTableModel::buildResourceText() {
+  // Only the watched PIDs have samples, so this stays small
+  m_resourceText.clear();
+  if (!m_sampler)
+    return;
+  QLocale locale;
+  const QHash<qint64, ResourceSample> &samples = m_sampler->samples();
+  for (auto it = samples.cbegin(); it != samples.cend(); ++it) {
+    const ResourceSample &sample = it.value();
+    ResourceText text;
+    if (sample.cpuPercent >= 0)
+      text.cells[0] = QString::number(sample.cpuPercent, 'f', 1);
+    if (sample.rssBytes >= 0)
+      text.cells[1] = locale.formattedDataSize(sample.rssBytes);
+    if (sample.openFds >= 0)
+      text.cells[2] = QString::number(sample.openFds);
+    if (sample.threads >= 0)
+      text.cells[3] = QString::number(sample.threads);
+    m_resourceText.insert(it.key(), text);
+  }
+}
+
+void PortTableModel::buildRows() {
+  m_rows.clear();
+  m_groups.clear();
+  if (!m_groupByUnit)
+    return;
+
+  // Members keep the current sort order; groups go by name, "No unit" last
+  QMap<QString, QList<int>> byUnit;
+  for (int i = 0; i < m_ports.size(); ++i)
+    byUnit[m_ports[i].unit].append(i);
+
+  auto addGroup = [this](const QString &unit, const QList<int> &members) {
+    UnitGroup group;
+    group.unit = unit;
+    for (int i : members) {
+      if (m_ports[i].state == "LISTEN")
+        group.listeners++;
+      else if (!m_ports[i].remoteAddress.isEmpty())
+        group.connections++;
+    }
+    m_rows.append(-(m_groups.size() + 1));
+    m_groups.append(group);
+    m_rows.append(members);
+  };
+  for (auto it = byUnit.cbegin(); it != byUnit.cend(); ++it) {
+    if (!it.key().isEmpty())
+      addGroup(it.key(), it.value());
+  }
+  if (byUnit.contains(QString()))
+    addGroup(QString(), byUnit.value(QString()));
+}
+
+void PortTableModel::setResourceSampler(const ResourceSampler *sampler) {
+  if (m_sampler)
+    disconnect(m_sampler, nullptr, this, nullptr);
+  m_sampler = sampler;
+  buildResourceText();
+  if (!m_sampler)
+    return;
+
+  // Repaint just the resource columns; the view skips off-screen rows
+  connect(m_sampler, &ResourceSampler::samplesUpdated, this, [this]() {
+    buildResourceText();
+    if (rowCount() == 0)
+      return;
+    emit dataChanged(index(0, Cpu), index(rowCount() - 1, Threads),
+                     {Qt::DisplayRole});
+  });
+}
+
+qint64 PortTableModel::pidAt(int row) const {
+  const int i = portIndex(row);
+  return i >= 0 ? m_display[i].pid : -1;
+}
+
+bool PortTableModel::isRemoteRow(int row) const {
+  const int i = portIndex(row);
+  return i >= 0 && m_display[i].remote;
+}
+
+double PortTableModel::resourceValue(const PortInfo &info, int column) const {
+  if (!m_sampler || !info.host.isEmpty())
+    return -1;
+  const ResourceSample sample = m_sampler->sample(info.pid.toLongLong());
+  switch (column) {
+  case Cpu:
+    return sample.cpuPercent;
+  case Memory:
+    return double(sample.rssBytes);
+  case Fds:
+    return sample.openFds;
+  case Threads:
+    return sample.threads;
+  }
+  return -1;
+}
+
+static bool lessThan(const PortInfo &a, const PortInfo &b, int column) {
+  switch (column) {
+  case PortTableModel::ProcessName:
+    return a.processName.compare(b.processName, Qt::CaseInsensitive) < 0;
+  case PortTableModel::PID:
+    return a.pid.toLongLong() < b.pid.toLongLong();
+  case PortTableModel::User:
+    return a.user.compare(b.user, Qt::CaseInsensitive) < 0;
+  case PortTableModel::Unit:
+    return a.unit.compare(b.unit, Qt::CaseInsensitive) < 0;
+  case PortTableModel::Host:
+    return a.host.compare(b.host, Qt::CaseInsensitive) < 0;
+  case PortTableModel::Namespace:
+    return a.netnsOwner.compare(b.netnsOwner, Qt::CaseInsensitive) < 0;
+  case PortTableModel::Protocol:
+    return a.protocol < b.protocol;
+  case PortTableModel::LocalAddress:
+    return a.localAddress < b.localAddress;
+  case PortTableModel::Port:
+    return a.port < b.port;
+  case PortTableModel::State:
+    return a.state < b.state;
+  case PortTableModel::Backlog:
+    return a.acceptQueue < b.acceptQueue;
+  case PortTableModel::SynRecv:
+    return a.synRecv < b.synRecv;
+  case PortTableModel::Drops:
+    return a.dropRate < b.dropRate;
+  case PortTableModel::Queued:
+    return a.queuedBytes() < b.queuedBytes();
+  }
+  return false;
+}
+
+void PortTableModel::sortPorts() {
+  if (m_sortColumn >= Cpu && m_sortColumn <= Threads) {
+    // Sorts by the cached samples; unsampled rows compare as -1
+    const int column = m_sortColumn;
+    const bool ascending = (m_sortOrder == Qt::AscendingOrder);
+    std::stable_sort(m_ports.begin(), m_ports.end(),
+                     [this, column, ascending](const PortInfo &a,
+                                               const PortInfo &b) {
+                       const double va = resourceValue(a, column);
+                       const double vb = resourceValue(b, column);
+                       return ascending ? va < vb : vb < va;
+                     });
+    return;
+  }
+
+  if (m_sortColumn >= 0) {
+    const int column = m_sortColumn;
+    if (m_sortOrder == Qt::AscendingOrder) {
+      std::stable_sort(m_ports.begin(), m_ports.end(),
+                       [column](const PortInfo &a, const PortInfo &b) {
+                         return lessThan(a, b, column);
+                       });
+    } else {
+      std::stable_sort(m_ports.begin(), m_ports.end(),
+                       [column](const PortInfo &a, const PortInfo &b) {
+                         return lessThan(b, a, column);
+                       });
+    }
+    return;
+  }
 
   // Define priority ports (same as dashboard)
   static const QSet<int> priorityPorts = {3000, 5000, 5432,  6379,
@@ -131,12 +554,13 @@ void PortTableModel::setPorts(const QList<PortInfo> &ports) {
         // 3. Finally sort by port number
         return a.port < b.port;
       });
-
-  endResetModel();
 }
 
 void PortTableModel::clear() {
   beginResetModel();
   m_ports.clear();
+  m_display.clear();
+  m_rows.clear();
+  m_groups.clear();
   endResetModel();
 }
@@ -18,6 +18,9 @@
 
 #include "PortMonitor.h"
 #include <QAbstractTableModel>
+#include <QHash>
+
+class ResourceSampler;
 
 class PortTableModel : public QAbstractTableModel {
   Q_OBJECT
@@ -29,10 +32,21 @@ public:
     ProcessName = 0,
     PID,
     User,
+    Unit,
+    Host,
+    Namespace,
     Protocol,
     LocalAddress,
     Port,
     State,
+    Backlog,
+    SynRecv,
+    Drops,
+    Queued,
+    Cpu,
+    Memory,
+    Fds,
+    Threads,
     Action,
     ColumnCount
   };
@@ -44,9 +58,82 @@ public:
   QVariant headerData(int section, Qt::Orientation orientation,
                       int role = Qt::DisplayRole) const override;
 
+  // column < 0 restores the default priority ordering
+  void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
+
   void setPorts(const QList<PortInfo> &ports);
+
+  // The rows the search box lets through; "unit:<name>" matches the unit
+  // column only
+  static QList<PortInfo> filter(const QList<PortInfo> &ports,
+                                const QString &text);
   void clear();
 
+  // Source of the CPU/RSS/fd/thread columns; may stay unset
+  void setResourceSampler(const ResourceSampler *sampler);
+
+  qint64 pidAt(int row) const; // -1 for group rows and other hosts' rows
+
+  // A socket reported by an agent: its process is not on this machine
+  bool isRemoteRow(int row) const;
+
+  // Groups rows under one header row per unit/container, with totals
+  void setGroupByUnit(bool enabled);
+  bool groupByUnit() const { return m_groupByUnit; }
+  bool isGroupRow(int row) const;
+
+  // Rows from a previous session's snapshot, greyed out until a scan lands
+  void setStale(bool stale);
+  bool isStale() const { return m_stale; }
+
 private:
+  // What a row shows beyond the PortInfo strings, formatted once per
+  // snapshot so painting a cell only hands out shared copies
+  struct DisplayRow {
+    qint64 pid = -1;
+    QString port;
+    QString backlog;
+    QString synRecv;
+    QString drops;
+    QString queued;
+    quint8 tone = 0; // Text colour of the row, see toneBrush()
+    bool listening = false;
+    bool remote = false; // From an agent; see PortInfo::host
+    bool dropsAlert = false;
+    bool backlogAlert = false;
+    bool queueGrowing = false;
+  };
+
+  // Formatted CPU/RSS/fd/thread cells of one sampled process
+  struct ResourceText {
+    QString cells[4]; // Cpu, Memory, Fds, Threads
+  };
+
+  struct UnitGroup {
+    QString unit;
+    int listeners = 0;
+    int connections = 0;
+  };
+
+  void sortPorts();
+  void buildRows();
+  void buildDisplay();
+  void buildResourceText();
+  static DisplayRow formatRow(const PortInfo &info);
+  int portIndex(int row) const; // Index into m_ports, -1 for group rows
+  QVariant groupData(const UnitGroup &group, int column, int role) const;
+  double resourceValue(const PortInfo &info, int column) const;
+
+  const ResourceSampler *m_sampler = nullptr;
+
   QList<PortInfo> m_ports;
+  QList<DisplayRow> m_display; // Parallel to m_ports
+  QHash<qint64, ResourceText> m_resourceText;
+  // Grouped mode only: >= 0 indexes m_ports, -(n + 1) is header of group n
+  QList<int> m_rows;
+  QList<UnitGroup> m_groups;
+  bool m_groupByUnit = false;
+  bool m_stale = false;
+  int m_sortColumn = -1;
+  Qt::SortOrder m_sortOrder = Qt::AscendingOrder;
 };
@@ -0,0 +1,275 @@
+/*
+ * Copyright 2025 Kadir Mert Abatay
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ProbeEngine.h"
+#include <QTcpSocket>
+#include <cmath>
+
+// Bucket i covers [1.05^i, 1.05^(i+1)) microseconds
+static const double kBucketsPerLn = 1.0 / std::log(1.05);
+
+// Percentiles are computed over this window plus the previous one
+static const qint64 kWindowMs = 60000;
+
+void LatencyHistogram::record(qint64 micros) {
+  int bucket = 0;
+  if (micros > 1)
+    bucket = int(std::log(double(micros)) * kBucketsPerLn);
+  m_buckets[qBound(0, bucket, kBuckets - 1)]++;
+  m_count++;
+}
+
+void LatencyHistogram::merge(const LatencyHistogram &other) {
+  for (int i = 0; i < kBuckets; ++i)
+    m_buckets[i] += other.m_buckets[i];
+  m_count += other.m_count;
+}
+
+void LatencyHistogram::clear() {
+  m_buckets.fill(0);
+  m_count = 0;
+}
+
+double LatencyHistogram::percentile(double q) const {
+  if (m_count == 0)
+    return -1;
+  qint64 rank = qMax<qint64>(1, qint64(std::ceil(q * m_count)));
+  qint64 seen = 0;
+  for (int i = 0; i < kBuckets; ++i) {
+    seen += m_buckets[i];
+    if (seen >= rank) {
+      // Geometric middle of the bucket, in milliseconds
+      return std::exp((i + 0.5) / kBucketsPerLn) / 1000.0;
+    }
+  }
+  return std::exp(kBuckets / kBucketsPerLn) / 1000.0;
+}
+
+ProbeEngine::ProbeEngine(QObject *parent) : QObject(parent) {
+  qRegisterMetaType<ProbeStats>();
+  m_clock.start();
+
+  // One timer drives every target and sweeps timed-out probes
+  m_tick = new QTimer(this);
+  m_tick->setInterval(50);
+  connect(m_tick, &QTimer::timeout, this, &ProbeEngine::schedule);
+}
+
+ProbeEngine::~ProbeEngine() {
+  for (auto it = m_probes.begin(); it != m_probes.end(); ++it) {
+    it.key()->disconnect(this);
+    it.key()->abort();
+  }
+}
+
+QString ProbeEngine::targetKey(const QString &host, int port) {
+  return host.contains(':') ? QString("[%1]:%2").arg(host).arg(port)
+                            : QString("%1:%2").arg(host).arg(port);
+}
+
+QString ProbeEngine::probeHost(const QString &localAddress) {
+  QString host = localAddress;
+  if (host.startsWith('[') && host.endsWith(']'))
+    host = host.mid(1, host.size() - 2);
+  if (host.isEmpty() || host == "*" || host == "0.0.0.0")
+    return "127.0.0.1";
+  if (host == "::")
+    return "::1";
+  return host;
+}
+
+void ProbeEngine::watch(const QString &host, int port, int intervalMs) {
+  const QString key = targetKey(host, port);
+  Target &target = m_targets[key];
+  target.host = host;
+  target.port = port;
+  target.intervalMs = qMax(100, intervalMs);
+  if (target.windowStartMs == 0)
+    target.windowStartMs = m_clock.elapsed();
+  if (!m_tick->isActive())
+    m_tick->start();
+  schedule();
+}
+
+void ProbeEngine::unwatch(const QString &host, int port) {
+  auto it = m_targets.find(targetKey(host, port));
+  if (it == m_targets.end())
+    return;
+  // Dropped by schedule() once its probes report back; erasing here could
+  // pull the target out from under a running schedule() via a slot
+  it->intervalMs = 0;
+}
+
+QList<QString> ProbeEngine::watchedTargets() const {
+  QList<QString> keys;
+  for (auto it = m_targets.cbegin(); it != m_targets.cend(); ++it) {
+    if (it->intervalMs > 0)
+      keys.append(it.key());
+  }
+  return keys;
+}
+
+void ProbeEngine::burst(const QString &host, int port, int count,
+                        int concurrency) {
+  const QString key = targetKey(host, port);
+  Target &target = m_targets[key];
+  target.host = host;
+  target.port = port;
+  target.burstRemaining += qMax(1, count);
+  target.burstConcurrency = qMax(1, concurrency);
+  if (target.windowStartMs == 0)
+    target.windowStartMs = m_clock.elapsed();
+  if (!m_tick->isActive())
+    m_tick->start();
+  schedule();
+}
+
+ProbeStats ProbeEngine::stats(const QString &key) const {
+  auto it = m_targets.constFind(key);
+  if (it == m_targets.constEnd()) {
+    ProbeStats empty;
+    empty.target = key;
+    return empty;
+  }
+  return makeStats(key, it.value());
+}
+
+void ProbeEngine::resetStats(const QString &key) {
+  auto it = m_targets.find(key);
+  if (it == m_targets.end())
+    return;
+  it->attempts = 0;
+  it->failures = 0;
+  it->lastMs = -1;
+  it->current.clear();
+  it->previous.clear();
+  it->windowStartMs = m_clock.elapsed();
+}
+
+ProbeStats ProbeEngine::makeStats(const QString &key,
+                                  const Target &target) const {
+  LatencyHistogram merged = target.previous;
+  merged.merge(target.current);
+
+  ProbeStats stats;
+  stats.target = key;
+  stats.attempts = target.attempts;
+  stats.failures = target.failures;
+  stats.lastMs = target.lastMs;
+  stats.p50Ms = merged.percentile(0.50);
+  stats.p99Ms = merged.percentile(0.99);
+  return stats;
+}
+
+void ProbeEngine::schedule() {
+  const qint64 nowMs = m_clock.elapsed();
+  const qint64 nowNs = m_clock.nsecsElapsed();
+
+  // Sweep probes that neither connected nor failed in time
+  QList<QTcpSocket *> expired;
+  for (auto it = m_probes.cbegin(); it != m_probes.cend(); ++it) {
+    if (nowNs - it->startedNs > qint64(m_timeoutMs) * 1000000)
+      expired.append(it.key());
+  }
+  for (QTcpSocket *socket : expired)
+    finish(socket, false);
+
+  for (auto it = m_targets.begin(); it != m_targets.end(); ++it) {
+    Target &target = it.value();
+    while (target.burstRemaining > 0 &&
+           target.burstInFlight < target.burstConcurrency &&
+           m_probes.size() < m_maxInFlight) {
+      target.burstRemaining--;
+      launch(it.key(), target, true);
+    }
+    if (target.intervalMs > 0 && target.inFlight == 0 &&
+        target.nextDueMs <= nowMs && m_probes.size() < m_maxInFlight) {
+      target.nextDueMs = nowMs + target.intervalMs;
+      launch(it.key(), target, false);
+    }
+  }
+
+  // Burst-only and unwatched targets go once their last probe is back
+  for (auto it = m_targets.begin(); it != m_targets.end();) {
+    if (it->intervalMs == 0 && it->burstRemaining == 0 && it->inFlight == 0)
+      it = m_targets.erase(it);
+    else
+      ++it;
+  }
+
+  if (m_targets.isEmpty() && m_probes.isEmpty())
+    m_tick->stop();
+}
+
+void ProbeEngine::launch(const QString &key, Target &target, bool burst) {
+  QTcpSocket *socket = new QTcpSocket(this);
+  target.inFlight++;
+  if (burst)
+    target.burstInFlight++;
+  m_probes.insert(socket, {key, socket, m_clock.nsecsElapsed(), burst});
+
+  connect(socket, &QTcpSocket::connected, this,
+          [this, socket]() { finish(socket, true); });
+  connect(socket, &QTcpSocket::errorOccurred, this,
+          [this, socket](QAbstractSocket::SocketError) {
+            finish(socket, false);
+          });
+  socket->connectToHost(target.host, quint16(target.port));
+}
+
+void ProbeEngine::finish(QTcpSocket *socket, bool ok) {
+  auto probeIt = m_probes.find(socket);
+  if (probeIt == m_probes.end())
+    return;
+  const Probe probe = probeIt.value();
+  m_probes.erase(probeIt);
+
+  const qint64 elapsedNs = m_clock.nsecsElapsed() - probe.startedNs;
+  socket->disconnect(this);
+  socket->abort();
+  socket->deleteLater();
+
+  auto it = m_targets.find(probe.key);
+  if (it == m_targets.end())
+    return;
+  Target &target = it.value();
+  target.inFlight--;
+  if (probe.burst)
+    target.burstInFlight--;
+  target.attempts++;
+
+  const qint64 nowMs = m_clock.elapsed();
+  if (nowMs - target.windowStartMs >= kWindowMs) {
+    target.previous = target.current;
+    target.current.clear();
+    target.windowStartMs = nowMs;
+  }
+
+  if (ok) {
+    target.current.record(elapsedNs / 1000);
+    target.lastMs = elapsedNs / 1.0e6;
+  } else {
+    target.failures++;
+    target.lastMs = -1;
+  }
+
+  const ProbeStats stats = makeStats(probe.key, target);
+  const bool burstDone = probe.burst && target.burstRemaining == 0 &&
+                         target.burstInFlight == 0;
+  emit statsUpdated(stats);
+  if (burstDone)
+    emit burstFinished(stats);
+}
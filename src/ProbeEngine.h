@@ -0,0 +1,136 @@
+/*
+ * Copyright 2025 Kadir Mert Abatay
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QMetaType>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+#include <array>
+
+class QTcpSocket;
+
+// Connect latencies in logarithmic buckets, ~5% apart, from 1 µs to a few
+// minutes. Percentiles are accurate to one bucket, memory stays fixed.
+class LatencyHistogram {
+public:
+  void record(qint64 micros);
+  void merge(const LatencyHistogram &other);
+  void clear();
+
+  qint64 count() const { return m_count; }
+  // Latency in milliseconds at quantile q (0..1), -1 when empty
+  double percentile(double q) const;
+
+private:
+  static constexpr int kBuckets = 400;
+  std::array<quint32, kBuckets> m_buckets{};
+  qint64 m_count = 0;
+};
+
+struct ProbeStats {
+  QString target; // "host:port"
+  qint64 attempts = 0;
+  qint64 failures = 0;
+  double lastMs = -1; // -1 when the last probe failed
+  double p50Ms = -1;
+  double p99Ms = -1;
+
+  double failureRate() const {
+    return attempts > 0 ? double(failures) / attempts : 0;
+  }
+};
+
+Q_DECLARE_METATYPE(ProbeStats)
+
+// Non-blocking TCP connect probes against many targets from one event loop.
+// Each target is probed periodically (one probe in flight at a time) or in
+// bursts of concurrent probes; every result lands in the target's histogram.
+// Percentiles cover roughly the last one to two minutes.
+class ProbeEngine : public QObject {
+  Q_OBJECT
+
+public:
+  explicit ProbeEngine(QObject *parent = nullptr);
+  ~ProbeEngine();
+
+  static QString targetKey(const QString &host, int port);
+
+  // Address to connect to for a socket bound to `localAddress` (as lsof
+  // prints it); wildcard binds are probed over loopback
+  static QString probeHost(const QString &localAddress);
+
+  // Probes `host:port` every `intervalMs` until removed
+  void watch(const QString &host, int port, int intervalMs = 2000);
+  void unwatch(const QString &host, int port);
+  QList<QString> watchedTargets() const;
+
+  // Runs `count` probes with up to `concurrency` in flight; burstFinished()
+  // follows the last one
+  void burst(const QString &host, int port, int count, int concurrency);
+
+  ProbeStats stats(const QString &key) const;
+  void resetStats(const QString &key);
+
+  void setTimeout(int ms) { m_timeoutMs = ms; }
+  // Upper bound on probes in flight across all targets
+  void setMaxInFlight(int count) { m_maxInFlight = count; }
+
+signals:
+  void statsUpdated(const ProbeStats &stats);
+  void burstFinished(const ProbeStats &stats);
+
+private:
+  struct Target {
+    QString host;
+    int port = 0;
+    int intervalMs = 0; // 0 for burst-only targets
+    qint64 nextDueMs = 0;
+    int inFlight = 0;
+    int burstInFlight = 0;
+    int burstRemaining = 0;
+    int burstConcurrency = 1;
+    qint64 attempts = 0;
+    qint64 failures = 0;
+    double lastMs = -1;
+    // Two generations, rotated every kWindowMs
+    LatencyHistogram current;
+    LatencyHistogram previous;
+    qint64 windowStartMs = 0;
+  };
+  struct Probe {
+    QString key;
+    QTcpSocket *socket = nullptr;
+    qint64 startedNs = 0;
+    bool burst = false;
+  };
+
+  void schedule();
+  void launch(const QString &key, Target &target, bool burst);
+  void finish(QTcpSocket *socket, bool ok);
+  ProbeStats makeStats(const QString &key, const Target &target) const;
+
+  QHash<QString, Target> m_targets;
+  QHash<QTcpSocket *, Probe> m_probes;
+  QTimer *m_tick;
+  QElapsedTimer m_clock;
+  int m_timeoutMs = 2000;
+  int m_maxInFlight = 32;
+};
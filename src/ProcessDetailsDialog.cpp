@@ -17,12 +17,13 @@
 #include "ProcessDetailsDialog.h"
 #include <QApplication>
 #include <QClipboard>
-#include <QElapsedTimer>
 #include <QFrame>
 #include <QHBoxLayout>
-#include <QProcess>
 #include <QPushButton>
-#include <QTcpSocket>
+
+// Probes per "Test Connection" click and how many run at once
+static const int kTestProbes = 20;
+static const int kTestConcurrency = 4;
 
 ProcessDetailsDialog::ProcessDetailsDialog(const PortInfo &info,
                                            QWidget *parent)
@@ -30,6 +31,24 @@ ProcessDetailsDialog::ProcessDetailsDialog(const PortInfo &info,
   setWindowTitle("Process Details");
   setMinimumWidth(500);
   setupUi();
+
+  m_probeEngine = new ProbeEngine(this);
+  m_probeKey = ProbeEngine::targetKey(
+      ProbeEngine::probeHost(m_info.localAddress), m_info.port);
+  connect(m_probeEngine, &ProbeEngine::statsUpdated, this,
+          &ProcessDetailsDialog::onProbeStats);
+  connect(m_probeEngine, &ProbeEngine::burstFinished, this,
+          &ProcessDetailsDialog::onProbeBurstFinished);
+
+  // Fill in from the cache right away, then re-validate in the background
+  qint64 pid = m_info.pid.toLongLong();
+  ProcessInfoCache *cache = ProcessInfoCache::instance();
+  connect(cache, &ProcessInfoCache::detailsReady, this,
+          &ProcessDetailsDialog::onProcessDetailsReady);
+  ProcessDetails cached = cache->cached(pid, m_info.startTime);
+  if (cached.valid)
+    applyProcessDetails(cached);
+  cache->request(pid);
 }
 
 void ProcessDetailsDialog::setupUi() {
@@ -63,6 +82,14 @@ void ProcessDetailsDialog::setupUi() {
       createDetailRow("Local Address", m_info.localAddress));
   detailsLayout->addWidget(
       createDetailRow("Port", QString::number(m_info.port)));
+  detailsLayout->addWidget(
+      createDetailRow("Parent PID", "Loading...", &m_parentPidLabel));
+  detailsLayout->addWidget(
+      createDetailRow("Started", "Loading...", &m_startedLabel));
+  detailsLayout->addWidget(
+      createDetailRow("Executable", "Loading...", &m_executableLabel));
+  detailsLayout->addWidget(
+      createDetailRow("Working Dir", "Loading...", &m_workingDirLabel));
 
   mainLayout->addWidget(detailsFrame);
 
@@ -77,7 +104,7 @@ void ProcessDetailsDialog::setupUi() {
   m_cmdArgsText->setStyleSheet(
       "background-color: #1e1e1e; color: #aaa; border: 1px solid #444; "
       "border-radius: 4px; padding: 5px;");
-  m_cmdArgsText->setText(getCommandLine(m_info.pid));
+  m_cmdArgsText->setText("Loading...");
   mainLayout->addWidget(m_cmdArgsText);
 
   // --- Connection Test Section ---
@@ -128,7 +155,8 @@ void ProcessDetailsDialog::setupUi() {
 }
 
 QWidget *ProcessDetailsDialog::createDetailRow(const QString &label,
-                                               const QString &value) {
+                                               const QString &value,
+                                               QLabel **valueLabel) {
   QWidget *rowWidget = new QWidget(this);
   QHBoxLayout *layout = new QHBoxLayout(rowWidget);
   layout->setContentsMargins(10, 5, 10, 5);
@@ -145,20 +173,45 @@ QWidget *ProcessDetailsDialog::createDetailRow(const QString &label,
   layout->addWidget(lbl);
   layout->addWidget(val);
 
+  if (valueLabel)
+    *valueLabel = val;
   return rowWidget;
 }
 
-QString ProcessDetailsDialog::getCommandLine(const QString &pid) {
-  QProcess p;
-  // 'ps -p PID -o args=' gets the arguments without header
-  p.start("ps", QStringList() << "-p" << pid << "-o" << "args=");
-  if (p.waitForFinished(1000)) {
-    QString output = p.readAllStandardOutput().trimmed();
-    if (!output.isEmpty()) {
-      return output;
-    }
+void ProcessDetailsDialog::onProcessDetailsReady(
+    qint64 pid, const ProcessDetails &details) {
+  if (pid != m_info.pid.toLongLong())
+    return;
+  // The PID was reused since the scan: the process we were opened for is gone
+  if (m_info.startTime != 0 && details.startTime != m_info.startTime) {
+    applyProcessDetails(ProcessDetails());
+    return;
+  }
+  applyProcessDetails(details);
+}
+
+void ProcessDetailsDialog::applyProcessDetails(const ProcessDetails &details) {
+  if (!details.valid) {
+    const QString gone = "Unavailable (process exited)";
+    m_parentPidLabel->setText(gone);
+    m_startedLabel->setText(gone);
+    m_executableLabel->setText(gone);
+    m_workingDirLabel->setText(gone);
+    m_cmdArgsText->setText("Unavailable");
+    return;
   }
-  return "Unavailable";
+
+  auto orUnavailable = [](const QString &value) {
+    return value.isEmpty() ? QString("Unavailable") : value;
+  };
+  m_parentPidLabel->setText(QString::number(details.parentPid));
+  m_startedLabel->setText(
+      details.started.isValid()
+          ? details.started.toString("yyyy-MM-dd HH:mm:ss")
+          : QString("Unavailable"));
+  m_executableLabel->setText(orUnavailable(details.executable));
+  m_workingDirLabel->setText(orUnavailable(details.workingDirectory));
+  m_cmdArgsText->setText(orUnavailable(details.commandLine));
 }
 
 void ProcessDetailsDialog::onTestConnectionClicked() {
@@ -166,39 +219,37 @@ void ProcessDetailsDialog::onTestConnectionClicked() {
   m_connectionStatusLabel->setStyleSheet("color: #e6e600;"); // Yellow
   m_testConnBtn->setEnabled(false);
 
-  QTcpSocket *socket = new QTcpSocket(this);
-  QElapsedTimer *timer = new QElapsedTimer();
-  timer->start();
+  // Wildcard binds are probed over loopback
+  m_probeEngine->burst(ProbeEngine::probeHost(m_info.localAddress),
+                       m_info.port, kTestProbes, kTestConcurrency);
+}
 
-  // Handle potential wildcards or empty addresses by defaulting to localhost
-  QString targetAddr = m_info.localAddress;
-  if (targetAddr == "*" || targetAddr == "0.0.0.0" || targetAddr == "[::]" ||
-      targetAddr.isEmpty()) {
-    targetAddr = "127.0.0.1";
-  }
+void ProcessDetailsDialog::onProbeStats(const ProbeStats &stats) {
+  if (stats.target != m_probeKey || m_testConnBtn->isEnabled())
+    return;
+  m_connectionStatusLabel->setText(
+      QString("Probing... %1/%2").arg(stats.attempts).arg(kTestProbes));
+}
+
+void ProcessDetailsDialog::onProbeBurstFinished(const ProbeStats &stats) {
+  if (stats.target != m_probeKey)
+    return;
+  m_testConnBtn->setEnabled(true);
 
-  // Connect signals properly
-  connect(socket, &QTcpSocket::connected, this, [this, socket, timer]() {
-    qint64 elapsed = timer->elapsed();
-    m_connectionStatusLabel->setText(
-        QString("Success! Latency: %1 ms").arg(elapsed));
+  if (stats.failures == stats.attempts) {
+    m_connectionStatusLabel->setText("Connection Failed");
     m_connectionStatusLabel->setStyleSheet(
-        "color: #81c784; font-weight: bold;"); // Green
-    socket->disconnectFromHost();
-    m_testConnBtn->setEnabled(true);
-    socket->deleteLater();
-    delete timer;
-  });
+        "color: #e74c3c; font-weight: bold;"); // Red
+    return;
+  }
 
-  connect(socket, &QTcpSocket::errorOccurred, this,
-          [this, socket, timer](QAbstractSocket::SocketError) {
-            m_connectionStatusLabel->setText("Connection Failed");
-            m_connectionStatusLabel->setStyleSheet(
-                "color: #e74c3c; font-weight: bold;"); // Red
-            m_testConnBtn->setEnabled(true);
-            socket->deleteLater();
-            delete timer;
-          });
-
-  socket->connectToHost(targetAddr, m_info.port);
+  m_connectionStatusLabel->setText(
+      QString("p50 %1 ms · p99 %2 ms · %3% failed (%4 probes)")
+          .arg(stats.p50Ms, 0, 'f', 2)
+          .arg(stats.p99Ms, 0, 'f', 2)
+          .arg(stats.failureRate() * 100, 0, 'f', 0)
+          .arg(stats.attempts));
+  m_connectionStatusLabel->setStyleSheet(
+      stats.failures == 0 ? "color: #81c784; font-weight: bold;"  // Green
+                          : "color: #e6e600; font-weight: bold;"); // Yellow
 }
@@ -17,6 +17,8 @@
 #pragma once
 
 #include "PortMonitor.h"
+#include "ProbeEngine.h"
+#include "ProcessInfoCache.h"
 #include <QDialog>
 #include <QLabel>
 #include <QTextEdit>
@@ -31,14 +33,24 @@ public:
 
 private slots:
   void onTestConnectionClicked();
+  void onProcessDetailsReady(qint64 pid, const ProcessDetails &details);
+  void onProbeStats(const ProbeStats &stats);
+  void onProbeBurstFinished(const ProbeStats &stats);
 
 private:
   void setupUi();
-  QWidget *createDetailRow(const QString &label, const QString &value);
-  QString getCommandLine(const QString &pid);
+  QWidget *createDetailRow(const QString &label, const QString &value,
+                           QLabel **valueLabel = nullptr);
+  void applyProcessDetails(const ProcessDetails &details);
 
   PortInfo m_info;
+  QLabel *m_parentPidLabel;
+  QLabel *m_startedLabel;
+  QLabel *m_executableLabel;
+  QLabel *m_workingDirLabel;
   QTextEdit *m_cmdArgsText;
   QLabel *m_connectionStatusLabel;
   QPushButton *m_testConnBtn;
+  ProbeEngine *m_probeEngine;
+  QString m_probeKey;
 };
@@ -0,0 +1,213 @@
+/*
+ * Copyright 2025 Kadir Mert Abatay
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ProcessInfoCache.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QMutex>
+#include <QProcess>
+#include <QThreadPool>
+
+#ifdef Q_OS_UNIX
+#include <pwd.h>
+#include <unistd.h>
+#endif
+
+ProcessInfoCache::ProcessInfoCache(QObject *parent) : QObject(parent) {
+  qRegisterMetaType<ProcessDetails>();
+}
+
+ProcessInfoCache *ProcessInfoCache::instance() {
+  static ProcessInfoCache *cache = new ProcessInfoCache();
+  return cache;
+}
+
+ProcessDetails ProcessInfoCache::cached(qint64 pid, quint64 startTime) const {
+  ProcessDetails details = m_entries.value(pid);
+  if (startTime != 0 && details.startTime != startTime)
+    return ProcessDetails();
+  return details;
+}
+
+void ProcessInfoCache::request(qint64 pid) {
+  if (pid <= 0 || m_inFlight.contains(pid))
+    return;
+  m_inFlight.insert(pid);
+
+  QThreadPool::globalInstance()->start([this, pid]() {
+    ProcessDetails details = readProcess(pid);
+    details.pid = pid;
+    QMetaObject::invokeMethod(
+        this, [this, details]() { onLoaded(details); }, Qt::QueuedConnection);
+  });
+}
+
+void ProcessInfoCache::onLoaded(const ProcessDetails &details) {
+  m_inFlight.remove(details.pid);
+  if (details.valid)
+    m_entries.insert(details.pid, details);
+  else
+    m_entries.remove(details.pid);
+  emit detailsReady(details.pid, details);
+}
+
+void ProcessInfoCache::retainOnly(const QSet<qint64> &livePids) {
+  for (auto it = m_entries.begin(); it != m_entries.end();) {
+    if (!livePids.contains(it.key()))
+      it = m_entries.erase(it);
+    else
+      ++it;
+  }
+}
+
+static QString userNameForUid(uint uid) {
+  // getpwuid_r may hit NSS (LDAP, ...); remember every answer
+  static QMutex mutex;
+  static QHash<uint, QString> names;
+  QMutexLocker locker(&mutex);
+  auto it = names.constFind(uid);
+  if (it != names.constEnd())
+    return it.value();
+
+  QString name = QString::number(uid);
+#ifdef Q_OS_UNIX
+  passwd pwd;
+  passwd *result = nullptr;
+  char buffer[4096];
+  if (getpwuid_r(uid, &pwd, buffer, sizeof(buffer), &result) == 0 && result)
+    name = QString::fromLocal8Bit(pwd.pw_name);
+#endif
+  names.insert(uid, name);
+  return name;
+}
+
+QString ProcessInfoCache::userName(uint uid) { return userNameForUid(uid); }
+
+#ifdef Q_OS_LINUX
+
+static QByteArray readProcFile(qint64 pid, const char *name) {
+  QFile file(QString("/proc/%1/%2").arg(pid).arg(name));
+  if (!file.open(QIODevice::ReadOnly))
+    return QByteArray();
+  return file.readAll();
+}
+
+// Fields of /proc/<pid>/stat after the "(comm)" field, which may itself
+// contain spaces and parentheses
+static QList<QByteArray> statFields(const QByteArray &stat) {
+  int end = stat.lastIndexOf(')');
+  if (end < 0)
+    return {};
+  return stat.mid(end + 2).split(' ');
+}
+
+static QDateTime bootTime() {
+  static const QDateTime boot = []() {
+    QFile file("/proc/stat");
+    if (file.open(QIODevice::ReadOnly)) {
+      for (const QByteArray &line : file.readAll().split('\n')) {
+        if (line.startsWith("btime ")) {
+          return QDateTime::fromSecsSinceEpoch(
+              line.mid(6).trimmed().toLongLong());
+        }
+      }
+    }
+    return QDateTime();
+  }();
+  return boot;
+}
+
+quint64 ProcessInfoCache::readStartTime(qint64 pid) {
+  // Field 22 (starttime) is index 19 after the comm field
+  const QList<QByteArray> fields = statFields(readProcFile(pid, "stat"));
+  return fields.size() > 19 ? fields[19].toULongLong() : 0;
+}
+
+ProcessDetails ProcessInfoCache::readProcess(qint64 pid) {
+  ProcessDetails details;
+  details.pid = pid;
+
+  const QList<QByteArray> fields = statFields(readProcFile(pid, "stat"));
+  if (fields.size() <= 19)
+    return details; // Gone
+  details.parentPid = fields[1].toLongLong();
+  details.startTime = fields[19].toULongLong();
+
+  static const long ticksPerSecond = sysconf(_SC_CLK_TCK);
+  if (bootTime().isValid() && ticksPerSecond > 0) {
+    details.started =
+        bootTime().addMSecs(qint64(details.startTime * 1000 / ticksPerSecond));
+  }
+
+  QByteArray cmdline = readProcFile(pid, "cmdline");
+  cmdline.replace('\0', ' ');
+  details.commandLine = QString::fromLocal8Bit(cmdline).trimmed();
+
+  details.executable =
+      QFileInfo(QString("/proc/%1/exe").arg(pid)).symLinkTarget();
+  details.workingDirectory =
+      QFileInfo(QString("/proc/%1/cwd").arg(pid)).symLinkTarget();
+
+  for (const QByteArray &line : readProcFile(pid, "status").split('\n')) {
+    if (line.startsWith("Uid:")) {
+      details.uid = line.mid(4).simplified().split(' ').value(0).toUInt();
+      details.userName = userNameForUid(details.uid);
+      break;
+    }
+  }
+
+  // If the PID was recycled while we were reading, the pieces above may
+  // belong to two processes; report it as gone and let the next scan retry
+  details.valid = (readStartTime(pid) == details.startTime);
+  return details;
+}
+
+#else
+
+quint64 ProcessInfoCache::readStartTime(qint64 pid) {
+  return quint64(readProcess(pid).startTime);
+}
+
+ProcessDetails ProcessInfoCache::readProcess(qint64 pid) {
+  ProcessDetails details;
+  details.pid = pid;
+
+  // No /proc here: one ps call, made from the worker thread
+  QProcess ps;
+  ps.start("ps", QStringList() << "-p" << QString::number(pid) << "-o"
+                               << "ppid=,uid=,lstart=,args=");
+  if (!ps.waitForFinished(1000))
+    return details;
+
+  // lstart is a fixed five-token date, e.g. "Mon Jan  6 09:15:02 2025"
+  const QString output = QString::fromLocal8Bit(ps.readAllStandardOutput());
+  const QStringList parts = output.simplified().split(' ');
+  if (parts.size() < 7)
+    return details;
+
+  details.parentPid = parts[0].toLongLong();
+  details.uid = parts[1].toUInt();
+  details.userName = userNameForUid(details.uid);
+  details.started = QDateTime::fromString(parts.mid(2, 5).join(' '),
+                                          "ddd MMM d HH:mm:ss yyyy");
+  details.startTime = quint64(details.started.toSecsSinceEpoch());
+  details.commandLine = parts.mid(7).join(' ');
+  details.executable = parts.value(7);
+  details.valid = true;
+  return details;
+}
+
+#endif
@@ -0,0 +1,80 @@
+/*
+ * Copyright 2025 Kadir Mert Abatay
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <QDateTime>
+#include <QHash>
+#include <QMetaType>
+#include <QObject>
+#include <QSet>
+#include <QString>
+
+struct ProcessDetails {
+  qint64 pid = 0;
+  // Process start time (clock ticks since boot on Linux). Together with the
+  // PID it identifies a process; a reused PID gets a different start time.
+  quint64 startTime = 0;
+  qint64 parentPid = -1;
+  uint uid = 0;
+  QString userName;
+  QString commandLine;
+  QString executable;
+  QString workingDirectory;
+  QDateTime started;
+  bool valid = false; // False when the process is gone or unreadable
+};
+
+Q_DECLARE_METATYPE(ProcessDetails)
+
+// Process metadata read from /proc on a worker thread and cached per
+// (pid, start time). Entries are dropped as soon as a scan no longer sees
+// the PID, and a reload that finds a different start time replaces the
+// entry, so a reused PID never shows the previous owner's data.
+class ProcessInfoCache : public QObject {
+  Q_OBJECT
+
+public:
+  static ProcessInfoCache *instance();
+
+  // Returns the cached entry (invalid if none) without touching /proc. With
+  // a known `startTime`, an entry for an earlier process that had the same
+  // PID counts as none.
+  ProcessDetails cached(qint64 pid, quint64 startTime = 0) const;
+
+  // Loads or re-validates the entry asynchronously; detailsReady() follows
+  void request(qint64 pid);
+
+  // Forgets every PID not in `livePids`, i.e. processes that have exited
+  void retainOnly(const QSet<qint64> &livePids);
+
+  // Synchronous read, safe to call from any thread
+  static ProcessDetails readProcess(qint64 pid);
+  static quint64 readStartTime(qint64 pid);
+
+  // User name for a uid, resolved once per uid; safe from any thread
+  static QString userName(uint uid);
+
+signals:
+  void detailsReady(qint64 pid, const ProcessDetails &details);
+
+private:
+  explicit ProcessInfoCache(QObject *parent = nullptr);
+  void onLoaded(const ProcessDetails &details);
+
+  QHash<qint64, ProcessDetails> m_entries;
+  QSet<qint64> m_inFlight;
+};
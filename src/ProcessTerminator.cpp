@@ -0,0 +1,238 @@
+/*
+ * Copyright 2025 Kadir Mert Abatay
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ProcessTerminator.h"
+#include "ProcessInfoCache.h"
+#include <QSocketNotifier>
+
+#ifdef Q_OS_UNIX
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <unistd.h>
+#endif
+#ifdef Q_OS_LINUX
+#include <sys/syscall.h>
+#endif
+
+// How long to wait for the exit once SIGKILL has been sent
+static const int kKillWaitMs = 2000;
+
+#ifdef Q_OS_UNIX
+
+// glibc only wraps these since 2.36; go through syscall(2) directly
+static int pidfdOpen(qint64 pid) {
+#ifdef SYS_pidfd_open
+  return int(syscall(SYS_pidfd_open, pid_t(pid), 0));
+#else
+  Q_UNUSED(pid);
+  errno = ENOSYS;
+  return -1;
+#endif
+}
+
+static int pidfdSendSignal(int pidfd, int signal) {
+#ifdef SYS_pidfd_send_signal
+  return int(syscall(SYS_pidfd_send_signal, pidfd, signal, nullptr, 0));
+#else
+  Q_UNUSED(pidfd);
+  Q_UNUSED(signal);
+  errno = ENOSYS;
+  return -1;
+#endif
+}
+
+#endif
+
+ProcessTerminator::ProcessTerminator(QObject *parent) : QObject(parent) {
+  m_clock.start();
+  m_tick = new QTimer(this);
+  m_tick->setInterval(100);
+  connect(m_tick, &QTimer::timeout, this, &ProcessTerminator::tick);
+}
+
+ProcessTerminator::~ProcessTerminator() {
+  for (Pending &pending : m_pending)
+    release(pending);
+}
+
+void ProcessTerminator::terminate(qint64 pid, quint64 startTime,
+                                  bool graceful) {
+  auto existing = m_pending.find(pid);
+  if (existing != m_pending.end()) {
+    if (!graceful && !existing->killSent)
+      existing->deadlineMs = 0; // The next tick sends SIGKILL
+    return;
+  }
+
+#ifdef Q_OS_UNIX
+  Pending pending;
+#ifdef Q_OS_LINUX
+  pending.pidfd = pidfdOpen(pid);
+  if (pending.pidfd < 0 && errno == ESRCH) {
+    emit finished(pid, true, "Process had already exited");
+    return;
+  }
+  if (pending.pidfd < 0 && errno != ENOSYS) {
+    emit finished(pid, false, QString::fromLocal8Bit(strerror(errno)));
+    return;
+  }
+
+  // With the pidfd held the PID cannot move to another process, so a
+  // matching start time proves this is the process that owned the socket
+  const quint64 current = ProcessInfoCache::readStartTime(pid);
+  if (current == 0 || (startTime != 0 && current != startTime)) {
+    release(pending);
+    if (current == 0)
+      emit finished(pid, true, "Process had already exited");
+    else
+      emit finished(pid, false, "PID now belongs to a different process");
+    return;
+  }
+#else
+  Q_UNUSED(startTime);
+#endif
+
+  QString error;
+  if (!sendSignal(pid, pending, graceful ? SIGTERM : SIGKILL, &error)) {
+    release(pending);
+    if (error.isEmpty())
+      emit finished(pid, true, "Process had already exited");
+    else
+      emit finished(pid, false, error);
+    return;
+  }
+
+  if (pending.pidfd >= 0) {
+    // A pidfd turns readable once the process has exited
+    pending.notifier =
+        new QSocketNotifier(pending.pidfd, QSocketNotifier::Read, this);
+    connect(pending.notifier, &QSocketNotifier::activated, this,
+            [this, pid]() {
+              auto it = m_pending.constFind(pid);
+              finish(pid, true,
+                     (it != m_pending.constEnd() && it->killSent)
+                         ? "Process killed successfully"
+                         : "Process exited after SIGTERM");
+            });
+  }
+  pending.killSent = !graceful;
+  pending.deadlineMs =
+      m_clock.elapsed() + (graceful ? m_gracePeriodMs : kKillWaitMs);
+  m_pending.insert(pid, pending);
+  if (!m_tick->isActive())
+    m_tick->start();
+#else
+  Q_UNUSED(startTime);
+  Q_UNUSED(graceful);
+  emit finished(pid, false, "Ending processes is not supported here");
+#endif
+}
+
+bool ProcessTerminator::sendSignal(qint64 pid, const Pending &pending,
+                                   int signal, QString *error) const {
+#ifdef Q_OS_UNIX
+  // Without a pidfd (old kernel, not Linux) fall back to the bare PID
+  const int rc = (pending.pidfd >= 0) ? pidfdSendSignal(pending.pidfd, signal)
+                                      : ::kill(pid_t(pid), signal);
+  if (rc == 0)
+    return true;
+  // ESRCH: gone already, which is what we wanted; leave `error` empty
+  if (errno != ESRCH)
+    *error = QString::fromLocal8Bit(strerror(errno));
+  return false;
+#else
+  Q_UNUSED(pid);
+  Q_UNUSED(pending);
+  Q_UNUSED(signal);
+  *error = "Ending processes is not supported here";
+  return false;
+#endif
+}
+
+void ProcessTerminator::tick() {
+  const qint64 now = m_clock.elapsed();
+  QList<qint64> exited;
+  QList<qint64> due;
+  for (auto it = m_pending.cbegin(); it != m_pending.cend(); ++it) {
+#ifdef Q_OS_UNIX
+    // Without a pidfd there is nothing to wait on; poll the PID instead
+    if (it->pidfd < 0 && ::kill(pid_t(it.key()), 0) != 0 && errno == ESRCH) {
+      exited.append(it.key());
+      continue;
+    }
+#endif
+    if (it->deadlineMs <= now)
+      due.append(it.key());
+  }
+
+  // Handled outside the loop; finish() emits and slots may call back in
+  for (qint64 pid : exited) {
+    auto it = m_pending.constFind(pid);
+    if (it != m_pending.constEnd())
+      finish(pid, true,
+             it->killSent ? "Process killed successfully"
+                          : "Process exited after SIGTERM");
+  }
+  for (qint64 pid : due)
+    escalate(pid);
+}
+
+void ProcessTerminator::escalate(qint64 pid) {
+  auto it = m_pending.find(pid);
+  if (it == m_pending.end())
+    return;
+  if (it->killSent) {
+    finish(pid, false, "Process did not exit after SIGKILL");
+    return;
+  }
+
+  QString error;
+  if (!sendSignal(pid, it.value(), SIGKILL, &error)) {
+    if (error.isEmpty())
+      finish(pid, true, "Process exited after SIGTERM");
+    else
+      finish(pid, false, error);
+    return;
+  }
+  it->killSent = true;
+  it->deadlineMs = m_clock.elapsed() + kKillWaitMs;
+}
+
+void ProcessTerminator::finish(qint64 pid, bool success,
+                               const QString &message) {
+  auto it = m_pending.find(pid);
+  if (it == m_pending.end())
+    return;
+  release(it.value());
+  m_pending.erase(it);
+  if (m_pending.isEmpty())
+    m_tick->stop();
+  emit finished(pid, success, message);
+}
+
+void ProcessTerminator::release(Pending &pending) {
+  if (pending.notifier) {
+    pending.notifier->setEnabled(false);
+    pending.notifier->deleteLater();
+    pending.notifier = nullptr;
+  }
+#ifdef Q_OS_UNIX
+  if (pending.pidfd >= 0)
+    ::close(pending.pidfd);
+#endif
+  pending.pidfd = -1;
+}
@@ -0,0 +1,69 @@
+/*
+ * Copyright 2025 Kadir Mert Abatay
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+#include <QTimer>
+
+class QSocketNotifier;
+
+// Signals processes directly instead of forking kill(1). On Linux each
+// process is pinned with a pidfd and compared against the start time seen
+// when its socket was observed, so a reused PID is never signalled, and the
+// pidfd reports the exit. Other Unixes fall back to kill(2) and polling.
+class ProcessTerminator : public QObject {
+  Q_OBJECT
+
+public:
+  explicit ProcessTerminator(QObject *parent = nullptr);
+  ~ProcessTerminator() override;
+
+  // `startTime` is the /proc start time recorded at scan time (0: unknown).
+  // Graceful sends SIGTERM and escalates to SIGKILL after the grace period.
+  // A PID already being terminated is not signalled twice; a forced request
+  // only cuts its grace period short.
+  void terminate(qint64 pid, quint64 startTime, bool graceful);
+
+  void setGracePeriod(int ms) { m_gracePeriodMs = ms; }
+  int gracePeriod() const { return m_gracePeriodMs; }
+
+signals:
+  // Once per terminated PID: it exited (success) or could not be ended
+  void finished(qint64 pid, bool success, const QString &message);
+
+private:
+  struct Pending {
+    int pidfd = -1;
+    QSocketNotifier *notifier = nullptr;
+    qint64 deadlineMs = 0; // End of the grace period, then of the kill wait
+    bool killSent = false;
+  };
+
+  bool sendSignal(qint64 pid, const Pending &pending, int signal,
+                  QString *error) const;
+  void tick();
+  void escalate(qint64 pid);
+  void finish(qint64 pid, bool success, const QString &message);
+  static void release(Pending &pending);
+
+  QHash<qint64, Pending> m_pending;
+  QTimer *m_tick;
+  QElapsedTimer m_clock;
+  int m_gracePeriodMs = 3000;
+};
@@ -0,0 +1,176 @@
+/*
+ * Copyright 2025 Kadir Mert Abatay
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ResourceSampler.h"
+#include <QDir>
+#include <QFile>
+#include <QPromise>
+#include <QThreadPool>
+#include <memory>
+
+#ifdef Q_OS_LINUX
+#include <unistd.h>
+#endif
+
+ResourceSampler::ResourceSampler(QObject *parent) : QObject(parent) {
+  m_clock.start();
+  m_timer = new QTimer(this);
+  m_timer->setInterval(2000);
+  connect(m_timer, &QTimer::timeout, this, &ResourceSampler::sampleNow);
+  m_watcher = new QFutureWatcher<RawBatch>(this);
+  connect(m_watcher, &QFutureWatcherBase::finished, this, [this]() {
+    const RawBatch batch = m_watcher->result();
+    onSampled(batch.raw, batch.timestampMs);
+  });
+#ifdef Q_OS_LINUX
+  m_timer->start();
+#endif
+}
+
+void ResourceSampler::setInterval(int ms) { m_timer->setInterval(ms); }
+
+void ResourceSampler::setWatchedPids(const QSet<qint64> &pids) {
+  bool unseen = false;
+  for (qint64 pid : pids) {
+    if (!m_samples.contains(pid)) {
+      unseen = true;
+      break;
+    }
+  }
+  m_watched = pids;
+
+  // Rows scrolled into view should not wait for the next tick
+  if (unseen)
+    sampleNow();
+}
+
+void ResourceSampler::retainOnly(const QSet<qint64> &livePids) {
+  for (auto it = m_samples.begin(); it != m_samples.end();) {
+    if (!livePids.contains(it.key()))
+      it = m_samples.erase(it);
+    else
+      ++it;
+  }
+  for (auto it = m_baselines.begin(); it != m_baselines.end();) {
+    if (!livePids.contains(it.key()))
+      it = m_baselines.erase(it);
+    else
+      ++it;
+  }
+}
+
+void ResourceSampler::sampleNow() {
+#ifdef Q_OS_LINUX
+  if (m_watched.isEmpty())
+    return;
+  if (m_busy) {
+    // Coalesce requests made while a pass is running into one more pass
+    m_resampleQueued = true;
+    return;
+  }
+  m_busy = true;
+
+  // The worker gets copies and a promise, never `this`
+  const QSet<qint64> pids = m_watched;
+  const QElapsedTimer clock = m_clock;
+  auto promise = std::make_shared<QPromise<RawBatch>>();
+  promise->start();
+  m_watcher->setFuture(promise->future());
+  QThreadPool::globalInstance()->start([promise, pids, clock]() {
+    RawBatch batch;
+    batch.raw.reserve(pids.size());
+    for (qint64 pid : pids) {
+      RawSample sample = readRaw(pid);
+      if (sample.startTime != 0)
+        batch.raw.insert(pid, sample);
+    }
+    batch.timestampMs = clock.elapsed();
+    promise->addResult(batch);
+    promise->finish();
+  });
+#endif
+}
+
+void ResourceSampler::onSampled(const QHash<qint64, RawSample> &raw,
+                                qint64 timestampMs) {
+  m_busy = false;
+
+#ifdef Q_OS_LINUX
+  static const long ticksPerSecond = sysconf(_SC_CLK_TCK);
+#else
+  static const long ticksPerSecond = 100;
+#endif
+
+  for (auto it = raw.cbegin(); it != raw.cend(); ++it) {
+    const RawSample &now = it.value();
+    ResourceSample &sample = m_samples[it.key()];
+    sample.rssBytes = now.rssBytes;
+    sample.openFds = now.openFds;
+    sample.threads = now.threads;
+
+    // CPU% needs a baseline from the same process (same start time)
+    auto base = m_baselines.constFind(it.key());
+    if (base != m_baselines.constEnd() && base->startTime == now.startTime &&
+        timestampMs > base->timestampMs && ticksPerSecond > 0) {
+      double cpuSeconds =
+          double(now.cpuTicks - base->cpuTicks) / double(ticksPerSecond);
+      double wallSeconds = (timestampMs - base->timestampMs) / 1000.0;
+      sample.cpuPercent = 100.0 * cpuSeconds / wallSeconds;
+    } else {
+      sample.cpuPercent = -1;
+    }
+    m_baselines.insert(it.key(), {now.startTime, now.cpuTicks, timestampMs});
+  }
+
+  emit samplesUpdated();
+
+  if (m_resampleQueued) {
+    m_resampleQueued = false;
+    sampleNow();
+  }
+}
+
+ResourceSampler::RawSample ResourceSampler::readRaw(qint64 pid) {
+  RawSample sample;
+#ifdef Q_OS_LINUX
+  QFile statFile(QString("/proc/%1/stat").arg(pid));
+  if (!statFile.open(QIODevice::ReadOnly))
+    return sample;
+  const QByteArray stat = statFile.readAll();
+
+  // Fields after "(comm)"; field N of proc(5) is at index N - 3
+  int end = stat.lastIndexOf(')');
+  if (end < 0)
+    return sample;
+  const QList<QByteArray> fields = stat.mid(end + 2).split(' ');
+  if (fields.size() <= 21)
+    return sample;
+
+  static const long pageSize = sysconf(_SC_PAGESIZE);
+  sample.cpuTicks = fields[11].toULongLong() + fields[12].toULongLong();
+  sample.threads = fields[17].toInt();
+  sample.startTime = fields[19].toULongLong();
+  sample.rssBytes = fields[21].toLongLong() * pageSize;
+
+  // Needs the same privileges as the process owner; -1 otherwise
+  QDir fdDir(QString("/proc/%1/fd").arg(pid));
+  if (fdDir.isReadable())
+    sample.openFds = int(fdDir.count()) - 2; // Minus "." and ".."
+#else
+  Q_UNUSED(pid);
+#endif
+  return sample;
+}
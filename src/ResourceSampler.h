@@ -0,0 +1,89 @@
+/*
+ * Copyright 2025 Kadir Mert Abatay
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <QElapsedTimer>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QTimer>
+
+struct ResourceSample {
+  double cpuPercent = -1; // Needs two samples; -1 until then
+  qint64 rssBytes = -1;
+  int openFds = -1; // -1 when /proc/<pid>/fd is not readable
+  int threads = -1;
+};
+
+// Samples CPU, RSS, open fds and threads from /proc for a small, explicitly
+// watched set of PIDs (the rows on screen and the dashboard owners) instead
+// of every process in the snapshot. Reads run on the thread pool; results
+// are cached until the next sample. Linux only.
+class ResourceSampler : public QObject {
+  Q_OBJECT
+
+public:
+  explicit ResourceSampler(QObject *parent = nullptr);
+
+  void setInterval(int ms);
+  int interval() const { return m_timer->interval(); }
+
+  // PIDs not sampled yet are read right away, the rest on the next tick
+  void setWatchedPids(const QSet<qint64> &pids);
+
+  ResourceSample sample(qint64 pid) const { return m_samples.value(pid); }
+  const QHash<qint64, ResourceSample> &samples() const { return m_samples; }
+
+  // Drops cached samples of processes that are gone
+  void retainOnly(const QSet<qint64> &livePids);
+
+signals:
+  void samplesUpdated();
+
+private:
+  struct RawSample {
+    quint64 startTime = 0;
+    quint64 cpuTicks = 0; // utime + stime
+    qint64 rssBytes = -1;
+    int openFds = -1;
+    int threads = -1;
+  };
+  // One pass of the worker, stamped on m_clock when it finished reading
+  struct RawBatch {
+    QHash<qint64, RawSample> raw;
+    qint64 timestampMs = 0;
+  };
+  struct CpuBaseline {
+    quint64 startTime;
+    quint64 cpuTicks;
+    qint64 timestampMs;
+  };
+
+  void sampleNow();
+  void onSampled(const QHash<qint64, RawSample> &raw, qint64 timestampMs);
+  static RawSample readRaw(qint64 pid);
+
+  QTimer *m_timer;
+  QElapsedTimer m_clock;
+  QFutureWatcher<RawBatch> *m_watcher; // Drops results once we are gone
+  QSet<qint64> m_watched;
+  QHash<qint64, ResourceSample> m_samples;
+  QHash<qint64, CpuBaseline> m_baselines;
+  bool m_busy = false;
+  bool m_resampleQueued = false;
+};
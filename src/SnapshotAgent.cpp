@@ -0,0 +1,109 @@
+/*
+ * Copyright 2025 Kadir Mert Abatay
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "SnapshotAgent.h"
+#include "SnapshotProtocol.h"
+#include <QTcpSocket>
+#include <QTimer>
+
+static const int kMinRetryMs = 1000;
+static const int kMaxRetryMs = 30000;
+
+SnapshotAgent::SnapshotAgent(const QString &hostName, const QString &token,
+                             QObject *parent)
+    : QObject(parent), m_hostName(hostName), m_token(token),
+      m_retryMs(kMinRetryMs) {
+  m_socket = new QTcpSocket(this);
+  connect(m_socket, &QTcpSocket::connected, this, &SnapshotAgent::onConnected);
+  connect(m_socket, &QTcpSocket::bytesWritten, this,
+          &SnapshotAgent::onBytesWritten);
+  connect(m_socket, &QTcpSocket::errorOccurred, this,
+          [this](QAbstractSocket::SocketError) { onError(); });
+
+  m_retryTimer = new QTimer(this);
+  m_retryTimer->setSingleShot(true);
+  connect(m_retryTimer, &QTimer::timeout, this,
+          [this]() { m_socket->connectToHost(m_address, m_port); });
+}
+
+void SnapshotAgent::connectToCollector(const QString &address, quint16 port) {
+  m_address = address;
+  m_port = port;
+  m_retryTimer->stop();
+  m_socket->abort();
+  m_socket->connectToHost(address, port);
+}
+
+bool SnapshotAgent::isConnected() const {
+  return m_socket->state() == QAbstractSocket::ConnectedState;
+}
+
+void SnapshotAgent::publish(const QList<PortInfo> &ports) {
+  const SnapshotDelta delta = m_diff.update(ports);
+  const bool firstScan = !m_hasScan;
+  m_hasScan = true;
+  if (!isConnected())
+    return;
+  if (firstScan) {
+    sendSnapshot(); // Connected before there was anything to send
+    return;
+  }
+  if (!m_synced || delta.isEmpty())
+    return;
+
+  QStringList removed;
+  for (const PortInfo &info : delta.removed)
+    removed.append(SnapshotDiff::key(info));
+  const QByteArray frame = SnapshotProtocol::compress(
+      SnapshotProtocol::delta(delta.added, removed, delta.changed));
+  const qint64 queued = m_socket->bytesToWrite();
+  if (queued > 0 && queued + frame.size() > kMaxBacklogBytes) {
+    m_synced = false; // Resent whole in onBytesWritten()
+    return;
+  }
+  m_socket->write(frame);
+}
+
+void SnapshotAgent::onConnected() {
+  m_retryMs = kMinRetryMs;
+  m_socket->setSocketOption(QAbstractSocket::KeepAliveOption, 1);
+  m_socket->write(SnapshotProtocol::hello(m_hostName, m_token));
+  if (m_hasScan)
+    sendSnapshot();
+  emit connected();
+}
+
+void SnapshotAgent::onBytesWritten() {
+  if (!m_synced && m_hasScan && m_socket->bytesToWrite() == 0)
+    sendSnapshot();
+}
+
+void SnapshotAgent::onError() {
+  const QString error = m_socket->errorString();
+  m_synced = false;
+  m_socket->abort();
+  if (!m_retryTimer->isActive()) {
+    m_retryTimer->start(m_retryMs);
+    m_retryMs = qMin(m_retryMs * 2, kMaxRetryMs);
+  }
+  emit disconnected(error);
+}
+
+void SnapshotAgent::sendSnapshot() {
+  m_socket->write(SnapshotProtocol::compress(
+      SnapshotProtocol::snapshot(m_diff.sockets().values())));
+  m_synced = true;
+}
@@ -0,0 +1,69 @@
+/*
+ * Copyright 2025 Kadir Mert Abatay
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "SnapshotDiff.h"
+#include <QObject>
+
+class QTcpSocket;
+class QTimer;
+
+// Agent side of multi-host monitoring: pushes this machine's scans to an
+// AgentCollector over TCP as compressed deltas. Every connection starts
+// with a full snapshot, so a collector that restarted or lost the link
+// resyncs on reconnect; until then the agent retries with backoff. An agent
+// that falls behind a slow link skips deltas and sends one snapshot
+// instead once its queue drains, like SnapshotServer.
+class SnapshotAgent : public QObject {
+  Q_OBJECT
+
+public:
+  static const qint64 kMaxBacklogBytes = 8 * 1024 * 1024;
+
+  // `hostName` tags this agent's sockets at the collector; the token must
+  // match the collector's, if it has one
+  SnapshotAgent(const QString &hostName, const QString &token,
+                QObject *parent = nullptr);
+
+  void connectToCollector(const QString &address, quint16 port);
+  bool isConnected() const;
+
+  void publish(const QList<PortInfo> &ports);
+
+signals:
+  void connected();
+  // Lost or refused; a reconnect is already scheduled
+  void disconnected(const QString &error);
+
+private:
+  void onConnected();
+  void onBytesWritten();
+  void onError();
+  void sendSnapshot();
+
+  QString m_hostName;
+  QString m_token;
+  QString m_address;
+  quint16 m_port = 0;
+
+  QTcpSocket *m_socket;
+  QTimer *m_retryTimer;
+  int m_retryMs;
+  SnapshotDiff m_diff;
+  bool m_hasScan = false;
+  bool m_synced = false; // Collector has the last snapshot plus all deltas
+};
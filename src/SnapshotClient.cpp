@@ -0,0 +1,79 @@
+/*
+ * Copyright 2025 Kadir Mert Abatay
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "SnapshotClient.h"
+#include <QLocalSocket>
+#include <QSignalBlocker>
+
+// A snapshot of a million sockets is well under this
+static const int kMaxFrameBytes = 1024 * 1024 * 1024;
+
+SnapshotClient::SnapshotClient(QObject *parent) : QObject(parent) {
+  m_socket = new QLocalSocket(this);
+  connect(m_socket, &QLocalSocket::connected, this, [this]() {
+    m_socket->write(SnapshotProtocol::subscribe(m_filter));
+  });
+  connect(m_socket, &QLocalSocket::readyRead, this,
+          &SnapshotClient::onReadyRead);
+  connect(m_socket, &QLocalSocket::errorOccurred, this,
+          [this](QLocalSocket::LocalSocketError) {
+            fail(m_socket->errorString());
+          });
+}
+
+void SnapshotClient::connectToServer(const QString &path,
+                                     const SnapshotFilter &filter) {
+  m_socket->abort();
+  m_buffer.clear();
+  m_diff.reset();
+  m_hasSnapshot = false;
+  m_filter = filter;
+  m_socket->connectToServer(path);
+}
+
+void SnapshotClient::onReadyRead() {
+  m_buffer.append(m_socket->readAll());
+
+  quint8 type = 0;
+  QByteArray body;
+  int taken;
+  while ((taken = SnapshotProtocol::takeFrame(m_buffer, kMaxFrameBytes, &type,
+                                               &body)) > 0) {
+    SnapshotDelta delta;
+    if (!SnapshotProtocol::apply(type, body, &m_diff, &delta)) {
+      taken = -1;
+      break;
+    }
+    if (!m_hasSnapshot) {
+      // The first message is always a snapshot: everything is added
+      m_hasSnapshot = true;
+      emit snapshotReceived(delta.added);
+    } else if (!delta.isEmpty()) {
+      emit deltaReceived(delta);
+    }
+  }
+  if (taken < 0)
+    fail("Malformed message from the snapshot server");
+}
+
+void SnapshotClient::fail(const QString &error) {
+  {
+    const QSignalBlocker blocker(m_socket); // Aborting reports an error too
+    m_socket->abort();
+  }
+  m_buffer.clear();
+  emit errorOccurred(error);
+}
@@ -0,0 +1,57 @@
+/*
+ * Copyright 2025 Kadir Mert Abatay
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "SnapshotDiff.h"
+#include "SnapshotProtocol.h"
+#include <QObject>
+
+class QLocalSocket;
+
+// Viewer side of SnapshotServer: subscribes, keeps the served table up to
+// date and reports it the way PortMonitor and SnapshotDiff would
+class SnapshotClient : public QObject {
+  Q_OBJECT
+
+public:
+  explicit SnapshotClient(QObject *parent = nullptr);
+
+  void connectToServer(const QString &path,
+                       const SnapshotFilter &filter = SnapshotFilter());
+
+  // Every socket the server sent and still has
+  QList<PortInfo> ports() const { return m_diff.sockets().values(); }
+
+signals:
+  // The table as first received
+  void snapshotReceived(const QList<PortInfo> &ports);
+  // Changes from then on, including those found when the server sends a
+  // fresh snapshot after this viewer fell behind
+  void deltaReceived(const SnapshotDelta &delta);
+  // Not served, connection lost or a malformed message; nothing follows
+  void errorOccurred(const QString &error);
+
+private:
+  void onReadyRead();
+  void fail(const QString &error);
+
+  QLocalSocket *m_socket;
+  QByteArray m_buffer;
+  SnapshotFilter m_filter;
+  SnapshotDiff m_diff;
+  bool m_hasSnapshot = false;
+};
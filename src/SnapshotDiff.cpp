@@ -0,0 +1,67 @@
+/*
+ * Copyright 2025 Kadir Mert Abatay
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "SnapshotDiff.h"
+
+static bool sameSocketState(const PortInfo &a, const PortInfo &b) {
+  return a.state == b.state && a.processName == b.processName &&
+         a.user == b.user && a.unit == b.unit && a.netnsOwner == b.netnsOwner;
+}
+
+QString SnapshotDiff::key(const PortInfo &info) {
+  return QString("%1|%2|%3|%4|%5|%6")
+      .arg(info.protocol)
+      .arg(info.netns)
+      .arg(info.localAddress)
+      .arg(info.port)
+      .arg(info.remoteAddress)
+      .arg(info.pid);
+}
+
+SnapshotDelta SnapshotDiff::update(const QList<PortInfo> &ports) {
+  SnapshotDelta delta;
+  QHash<QString, PortInfo> current;
+  current.reserve(ports.size());
+  for (const PortInfo &info : ports) {
+    const QString socketKey = key(info);
+    // lsof lists a socket once per fd; the first row stands for all
+    if (current.contains(socketKey))
+      continue;
+    current.insert(socketKey, info);
+
+    auto previous = m_previous.constFind(socketKey);
+    if (previous == m_previous.constEnd())
+      delta.added.append(info);
+    else if (!sameSocketState(previous.value(), info))
+      delta.changed.append(info);
+  }
+
+  for (auto it = m_previous.cbegin(); it != m_previous.cend(); ++it) {
+    if (!current.contains(it.key()))
+      delta.removed.append(it.value());
+  }
+  m_previous.swap(current);
+  return delta;
+}
+
+void SnapshotDiff::apply(const SnapshotDelta &delta) {
+  for (const PortInfo &info : delta.removed)
+    m_previous.remove(key(info));
+  for (const PortInfo &info : delta.added)
+    m_previous.insert(key(info), info);
+  for (const PortInfo &info : delta.changed)
+    m_previous.insert(key(info), info);
+}
@@ -0,0 +1,57 @@
+/*
+ * Copyright 2025 Kadir Mert Abatay
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "PortMonitor.h"
+#include <QHash>
+#include <QList>
+#include <QString>
+
+struct SnapshotDelta {
+  QList<PortInfo> added;
+  QList<PortInfo> removed; // As last seen
+  QList<PortInfo> changed; // Same socket, new state, owner or unit
+
+  bool isEmpty() const {
+    return added.isEmpty() && removed.isEmpty() && changed.isEmpty();
+  }
+};
+
+// Tells consecutive scans apart socket by socket. A socket is identified by
+// protocol, namespace, both endpoints and the owning PID; kernel queue
+// statistics move on every scan and do not count as a change.
+class SnapshotDiff {
+public:
+  // Changes since the previous call; the first call reports every socket
+  // as added
+  SnapshotDelta update(const QList<PortInfo> &ports);
+
+  // Forgets the previous scan, so the next update starts over
+  void reset() { m_previous.clear(); }
+
+  // Brings the previous scan up to date with a delta computed elsewhere,
+  // e.g. one received from a SnapshotServer
+  void apply(const SnapshotDelta &delta);
+
+  // The previous scan, by key
+  const QHash<QString, PortInfo> &sockets() const { return m_previous; }
+
+  static QString key(const PortInfo &info);
+
+private:
+  QHash<QString, PortInfo> m_previous;
+};
@@ -0,0 +1,245 @@
+/*
+ * Copyright 2025 Kadir Mert Abatay
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "SnapshotProtocol.h"
+#include <QDataStream>
+#include <QtEndian>
+
+static QByteArray frame(quint8 type, const QByteArray &body) {
+  QByteArray frame(4, Qt::Uninitialized);
+  qToBigEndian(quint32(body.size() + 1), frame.data());
+  frame.append(char(type));
+  frame.append(body);
+  return frame;
+}
+
+static QDataStream &operator<<(QDataStream &out, const PortInfo &info) {
+  return out << info.protocol.toUtf8() << info.localAddress.toUtf8()
+             << quint16(info.port) << info.remoteAddress.toUtf8()
+             << info.state.toUtf8() << info.pid.toUtf8()
+             << info.processName.toUtf8() << info.user.toUtf8()
+             << info.unit.toUtf8() << info.netns << info.netnsOwner.toUtf8();
+}
+
+static QDataStream &operator>>(QDataStream &in, PortInfo &info) {
+  QByteArray protocol, local, remote, state, pid, process, user, unit, owner;
+  quint16 port = 0;
+  in >> protocol >> local >> port >> remote >> state >> pid >> process >>
+      user >> unit >> info.netns >> owner;
+  info.protocol = QString::fromUtf8(protocol);
+  info.localAddress = QString::fromUtf8(local);
+  info.port = port;
+  info.remoteAddress = QString::fromUtf8(remote);
+  info.state = QString::fromUtf8(state);
+  info.pid = QString::fromUtf8(pid);
+  info.processName = QString::fromUtf8(process);
+  info.user = QString::fromUtf8(user);
+  info.unit = QString::fromUtf8(unit);
+  info.netnsOwner = QString::fromUtf8(owner);
+  return in;
+}
+
+static void writePorts(QDataStream &out, const QList<PortInfo> &ports) {
+  out << quint32(ports.size());
+  for (const PortInfo &info : ports)
+    out << info;
+}
+
+static bool readPorts(QDataStream &in, QList<PortInfo> *ports) {
+  quint32 count = 0;
+  in >> count;
+  // Counts come off the wire; check them against what is left of the body
+  // before reserving: a socket takes at least nine string lengths, the port
+  // and the namespace
+  const qint64 minBytes = 9 * 4 + 2 + 8;
+  if (in.status() != QDataStream::Ok ||
+      count > in.device()->bytesAvailable() / minBytes) {
+    return false;
+  }
+  ports->reserve(ports->size() + int(count));
+  for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+    PortInfo info;
+    in >> info;
+    ports->append(info);
+  }
+  return in.status() == QDataStream::Ok;
+}
+
+QByteArray SnapshotProtocol::subscribe(const SnapshotFilter &filter) {
+  QByteArray body;
+  QDataStream out(&body, QIODevice::WriteOnly);
+  out.setVersion(QDataStream::Qt_6_0);
+  out << kVersion << quint32(filter.ports.size());
+  for (int port : filter.ports)
+    out << quint16(port);
+  out << quint32(filter.states.size());
+  for (const QString &state : filter.states)
+    out << state.toUtf8();
+  return frame(Subscribe, body);
+}
+
+QByteArray SnapshotProtocol::snapshot(const QList<PortInfo> &ports) {
+  QByteArray body;
+  QDataStream out(&body, QIODevice::WriteOnly);
+  out.setVersion(QDataStream::Qt_6_0);
+  writePorts(out, ports);
+  return frame(Snapshot, body);
+}
+
+QByteArray SnapshotProtocol::delta(const QList<PortInfo> &added,
+                                   const QStringList &removedKeys,
+                                   const QList<PortInfo> &changed) {
+  QByteArray body;
+  QDataStream out(&body, QIODevice::WriteOnly);
+  out.setVersion(QDataStream::Qt_6_0);
+  writePorts(out, added);
+  out << quint32(removedKeys.size());
+  for (const QString &key : removedKeys)
+    out << key.toUtf8();
+  writePorts(out, changed);
+  return frame(Delta, body);
+}
+
+QByteArray SnapshotProtocol::hello(const QString &host, const QString &token) {
+  QByteArray body;
+  QDataStream out(&body, QIODevice::WriteOnly);
+  out.setVersion(QDataStream::Qt_6_0);
+  out << kVersion << host.toUtf8() << token.toUtf8();
+  return frame(Hello, body);
+}
+
+QByteArray SnapshotProtocol::compress(const QByteArray &frame) {
+  const quint8 type = quint8(frame.at(4));
+  return ::frame(type | kCompressed, qCompress(frame.mid(5)));
+}
+
+int SnapshotProtocol::takeFrame(QByteArray &buffer, int maxSize,
+                                quint8 *type, QByteArray *body) {
+  if (buffer.size() < 4)
+    return 0;
+  const quint32 size = qFromBigEndian<quint32>(buffer.constData());
+  if (size == 0 || size > quint32(maxSize))
+    return -1;
+  if (quint32(buffer.size()) < 4 + size)
+    return 0;
+  *type = quint8(buffer.at(4));
+  *body = buffer.mid(5, int(size) - 1);
+  buffer.remove(0, 4 + int(size));
+
+  if (*type & kCompressed) {
+    *type = quint8(*type & ~kCompressed);
+    // qCompress() leads with the uncompressed size; checked before
+    // qUncompress() allocates it
+    if (body->size() < 4 ||
+        qFromBigEndian<quint32>(body->constData()) > quint32(maxSize)) {
+      return -1;
+    }
+    *body = qUncompress(*body);
+    if (body->isEmpty())
+      return -1;
+  }
+  return 1;
+}
+
+bool SnapshotProtocol::readSubscribe(const QByteArray &body,
+                                     SnapshotFilter *filter) {
+  QDataStream in(body);
+  in.setVersion(QDataStream::Qt_6_0);
+  quint8 version = 0;
+  quint32 count = 0;
+  in >> version >> count;
+  if (version != kVersion || count > quint32(body.size()))
+    return false;
+  for (quint32 i = 0; i < count; ++i) {
+    quint16 port = 0;
+    in >> port;
+    filter->ports.insert(port);
+  }
+  in >> count;
+  if (count > quint32(body.size()))
+    return false;
+  for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+    QByteArray state;
+    in >> state;
+    filter->states.insert(QString::fromUtf8(state).toUpper());
+  }
+  return in.status() == QDataStream::Ok;
+}
+
+bool SnapshotProtocol::readSnapshot(const QByteArray &body,
+                                    QList<PortInfo> *ports) {
+  QDataStream in(body);
+  in.setVersion(QDataStream::Qt_6_0);
+  return readPorts(in, ports);
+}
+
+bool SnapshotProtocol::readDelta(const QByteArray &body,
+                                 QList<PortInfo> *added,
+                                 QStringList *removedKeys,
+                                 QList<PortInfo> *changed) {
+  QDataStream in(body);
+  in.setVersion(QDataStream::Qt_6_0);
+  if (!readPorts(in, added))
+    return false;
+  quint32 count = 0;
+  in >> count;
+  if (count > quint32(body.size()))
+    return false;
+  for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+    QByteArray key;
+    in >> key;
+    removedKeys->append(QString::fromUtf8(key));
+  }
+  return in.status() == QDataStream::Ok && readPorts(in, changed);
+}
+
+bool SnapshotProtocol::readHello(const QByteArray &body, QString *host,
+                                 QString *token) {
+  QDataStream in(body);
+  in.setVersion(QDataStream::Qt_6_0);
+  quint8 version = 0;
+  QByteArray hostName, secret;
+  in >> version >> hostName >> secret;
+  *host = QString::fromUtf8(hostName);
+  *token = QString::fromUtf8(secret);
+  return in.status() == QDataStream::Ok && version == kVersion &&
+         !host->isEmpty();
+}
+
+bool SnapshotProtocol::apply(quint8 type, const QByteArray &body,
+                             SnapshotDiff *table, SnapshotDelta *delta) {
+  if (type == Snapshot) {
+    QList<PortInfo> ports;
+    if (!readSnapshot(body, &ports))
+      return false;
+    *delta = table->update(ports);
+    return true;
+  }
+  if (type != Delta)
+    return false;
+
+  QStringList removedKeys;
+  if (!readDelta(body, &delta->added, &removedKeys, &delta->changed))
+    return false;
+  const QHash<QString, PortInfo> &sockets = table->sockets();
+  for (const QString &key : removedKeys) {
+    auto it = sockets.constFind(key);
+    if (it != sockets.constEnd())
+      delta->removed.append(it.value());
+  }
+  table->apply(*delta);
+  return true;
+}
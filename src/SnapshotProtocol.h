@@ -0,0 +1,84 @@
+/*
+ * Copyright 2025 Kadir Mert Abatay
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "PortMonitor.h"
+#include "SnapshotDiff.h"
+#include <QByteArray>
+#include <QList>
+#include <QSet>
+#include <QStringList>
+
+// What a viewer subscribes to; an empty set matches everything
+struct SnapshotFilter {
+  QSet<int> ports;
+  QSet<QString> states; // "LISTEN", "ESTABLISHED", ...
+
+  bool isEmpty() const { return ports.isEmpty() && states.isEmpty(); }
+  bool matches(const PortInfo &info) const {
+    return (ports.isEmpty() || ports.contains(info.port)) &&
+           (states.isEmpty() || states.contains(info.state));
+  }
+};
+
+// Wire format between SnapshotServer and SnapshotClient, and from
+// SnapshotAgent to AgentCollector. Every message is a frame: a 32-bit
+// big-endian length, a type byte and a QDataStream body, qCompress()ed when
+// the type has kCompressed set. Strings travel as UTF-8 and a socket
+// carries only what SnapshotDiff identifies and compares it by; removals
+// are sent as keys alone.
+class SnapshotProtocol {
+public:
+  enum MessageType : quint8 {
+    Subscribe = 1, // Viewer -> server: version and filter
+    Snapshot = 2,  // Every matching socket
+    Delta = 3,     // Added, removed keys, changed
+    Hello = 4,     // Agent -> collector: version, host name, token
+  };
+
+  static const quint8 kVersion = 1;
+  static const quint8 kCompressed = 0x80;
+
+  static QByteArray subscribe(const SnapshotFilter &filter);
+  static QByteArray snapshot(const QList<PortInfo> &ports);
+  static QByteArray delta(const QList<PortInfo> &added,
+                          const QStringList &removedKeys,
+                          const QList<PortInfo> &changed);
+  static QByteArray hello(const QString &host, const QString &token);
+
+  // The same frame with its body compressed
+  static QByteArray compress(const QByteArray &frame);
+
+  // Takes the first complete frame off `buffer`, uncompressing its body. 1
+  // when one was taken, 0 while it is incomplete, -1 when it (compressed or
+  // not) is larger than `maxSize` or does not uncompress.
+  static int takeFrame(QByteArray &buffer, int maxSize, quint8 *type,
+                       QByteArray *body);
+
+  // False on a malformed body or, for a subscription, another version
+  static bool readSubscribe(const QByteArray &body, SnapshotFilter *filter);
+  static bool readSnapshot(const QByteArray &body, QList<PortInfo> *ports);
+  static bool readDelta(const QByteArray &body, QList<PortInfo> *added,
+                        QStringList *removedKeys, QList<PortInfo> *changed);
+  static bool readHello(const QByteArray &body, QString *host,
+                        QString *token);
+
+  // Brings `table` up to date with a Snapshot or Delta message; `delta`
+  // gets what changed, removals as last seen. False for other messages.
+  static bool apply(quint8 type, const QByteArray &body, SnapshotDiff *table,
+                    SnapshotDelta *delta);
+};
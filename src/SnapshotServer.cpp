@@ -0,0 +1,207 @@
+/*
+ * Copyright 2025 Kadir Mert Abatay
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "SnapshotServer.h"
+#include <QDir>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QStandardPaths>
+
+// Subscriptions are a few ports and states; anything larger is not a viewer
+static const int kMaxSubscribeBytes = 64 * 1024;
+
+// The part of a delta a filter lets through. A changed socket can enter or
+// leave the filter (a new state), which the viewer sees as added or removed.
+static QByteArray filteredDelta(const SnapshotDelta &delta,
+                                const SnapshotFilter &filter,
+                                const QHash<QString, PortInfo> &previous) {
+  QList<PortInfo> added;
+  QStringList removed;
+  QList<PortInfo> changed;
+  for (const PortInfo &info : delta.added) {
+    if (filter.matches(info))
+      added.append(info);
+  }
+  for (const PortInfo &info : delta.removed) {
+    if (filter.matches(info))
+      removed.append(SnapshotDiff::key(info));
+  }
+  for (const PortInfo &info : delta.changed) {
+    const QString key = SnapshotDiff::key(info);
+    const bool was = filter.isEmpty() || filter.matches(previous.value(key));
+    const bool is = filter.matches(info);
+    if (was && is)
+      changed.append(info);
+    else if (is)
+      added.append(info);
+    else if (was)
+      removed.append(key);
+  }
+  if (added.isEmpty() && removed.isEmpty() && changed.isEmpty())
+    return QByteArray();
+  return SnapshotProtocol::delta(added, removed, changed);
+}
+
+SnapshotServer::SnapshotServer(QObject *parent) : QObject(parent) {
+  m_server = new QLocalServer(this);
+  m_server->setSocketOptions(QLocalServer::UserAccessOption);
+  connect(m_server, &QLocalServer::newConnection, this,
+          &SnapshotServer::onNewConnection);
+}
+
+SnapshotServer::~SnapshotServer() { close(); }
+
+QString SnapshotServer::defaultPath() {
+  return QDir(QStandardPaths::writableLocation(
+                  QStandardPaths::RuntimeLocation))
+      .filePath("portmonitor.sock");
+}
+
+bool SnapshotServer::listen(const QString &path) {
+  close();
+  m_error.clear();
+
+  QLocalSocket probe;
+  probe.connectToServer(path);
+  if (probe.waitForConnected(200)) {
+    m_error = QString("%1 is already served by another process").arg(path);
+    return false;
+  }
+  QLocalServer::removeServer(path);
+
+  if (!m_server->listen(path)) {
+    m_error = m_server->errorString();
+    return false;
+  }
+  return true;
+}
+
+void SnapshotServer::close() {
+  for (auto it = m_clients.begin(); it != m_clients.end(); ++it) {
+    it.key()->disconnect(this);
+    it.key()->abort();
+    it.key()->deleteLater();
+  }
+  m_clients.clear();
+  m_server->close();
+}
+
+bool SnapshotServer::isListening() const { return m_server->isListening(); }
+
+void SnapshotServer::publish(const QList<PortInfo> &ports) {
+  // Shares the previous table with the diff, which swaps in a new one
+  const QHash<QString, PortInfo> previous = m_diff.sockets();
+  const SnapshotDelta delta = m_diff.update(ports);
+  m_hasScan = true;
+
+  QByteArray unfiltered; // Encoded once for every viewer without a filter
+  for (Client &client : m_clients) {
+    if (client.phase == AwaitingScan) {
+      sendSnapshot(client);
+      continue;
+    }
+    if (client.phase != Streaming || delta.isEmpty())
+      continue;
+
+    if (client.filter.isEmpty()) {
+      if (unfiltered.isEmpty())
+        unfiltered = filteredDelta(delta, client.filter, previous);
+      send(client, unfiltered);
+    } else {
+      const QByteArray frame = filteredDelta(delta, client.filter, previous);
+      if (!frame.isEmpty())
+        send(client, frame);
+    }
+  }
+}
+
+void SnapshotServer::onNewConnection() {
+  while (QLocalSocket *socket = m_server->nextPendingConnection()) {
+    Client &client = m_clients[socket];
+    client.socket = socket;
+    connect(socket, &QLocalSocket::readyRead, this,
+            [this, socket]() { onReadyRead(socket); });
+    connect(socket, &QLocalSocket::bytesWritten, this,
+            [this, socket]() { onBytesWritten(socket); });
+    // Queued: a failed write may report it while publish() walks the list
+    connect(
+        socket, &QLocalSocket::disconnected, this,
+        [this, socket]() { onDisconnected(socket); }, Qt::QueuedConnection);
+  }
+}
+
+void SnapshotServer::onReadyRead(QLocalSocket *socket) {
+  auto it = m_clients.find(socket);
+  if (it == m_clients.end())
+    return;
+  Client &client = it.value();
+  client.buffer.append(socket->readAll());
+
+  quint8 type = 0;
+  QByteArray body;
+  int taken;
+  while ((taken = SnapshotProtocol::takeFrame(client.buffer, kMaxSubscribeBytes,
+                                               &type, &body)) > 0) {
+    SnapshotFilter filter;
+    if (type != SnapshotProtocol::Subscribe ||
+        !SnapshotProtocol::readSubscribe(body, &filter)) {
+      taken = -1;
+      break;
+    }
+    // A new subscription starts over with its own snapshot
+    client.filter = filter;
+    if (m_hasScan)
+      sendSnapshot(client);
+    else
+      client.phase = AwaitingScan;
+  }
+  if (taken < 0)
+    socket->abort(); // Not a viewer speaking this protocol
+}
+
+void SnapshotServer::onBytesWritten(QLocalSocket *socket) {
+  auto it = m_clients.find(socket);
+  if (it != m_clients.end() && it->phase == Resyncing &&
+      socket->bytesToWrite() == 0) {
+    sendSnapshot(it.value());
+  }
+}
+
+void SnapshotServer::onDisconnected(QLocalSocket *socket) {
+  if (m_clients.remove(socket))
+    socket->deleteLater();
+}
+
+void SnapshotServer::sendSnapshot(Client &client) {
+  QList<PortInfo> ports;
+  const QHash<QString, PortInfo> &sockets = m_diff.sockets();
+  for (const PortInfo &info : sockets) {
+    if (client.filter.matches(info))
+      ports.append(info);
+  }
+  // Written even when large: nothing else is queued for this viewer
+  client.socket->write(SnapshotProtocol::snapshot(ports));
+  client.phase = Streaming;
+}
+
+void SnapshotServer::send(Client &client, const QByteArray &frame) {
+  const qint64 queued = client.socket->bytesToWrite();
+  if (queued > 0 && queued + frame.size() > kMaxBacklogBytes) {
+    client.phase = Resyncing;
+    return;
+  }
+  client.socket->write(frame);
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright 2025 Kadir Mert Abatay
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "SnapshotDiff.h"
+#include "SnapshotProtocol.h"
+#include <QHash>
+#include <QObject>
+
+class QLocalServer;
+class QLocalSocket;
+
+// Serves scans to other processes over a local (Unix domain) socket, so one
+// collector feeds any number of viewers. A viewer subscribes with a filter,
+// receives every matching socket once and then only what changes. Writes
+// never block: a viewer more than kMaxBacklogBytes behind stops receiving
+// deltas and gets a fresh snapshot once it has caught up.
+class SnapshotServer : public QObject {
+  Q_OBJECT
+
+public:
+  static const qint64 kMaxBacklogBytes = 8 * 1024 * 1024;
+
+  explicit SnapshotServer(QObject *parent = nullptr);
+  ~SnapshotServer() override;
+
+  // <runtime dir>/portmonitor.sock
+  static QString defaultPath();
+
+  // Takes over a socket file left by a server that is gone, never one that
+  // is still served. Only the current user may connect.
+  bool listen(const QString &path);
+  void close();
+  bool isListening() const;
+  QString errorString() const { return m_error; }
+  int clientCount() const { return m_clients.size(); }
+
+  // Sends every viewer what changed since the previous scan
+  void publish(const QList<PortInfo> &ports);
+
+private:
+  enum Phase {
+    AwaitingSubscribe,
+    AwaitingScan, // Subscribed before the first scan
+    Streaming,
+    Resyncing // Fell behind; deltas are dropped until the queue drains
+  };
+
+  struct Client {
+    QLocalSocket *socket = nullptr;
+    SnapshotFilter filter;
+    Phase phase = AwaitingSubscribe;
+    QByteArray buffer;
+  };
+
+  void onNewConnection();
+  void onReadyRead(QLocalSocket *socket);
+  void onBytesWritten(QLocalSocket *socket);
+  void onDisconnected(QLocalSocket *socket);
+  void sendSnapshot(Client &client);
+  void send(Client &client, const QByteArray &frame);
+
+  QLocalServer *m_server;
+  QHash<QLocalSocket *, Client> m_clients;
+  SnapshotDiff m_diff;
+  bool m_hasScan = false;
+  QString m_error;
+};
@@ -0,0 +1,108 @@
+/*
+ * Copyright 2025 Kadir Mert Abatay
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "SnapshotStore.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+// Bumped whenever a field changes meaning; older files are ignored
+static const int kSnapshotVersion = 1;
+
+QString SnapshotStore::defaultPath() {
+  return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) +
+         "/snapshot.json";
+}
+
+bool SnapshotStore::save(const QString &path, const QList<PortInfo> &ports) {
+  QJsonArray rows;
+  for (const PortInfo &info : ports)
+    rows.append(toJson(info));
+
+  QJsonObject root;
+  root["version"] = kSnapshotVersion;
+  root["takenAt"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+  root["ports"] = rows;
+
+  QDir().mkpath(QFileInfo(path).absolutePath());
+  QSaveFile file(path);
+  if (!file.open(QIODevice::WriteOnly))
+    return false;
+  file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+  return file.commit();
+}
+
+QList<PortInfo> SnapshotStore::load(const QString &path, QDateTime *takenAt) {
+  QList<PortInfo> ports;
+  QFile file(path);
+  if (!file.open(QIODevice::ReadOnly))
+    return ports;
+
+  const QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+  if (root.value("version").toInt() != kSnapshotVersion)
+    return ports;
+
+  const QJsonArray rows = root.value("ports").toArray();
+  ports.reserve(rows.size());
+  for (const QJsonValue &value : rows)
+    ports.append(fromJson(value.toObject()));
+  if (takenAt) {
+    *takenAt = QDateTime::fromString(root.value("takenAt").toString(),
+                                     Qt::ISODate);
+  }
+  return ports;
+}
+
+QJsonObject SnapshotStore::toJson(const PortInfo &info) {
+  QJsonObject row;
+  row["protocol"] = info.protocol;
+  row["local"] = info.localAddress;
+  row["remote"] = info.remoteAddress;
+  row["state"] = info.state;
+  row["pid"] = info.pid;
+  row["process"] = info.processName;
+  row["user"] = info.user;
+  row["unit"] = info.unit;
+  row["port"] = info.port;
+  // Inodes exceed the 53 bits a JSON number holds exactly
+  row["netns"] = QString::number(info.netns);
+  row["netnsOwner"] = info.netnsOwner;
+  if (!info.host.isEmpty())
+    row["host"] = info.host;
+  return row;
+}
+
+PortInfo SnapshotStore::fromJson(const QJsonObject &row) {
+  PortInfo info;
+  info.protocol = row.value("protocol").toString();
+  info.localAddress = row.value("local").toString();
+  info.remoteAddress = row.value("remote").toString();
+  info.state = row.value("state").toString();
+  info.pid = row.value("pid").toString();
+  info.processName = row.value("process").toString();
+  info.user = row.value("user").toString();
+  info.unit = row.value("unit").toString();
+  info.port = row.value("port").toInt();
+  info.netns = row.value("netns").toString().toULongLong();
+  info.netnsOwner = row.value("netnsOwner").toString();
+  info.host = row.value("host").toString();
+  return info;
+}
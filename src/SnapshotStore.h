@@ -0,0 +1,43 @@
+/*
+ * Copyright 2025 Kadir Mert Abatay
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "PortMonitor.h"
+#include <QDateTime>
+#include <QJsonObject>
+#include <QList>
+#include <QString>
+
+// The last scan result on disk, so a new session has something to show
+// before its first scan completes. Only what identifies a socket is kept;
+// kernel queue statistics are stale by definition and come back unknown.
+class SnapshotStore {
+public:
+  // <cache dir>/snapshot.json
+  static QString defaultPath();
+
+  // Written atomically; false if the file could not be replaced
+  static bool save(const QString &path, const QList<PortInfo> &ports);
+
+  // Empty when there is no snapshot or it cannot be read
+  static QList<PortInfo> load(const QString &path,
+                              QDateTime *takenAt = nullptr);
+
+  // One socket as stored in the file (also the CLI's JSON output)
+  static QJsonObject toJson(const PortInfo &info);
+  static PortInfo fromJson(const QJsonObject &row);
+};
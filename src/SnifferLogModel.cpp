@@ -0,0 +1,134 @@
+/*
+ * Copyright 2025 Kadir Mert Abatay
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "SnifferLogModel.h"
+#include <QBrush>
+#include <QLocale>
+
+SnifferLogModel::SnifferLogModel(QObject *parent)
+    : QAbstractTableModel(parent) {}
+
+int SnifferLogModel::rowCount(const QModelIndex &parent) const {
+  if (parent.isValid())
+    return 0;
+  return m_entries.size();
+}
+
+int SnifferLogModel::columnCount(const QModelIndex &parent) const {
+  if (parent.isValid())
+    return 0;
+  return ColumnCount;
+}
+
+QVariant SnifferLogModel::data(const QModelIndex &index, int role) const {
+  if (!index.isValid() || index.row() >= m_entries.size())
+    return QVariant();
+
+  const SnifferLogEntry &entry = m_entries[index.row()];
+
+  if (role == Qt::DisplayRole) {
+    switch (index.column()) {
+    case Time:
+      return entry.time.toString("HH:mm:ss");
+    case Event:
+      return entry.event;
+    case Details:
+      if (entry.count > 1) {
+        return QString("%1 %2")
+            .arg(QLocale().toString(entry.count))
+            .arg(entry.groupLabel);
+      }
+      return entry.details;
+    }
+  } else if (role == Qt::ForegroundRole) {
+    if (index.column() == Event)
+      return QBrush(entry.color);
+  } else if (role == Qt::ToolTipRole) {
+    if (index.column() == Details && entry.count > 1) {
+      // Keep the last concrete event reachable behind the summary
+      return QString("Last: %1").arg(entry.details);
+    }
+  }
+
+  return QVariant();
+}
+
+QVariant SnifferLogModel::headerData(int section, Qt::Orientation orientation,
+                                     int role) const {
+  if (orientation == Qt::Horizontal && role == Qt::DisplayRole) {
+    switch (section) {
+    case Time:
+      return "Time";
+    case Event:
+      return "Event";
+    case Details:
+      return "Details";
+    }
+  }
+  return QVariant();
+}
+
+void SnifferLogModel::prependEntries(const QList<SnifferLogEntry> &entries) {
+  if (entries.isEmpty())
+    return;
+
+  beginInsertRows(QModelIndex(), 0, entries.size() - 1);
+  // QList prepends in amortized constant time in Qt 6
+  for (const SnifferLogEntry &entry : entries) {
+    m_entries.prepend(entry);
+  }
+  endInsertRows();
+
+  trim();
+}
+
+bool SnifferLogModel::mergeIntoTop(const SnifferLogEntry &entry,
+                                   qint64 windowMs) {
+  if (entry.groupKey.isEmpty() || m_entries.isEmpty())
+    return false;
+
+  SnifferLogEntry &top = m_entries.first();
+  if (top.groupKey != entry.groupKey ||
+      top.time.msecsTo(entry.time) > windowMs) {
+    return false;
+  }
+
+  top.count += entry.count;
+  top.time = entry.time;
+  top.details = entry.details;
+  emit dataChanged(index(0, Time), index(0, Details));
+  return true;
+}
+
+void SnifferLogModel::clear() {
+  beginResetModel();
+  m_entries.clear();
+  endResetModel();
+}
+
+void SnifferLogModel::setMaxRows(int rows) {
+  m_maxRows = qMax(1, rows);
+  trim();
+}
+
+void SnifferLogModel::trim() {
+  if (m_entries.size() <= m_maxRows)
+    return;
+
+  beginRemoveRows(QModelIndex(), m_maxRows, m_entries.size() - 1);
+  m_entries.resize(m_maxRows);
+  endRemoveRows();
+}
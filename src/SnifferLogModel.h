@@ -0,0 +1,69 @@
+/*
+ * Copyright 2025 Kadir Mert Abatay
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <QAbstractTableModel>
+#include <QColor>
+#include <QDateTime>
+#include <QList>
+
+struct SnifferLogEntry {
+  QDateTime time;
+  QString event;
+  QString details;
+  QColor color;
+  // Entries sharing a non-empty group key are collapsed into one counted row,
+  // rendered as "<count> <groupLabel>" (e.g. "12 connections opened from X").
+  QString groupKey;
+  QString groupLabel;
+  int count = 1;
+};
+
+class SnifferLogModel : public QAbstractTableModel {
+  Q_OBJECT
+
+public:
+  explicit SnifferLogModel(QObject *parent = nullptr);
+
+  enum Column { Time = 0, Event, Details, ColumnCount };
+
+  int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+  int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+  QVariant data(const QModelIndex &index,
+                int role = Qt::DisplayRole) const override;
+  QVariant headerData(int section, Qt::Orientation orientation,
+                      int role = Qt::DisplayRole) const override;
+
+  // Inserts a batch of entries at the top. The batch is ordered oldest first,
+  // so the last entry ends up in row 0. Rows beyond maxRows() are trimmed.
+  void prependEntries(const QList<SnifferLogEntry> &entries);
+
+  // Folds `entry` (its count, time and details) into the newest row if it
+  // carries the same group key and is not older than `windowMs`. Returns
+  // false otherwise.
+  bool mergeIntoTop(const SnifferLogEntry &entry, qint64 windowMs);
+
+  void clear();
+  void setMaxRows(int rows);
+  int maxRows() const { return m_maxRows; }
+
+private:
+  void trim();
+
+  QList<SnifferLogEntry> m_entries; // Row 0 is the newest entry
+  int m_maxRows = 5000;
+};
@@ -0,0 +1,248 @@
+/*
+ * Copyright 2025 Kadir Mert Abatay
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "SocketTable.h"
+#include <QFile>
+#include <cstring>
+
+#ifdef Q_OS_LINUX
+#include <arpa/inet.h>
+#include <linux/inet_diag.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <linux/sock_diag.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#ifdef Q_OS_LINUX
+
+static QString formatAddress(int family, const void *addr) {
+  char buf[INET6_ADDRSTRLEN] = {};
+  if (!inet_ntop(family, addr, buf, sizeof(buf)))
+    return QString();
+  return QString::fromLatin1(buf);
+}
+
+// Dumps every TCP socket of one address family through NETLINK_SOCK_DIAG.
+// Unlike /proc/net/tcp this also reports the configured listen backlog.
+static bool dumpTcpDiag(int family, QList<KernelSocket> &out) {
+  int fd = socket(AF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC, NETLINK_SOCK_DIAG);
+  if (fd < 0)
+    return false;
+
+  struct {
+    nlmsghdr nlh;
+    inet_diag_req_v2 req;
+  } request;
+  std::memset(&request, 0, sizeof(request));
+  request.nlh.nlmsg_len = sizeof(request);
+  request.nlh.nlmsg_type = SOCK_DIAG_BY_FAMILY;
+  request.nlh.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+  request.req.sdiag_family = family;
+  request.req.sdiag_protocol = IPPROTO_TCP;
+  request.req.idiag_states = ~0U; // Includes NEW_SYN_RECV request sockets
+  request.req.idiag_ext = 1 << (INET_DIAG_SKMEMINFO - 1);
+
+  sockaddr_nl kernel;
+  std::memset(&kernel, 0, sizeof(kernel));
+  kernel.nl_family = AF_NETLINK;
+
+  if (sendto(fd, &request, sizeof(request), 0,
+             reinterpret_cast<sockaddr *>(&kernel), sizeof(kernel)) < 0) {
+    close(fd);
+    return false;
+  }
+
+  alignas(nlmsghdr) char buffer[64 * 1024];
+  bool done = false;
+  bool ok = true;
+  while (!done) {
+    ssize_t len = recv(fd, buffer, sizeof(buffer), 0);
+    if (len <= 0) {
+      ok = false;
+      break;
+    }
+
+    int remaining = int(len);
+    for (auto *hdr = reinterpret_cast<nlmsghdr *>(buffer);
+         NLMSG_OK(hdr, remaining); hdr = NLMSG_NEXT(hdr, remaining)) {
+      if (hdr->nlmsg_type == NLMSG_DONE) {
+        done = true;
+        break;
+      }
+      if (hdr->nlmsg_type == NLMSG_ERROR) {
+        done = true;
+        ok = false;
+        break;
+      }
+
+      const auto *msg = static_cast<const inet_diag_msg *>(NLMSG_DATA(hdr));
+      KernelSocket sock;
+      sock.protocol = "TCP";
+      sock.localAddress = formatAddress(msg->idiag_family, msg->id.idiag_src);
+      sock.localPort = ntohs(msg->id.idiag_sport);
+      sock.remoteAddress = formatAddress(msg->idiag_family, msg->id.idiag_dst);
+      sock.remotePort = ntohs(msg->id.idiag_dport);
+      sock.state = msg->idiag_state;
+      sock.inode = msg->idiag_inode;
+      sock.uid = msg->idiag_uid;
+      sock.rxQueue = msg->idiag_rqueue;
+      sock.txQueue = msg->idiag_wqueue;
+
+      int attrLen = int(hdr->nlmsg_len - NLMSG_LENGTH(sizeof(*msg)));
+      for (auto *attr = reinterpret_cast<const rtattr *>(msg + 1);
+           RTA_OK(attr, attrLen); attr = RTA_NEXT(attr, attrLen)) {
+        if (attr->rta_type != INET_DIAG_SKMEMINFO ||
+            RTA_PAYLOAD(attr) < sizeof(quint32) * SK_MEMINFO_VARS)
+          continue;
+        const auto *mem = static_cast<const quint32 *>(RTA_DATA(attr));
+        sock.socketMemory = qint64(mem[SK_MEMINFO_RMEM_ALLOC]) +
+                            qint64(mem[SK_MEMINFO_WMEM_QUEUED]);
+      }
+      out.append(sock);
+    }
+  }
+
+  close(fd);
+  return ok;
+}
+
+#endif
+
+QList<KernelSocket> SocketTable::readTcp() {
+  QList<KernelSocket> sockets;
+#ifdef Q_OS_LINUX
+  if (dumpTcpDiag(AF_INET, sockets) && dumpTcpDiag(AF_INET6, sockets))
+    return sockets;
+
+  // sock_diag unavailable (old kernel, seccomp, ...): fall back to /proc,
+  // which has the accept queue depth but not the configured backlog
+  sockets.clear();
+  sockets += readProcNet("/proc/net/tcp", "TCP");
+  sockets += readProcNet("/proc/net/tcp6", "TCP");
+  for (KernelSocket &sock : sockets) {
+    if (sock.state == Listen)
+      sock.txQueue = -1;
+  }
+#endif
+  return sockets;
+}
+
+QList<KernelSocket> SocketTable::readUdp() {
+  // /proc/net/udp carries the per-socket drop counter, sock_diag for UDP
+  // does not without the meminfo extension
+  QList<KernelSocket> sockets = readProcNet("/proc/net/udp", "UDP");
+  sockets += readProcNet("/proc/net/udp6", "UDP");
+  return sockets;
+}
+
+QList<KernelSocket> SocketTable::readProcNet(const QString &path,
+                                             const QString &protocol) {
+  QList<KernelSocket> sockets;
+#ifdef Q_OS_LINUX
+  QFile file(path);
+  if (!file.open(QIODevice::ReadOnly))
+    return sockets;
+
+  // /proc files report a size of 0, so read until EOF rather than by size
+  const QByteArray data = file.readAll();
+  const bool v6 = path.endsWith('6');
+  const QList<QByteArray> lines = data.split('\n');
+
+  // Address fields are hex dumps of the in-kernel (network order) words,
+  // printed as host-order integers: "0100007F:0BB8" is 127.0.0.1:3000.
+  auto parseEndpoint = [v6](const QByteArray &field, QString &address,
+                            int &port) {
+    int colon = field.indexOf(':');
+    if (colon < 0)
+      return false;
+    const QByteArray hex = field.left(colon);
+    quint32 words[4] = {0, 0, 0, 0};
+    const int wordCount = v6 ? 4 : 1;
+    if (hex.size() != wordCount * 8)
+      return false;
+    for (int i = 0; i < wordCount; ++i) {
+      bool ok = false;
+      words[i] = hex.mid(i * 8, 8).toUInt(&ok, 16);
+      if (!ok)
+        return false;
+    }
+    address = formatAddress(v6 ? AF_INET6 : AF_INET, words);
+    port = field.mid(colon + 1).toInt(nullptr, 16);
+    return true;
+  };
+
+  for (int i = 1; i < lines.size(); ++i) { // Line 0 is the header
+    const QList<QByteArray> fields = lines[i].simplified().split(' ');
+    if (fields.size() < 10)
+      continue;
+
+    KernelSocket sock;
+    sock.protocol = protocol;
+    if (!parseEndpoint(fields[1], sock.localAddress, sock.localPort) ||
+        !parseEndpoint(fields[2], sock.remoteAddress, sock.remotePort))
+      continue;
+    sock.state = fields[3].toInt(nullptr, 16);
+
+    const QList<QByteArray> queues = fields[4].split(':');
+    if (queues.size() == 2) {
+      sock.txQueue = queues[0].toLongLong(nullptr, 16);
+      sock.rxQueue = queues[1].toLongLong(nullptr, 16);
+    }
+    sock.uid = fields[7].toUInt();
+    sock.inode = fields[9].toULongLong();
+    // UDP lines end with "ref pointer drops"
+    if (protocol == "UDP" && fields.size() > 12)
+      sock.drops = fields[12].toULongLong();
+    sockets.append(sock);
+  }
+#else
+  Q_UNUSED(path);
+  Q_UNUSED(protocol);
+#endif
+  return sockets;
+}
+
+QString SocketTable::stateName(int state) {
+  switch (state) {
+  case Established:
+    return "ESTABLISHED";
+  case SynSent:
+    return "SYN_SENT";
+  case SynRecv:
+  case NewSynRecv:
+    return "SYN_RECV";
+  case FinWait1:
+    return "FIN_WAIT1";
+  case FinWait2:
+    return "FIN_WAIT2";
+  case TimeWait:
+    return "TIME_WAIT";
+  case Close:
+    return "CLOSE";
+  case CloseWait:
+    return "CLOSE_WAIT";
+  case LastAck:
+    return "LAST_ACK";
+  case Listen:
+    return "LISTEN";
+  case Closing:
+    return "CLOSING";
+  }
+  return "UNKNOWN";
+}
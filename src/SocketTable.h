@@ -0,0 +1,70 @@
+/*
+ * Copyright 2025 Kadir Mert Abatay
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <QList>
+#include <QString>
+
+// One socket as the kernel reports it. lsof tells us who owns a port; this
+// tells us how the socket is doing (queues, backlog, ...).
+struct KernelSocket {
+  QString protocol; // "TCP" or "UDP"
+  QString localAddress;
+  int localPort = 0;
+  QString remoteAddress;
+  int remotePort = 0;
+  int state = 0; // Kernel TCP state, see SocketTable::TcpState
+  quint64 inode = 0;
+  quint32 uid = 0;
+  // For listeners rxQueue is the current accept queue depth and txQueue the
+  // configured backlog (-1 when the source cannot tell, e.g. /proc).
+  qint64 rxQueue = 0;
+  qint64 txQueue = 0;
+  quint64 drops = 0; // Datagrams dropped on receive (UDP only)
+  // Receive + send buffer memory charged to the socket (sock_diag only)
+  qint64 socketMemory = -1;
+};
+
+// Reads socket tables straight from the kernel: sock_diag netlink when it is
+// available, /proc/net/* otherwise. Linux only; other platforms get empty
+// results and callers simply show no kernel metrics.
+class SocketTable {
+public:
+  enum TcpState {
+    Established = 1,
+    SynSent,
+    SynRecv,
+    FinWait1,
+    FinWait2,
+    TimeWait,
+    Close,
+    CloseWait,
+    LastAck,
+    Listen,
+    Closing,
+    NewSynRecv
+  };
+
+  static QList<KernelSocket> readTcp();
+  static QList<KernelSocket> readUdp();
+
+  // Parses a /proc/net/{tcp,tcp6,udp,udp6} style file
+  static QList<KernelSocket> readProcNet(const QString &path,
+                                         const QString &protocol);
+
+  static QString stateName(int state);
+};
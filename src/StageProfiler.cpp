@@ -0,0 +1,173 @@
+/*
+ * Copyright 2025 Kadir Mert Abatay
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "StageProfiler.h"
+#include <QCoreApplication>
+#include <QMap>
+#include <QSaveFile>
+#include <QThread>
+#include <algorithm>
+
+StageProfiler::Scope::Scope(const char *stage)
+    : m_stage(stage), m_startNs(StageProfiler::instance()->now()) {}
+
+StageProfiler::Scope::~Scope() {
+  StageProfiler *profiler = StageProfiler::instance();
+  profiler->record(m_stage, m_startNs, profiler->now());
+}
+
+StageProfiler::StageProfiler() { m_clock.start(); }
+
+StageProfiler *StageProfiler::instance() {
+  static StageProfiler *profiler = new StageProfiler();
+  return profiler;
+}
+
+void StageProfiler::record(const char *stage, qint64 startNs, qint64 endNs,
+                           bool async) {
+  const qint64 durationNs = endNs - startNs;
+  QMutexLocker locker(&m_mutex);
+  Window &window = m_windows[stage];
+  if (window.durations.size() < kWindow)
+    window.durations.append(durationNs);
+  else
+    window.durations[window.next] = durationNs;
+  window.next = (window.next + 1) % kWindow;
+  window.count++;
+  window.lastNs = durationNs;
+  window.lastEndNs = endNs;
+
+  if (m_tracing && m_trace.size() < kMaxTraceEvents) {
+    const quintptr thread =
+        async ? 0 : quintptr(QThread::currentThreadId());
+    m_trace.append({stage, startNs, durationNs, thread});
+  }
+}
+
+QList<StageStats> StageProfiler::stats() const {
+  QMap<QString, Window> byName;
+  {
+    QMutexLocker locker(&m_mutex);
+    for (auto it = m_windows.cbegin(); it != m_windows.cend(); ++it) {
+      Window &window = byName[QString::fromLatin1(it.key())];
+      window.durations += it->durations;
+      window.count += it->count;
+      if (it->lastEndNs >= window.lastEndNs) {
+        window.lastNs = it->lastNs;
+        window.lastEndNs = it->lastEndNs;
+      }
+    }
+  }
+
+  QList<StageStats> result;
+  for (auto it = byName.cbegin(); it != byName.cend(); ++it) {
+    QList<qint64> sorted = it->durations;
+    std::sort(sorted.begin(), sorted.end());
+    auto percentile = [&sorted](double p) {
+      const int index = qMin(int(sorted.size() * p), int(sorted.size()) - 1);
+      return sorted.value(index) / 1.0e6;
+    };
+    StageStats stats;
+    stats.stage = it.key();
+    stats.count = it->count;
+    stats.lastMs = it->lastNs / 1.0e6;
+    stats.p50Ms = percentile(0.50);
+    stats.p95Ms = percentile(0.95);
+    stats.p99Ms = percentile(0.99);
+    stats.maxMs = sorted.isEmpty() ? 0 : sorted.last() / 1.0e6;
+    result.append(stats);
+  }
+  return result;
+}
+
+void StageProfiler::reset() {
+  QMutexLocker locker(&m_mutex);
+  m_windows.clear();
+}
+
+void StageProfiler::startTrace() {
+  QMutexLocker locker(&m_mutex);
+  m_trace.clear();
+  m_tracing = true;
+}
+
+bool StageProfiler::isTracing() const {
+  QMutexLocker locker(&m_mutex);
+  return m_tracing;
+}
+
+int StageProfiler::traceEvents() const {
+  QMutexLocker locker(&m_mutex);
+  return m_trace.size();
+}
+
+bool StageProfiler::stopTrace(const QString &path) {
+  QList<TraceEvent> events;
+  {
+    QMutexLocker locker(&m_mutex);
+    m_tracing = false;
+    events.swap(m_trace);
+  }
+
+  // Chrome's JSON trace format: complete ("X") events in microseconds, one
+  // track per thread, named by metadata events
+  const QByteArray pid =
+      QByteArray::number(QCoreApplication::applicationPid());
+  QHash<quintptr, int> tids;
+  tids.insert(0, 0);
+  QByteArray out = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+  out.reserve(out.size() + events.size() * 100);
+  for (const TraceEvent &event : events) {
+    auto tid = tids.constFind(event.thread);
+    if (tid == tids.constEnd())
+      tid = tids.insert(event.thread, tids.size());
+    out.append("{\"name\":\"")
+        .append(event.stage)
+        .append("\",\"cat\":\"refresh\",\"ph\":\"X\",\"pid\":")
+        .append(pid)
+        .append(",\"tid\":")
+        .append(QByteArray::number(tid.value()))
+        .append(",\"ts\":")
+        .append(QByteArray::number(event.startNs / 1000.0, 'f', 3))
+        .append(",\"dur\":")
+        .append(QByteArray::number(event.durationNs / 1000.0, 'f', 3))
+        .append("},\n");
+  }
+  // Traces are saved from the GUI thread
+  const quintptr main = quintptr(QThread::currentThreadId());
+  for (auto it = tids.cbegin(); it != tids.cend(); ++it) {
+    QByteArray name = "worker " + QByteArray::number(it.value());
+    if (it.key() == 0)
+      name = "scan (async)";
+    else if (it.key() == main)
+      name = "main";
+    out.append("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":")
+        .append(pid)
+        .append(",\"tid\":")
+        .append(QByteArray::number(it.value()))
+        .append(",\"args\":{\"name\":\"")
+        .append(name)
+        .append("\"}},\n");
+  }
+  out.chop(2); // Trailing ",\n"; the metadata list is never empty
+  out.append("\n]}\n");
+
+  QSaveFile file(path);
+  if (!file.open(QIODevice::WriteOnly))
+    return false;
+  file.write(out);
+  return file.commit();
+}
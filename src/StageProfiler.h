@@ -0,0 +1,107 @@
+/*
+ * Copyright 2025 Kadir Mert Abatay
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QString>
+
+struct StageStats {
+  QString stage;
+  qint64 count = 0; // Since startup or the last reset
+  double lastMs = 0;
+  // Over the last kWindow runs
+  double p50Ms = 0;
+  double p95Ms = 0;
+  double p99Ms = 0;
+  double maxMs = 0;
+};
+
+// Times the stages of a refresh, from lsof to the tray menu. Each stage
+// keeps its last kWindow durations for rolling percentiles; while a trace
+// is recording, every run is also kept as a Chrome trace event, which
+// chrome://tracing and Perfetto open. Recording a run takes a clock read
+// and a short lock, and stages may run on any thread.
+class StageProfiler {
+public:
+  static const int kWindow = 256;
+  // A trace stops growing at this many events (about 40 MB)
+  static const int kMaxTraceEvents = 1000000;
+
+  static StageProfiler *instance();
+
+  // Times the enclosing block as `stage`, a string literal
+  class Scope {
+  public:
+    explicit Scope(const char *stage);
+    ~Scope();
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+
+  private:
+    const char *m_stage;
+    qint64 m_startNs;
+  };
+
+  // Nanoseconds on the profiler's clock, for stages that start and end in
+  // different calls (e.g. waiting for lsof)
+  qint64 now() const { return m_clock.nsecsElapsed(); }
+
+  // `async` stages overlap others on the same thread; the trace puts them
+  // on a track of their own
+  void record(const char *stage, qint64 startNs, qint64 endNs,
+              bool async = false);
+
+  // Sorted by stage name
+  QList<StageStats> stats() const;
+  void reset();
+
+  void startTrace();
+  bool isTracing() const;
+  int traceEvents() const;
+  // Writes the events recorded since startTrace() and stops; false if the
+  // file could not be written
+  bool stopTrace(const QString &path);
+
+private:
+  StageProfiler();
+
+  struct Window {
+    QList<qint64> durations; // Ring of the last kWindow, in ns
+    int next = 0;
+    qint64 count = 0;
+    qint64 lastNs = 0;
+    qint64 lastEndNs = 0;
+  };
+
+  struct TraceEvent {
+    const char *stage;
+    qint64 startNs;
+    qint64 durationNs;
+    quintptr thread; // 0 for the async track
+  };
+
+  QElapsedTimer m_clock;
+  mutable QMutex m_mutex;
+  // Keyed by the literal's address; stats() folds literals that the
+  // compiler did not merge back together by name
+  QHash<const char *, Window> m_windows;
+  bool m_tracing = false;
+  QList<TraceEvent> m_trace;
+};
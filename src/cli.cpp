@@ -0,0 +1,382 @@
+/*
+ * Copyright 2025 Kadir Mert Abatay
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Headless front end to the scanning engine: links no GUI module and never
+// touches a display, so it runs on servers and starts in milliseconds.
+
+#include "AgentCollector.h"
+#include "AlertEngine.h"
+#include "MetricsExporter.h"
+#include "PortMonitor.h"
+#include "SnapshotAgent.h"
+#include "SnapshotClient.h"
+#include "SnapshotDiff.h"
+#include "SnapshotServer.h"
+#include "SnapshotStore.h"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QSysInfo>
+#include <QTextStream>
+#include <QTimer>
+#include <cstdio>
+
+static QTextStream &out() {
+  static QTextStream stream(stdout);
+  return stream;
+}
+
+static QStringList columns(const PortInfo &info) {
+  auto orDash = [](const QString &value) {
+    return value.isEmpty() ? QString("-") : value;
+  };
+  QStringList cells = {info.protocol,
+                       info.localAddress,
+                       QString::number(info.port),
+                       orDash(info.remoteAddress),
+                       info.state,
+                       info.pid,
+                       info.processName,
+                       info.user,
+                       orDash(info.unit),
+                       orDash(info.netnsOwner)};
+  // Sockets reported by agents lead with their host
+  if (!info.host.isEmpty())
+    cells.prepend(info.host);
+  return cells;
+}
+
+static void printTable(const QList<PortInfo> &ports) {
+  QList<QStringList> rows;
+  rows.reserve(ports.size() + 1);
+  rows.append({"PROTO", "ADDRESS", "PORT", "REMOTE", "STATE", "PID",
+               "PROCESS", "USER", "UNIT", "NAMESPACE"});
+  if (!ports.isEmpty() && !ports.first().host.isEmpty())
+    rows.first().prepend("HOST");
+  for (const PortInfo &info : ports)
+    rows.append(columns(info));
+
+  QList<int> widths(rows.first().size(), 0);
+  for (const QStringList &row : rows) {
+    for (int i = 0; i < row.size(); ++i)
+      widths[i] = qMax(widths[i], int(row[i].size()));
+  }
+  for (const QStringList &row : rows) {
+    QString line;
+    for (int i = 0; i + 1 < row.size(); ++i)
+      line += row[i].leftJustified(widths[i] + 2);
+    out() << line << row.last() << '\n';
+  }
+  out().flush();
+}
+
+static void printJson(const QList<PortInfo> &ports) {
+  QJsonArray rows;
+  for (const PortInfo &info : ports)
+    rows.append(SnapshotStore::toJson(info));
+  out() << QJsonDocument(rows).toJson(QJsonDocument::Indented);
+  out().flush();
+}
+
+// One line per change: "+" added, "-" removed, "~" changed, or one JSON
+// object per line with an "event" field
+static void printDelta(const SnapshotDelta &delta, bool json) {
+  const QString now = QDateTime::currentDateTime().toString(Qt::ISODate);
+  auto print = [json, &now](const char *event, char sign,
+                            const PortInfo &info) {
+    if (json) {
+      QJsonObject line = SnapshotStore::toJson(info);
+      line["event"] = event;
+      line["time"] = now;
+      out() << QJsonDocument(line).toJson(QJsonDocument::Compact) << '\n';
+    } else {
+      out() << now << ' ' << sign << ' ' << columns(info).join(' ') << '\n';
+    }
+  };
+  for (const PortInfo &info : delta.added)
+    print("added", '+', info);
+  for (const PortInfo &info : delta.removed)
+    print("removed", '-', info);
+  for (const PortInfo &info : delta.changed)
+    print("changed", '~', info);
+  out().flush();
+}
+
+int main(int argc, char *argv[]) {
+  QCoreApplication app(argc, argv);
+  app.setApplicationName("Port Monitor");
+  app.setOrganizationName("KadirMertAbatay");
+
+  QCommandLineParser parser;
+  parser.setApplicationDescription(
+      "Lists the sockets on this host, once or as they change.");
+  parser.addHelpOption();
+  parser.addPositionalArgument(
+      "command", "list: print every socket and exit (default)\n"
+                 "watch: print every socket, then each change\n"
+                 "serve: scan and stream the results to --connect viewers\n"
+                 "agent: scan and push the results to a --collector\n"
+                 "collect: accept agents and print each host's changes");
+  QCommandLineOption jsonOption(
+      "json", "JSON output; in watch mode one object per change and line.");
+  QCommandLineOption intervalOption(
+      {"i", "interval"},
+      "Seconds between scans (watch, serve, agent; default 2).",
+      "seconds", "2");
+  QCommandLineOption connectOption(
+      {"c", "connect"},
+      "Read from a running serve (or the app's shared scans) instead of "
+      "scanning.");
+  QCommandLineOption socketOption(
+      "socket", "Socket to serve on or connect to.", "path",
+      SnapshotServer::defaultPath());
+  QCommandLineOption portOption(
+      "port", "With --connect: only this port; repeatable.", "port");
+  QCommandLineOption stateOption(
+      "state", "With --connect: only this state, e.g. LISTEN; repeatable.",
+      "state");
+  QCommandLineOption metricsOption(
+      "metrics-port",
+      "While scanning (watch, serve, agent): OpenMetrics at "
+      "http://127.0.0.1:<port>/metrics.",
+      "port");
+  parser.addOption(jsonOption);
+  parser.addOption(intervalOption);
+  parser.addOption(connectOption);
+  parser.addOption(socketOption);
+  parser.addOption(portOption);
+  parser.addOption(stateOption);
+  QCommandLineOption collectorOption(
+      "collector", "agent: where to send scans.", "host:port");
+  QCommandLineOption nameOption(
+      "name", "agent: host name to report (default: this machine's).",
+      "name", QSysInfo::machineHostName());
+  QCommandLineOption agentPortOption(
+      "agent-port", "collect: TCP port agents connect to (default 9470).",
+      "port", "9470");
+  QCommandLineOption tokenOption(
+      "token",
+      "agent, collect: shared secret agents must present. Without one, "
+      "collect only accepts agents on this machine.",
+      "token");
+  QCommandLineOption alertsOption(
+      "alerts",
+      "While scanning or collecting: evaluate the app's alert rules and "
+      "print alerts to stderr.");
+  QCommandLineOption alertCommandOption(
+      "alert-command",
+      "With --alerts: also run this for every alert and resolution.",
+      "command");
+  parser.addOption(metricsOption);
+  parser.addOption(alertsOption);
+  parser.addOption(alertCommandOption);
+  parser.addOption(collectorOption);
+  parser.addOption(nameOption);
+  parser.addOption(agentPortOption);
+  parser.addOption(tokenOption);
+  parser.process(app);
+
+  const QString command = parser.positionalArguments().value(0, "list");
+  const QStringList commands = {"list", "watch", "serve", "agent",
+                                "collect"};
+  if (!commands.contains(command)) {
+    fprintf(stderr, "Unknown command: %s\n\n", qPrintable(command));
+    parser.showHelp(1);
+  }
+  const bool watch = (command == "watch");
+  const bool json = parser.isSet(jsonOption);
+  const int intervalMs =
+      qMax(100, int(parser.value(intervalOption).toDouble() * 1000));
+  const QString socketPath = parser.value(socketOption);
+  bool firstScan = true;
+
+  if (parser.isSet(connectOption)) {
+    if (command == "serve") {
+      fprintf(stderr, "serve scans itself; --connect does not apply\n");
+      return 1;
+    }
+    SnapshotFilter filter;
+    for (const QString &port : parser.values(portOption))
+      filter.ports.insert(port.toInt());
+    for (const QString &state : parser.values(stateOption))
+      filter.states.insert(state.toUpper());
+
+    SnapshotClient client;
+    QObject::connect(&client, &SnapshotClient::snapshotReceived,
+                     [&](const QList<PortInfo> &ports) {
+                       if (!watch) {
+                         json ? printJson(ports) : printTable(ports);
+                         app.quit();
+                       } else if (json) {
+                         printDelta({ports, {}, {}}, json);
+                       } else {
+                         printTable(ports);
+                       }
+                     });
+    QObject::connect(&client, &SnapshotClient::deltaReceived,
+                     [&](const SnapshotDelta &delta) {
+                       if (watch)
+                         printDelta(delta, json);
+                     });
+    QObject::connect(&client, &SnapshotClient::errorOccurred,
+                     [&](const QString &error) {
+                       fprintf(stderr, "%s: %s\n", qPrintable(socketPath),
+                               qPrintable(error));
+                       app.exit(1);
+                     });
+    client.connectToServer(socketPath, filter);
+    return app.exec();
+  }
+
+  AlertEngine alerts;
+  const bool alerting = parser.isSet(alertsOption) && command != "list";
+  if (alerting) {
+    QString error;
+    alerts.setRules(AlertEngine::load(AlertEngine::defaultPath(), &error));
+    if (!error.isEmpty()) {
+      fprintf(stderr, "%s: %s\n", qPrintable(AlertEngine::defaultPath()),
+              qPrintable(error));
+      return 1;
+    }
+    alerts.setCommand(parser.value(alertCommandOption));
+    auto print = [](const Alert &alert) {
+      fprintf(stderr, "%s %s: %s\n", alert.firing ? "ALERT" : "RESOLVED",
+              qPrintable(alert.rule), qPrintable(alert.message));
+    };
+    QObject::connect(&alerts, &AlertEngine::alertRaised, print);
+    QObject::connect(&alerts, &AlertEngine::alertResolved, print);
+  }
+
+  if (command == "collect") {
+    AgentCollector collector;
+    if (!collector.listen(quint16(parser.value(agentPortOption).toUInt()),
+                          parser.value(tokenOption))) {
+      fprintf(stderr, "%s\n", qPrintable(collector.errorString()));
+      return 1;
+    }
+    fprintf(stderr, "Accepting agents on port %s\n",
+            qPrintable(parser.value(agentPortOption)));
+    QObject::connect(&collector, &AgentCollector::hostConnected,
+                     [](const QString &host) {
+                       fprintf(stderr, "%s connected\n", qPrintable(host));
+                     });
+    QObject::connect(&collector, &AgentCollector::hostDisconnected,
+                     [&alerts](const QString &host, const QString &reason) {
+                       alerts.forgetHost(host);
+                       fprintf(stderr, "%s disconnected: %s\n",
+                               qPrintable(host), qPrintable(reason));
+                     });
+    QObject::connect(&collector, &AgentCollector::hostUpdated,
+                     [&](const QString &, const SnapshotDelta &delta) {
+                       if (alerting)
+                         alerts.apply(delta);
+                       printDelta(delta, json);
+                     });
+    return app.exec();
+  }
+
+  PortMonitor monitor;
+  SnapshotDiff diff;
+  SnapshotServer server;
+  SnapshotAgent agent(parser.value(nameOption), parser.value(tokenOption));
+  const QString collector = parser.value(collectorOption);
+  if (command == "agent") {
+    const int colon = collector.lastIndexOf(':');
+    const quint16 port = quint16(collector.mid(colon + 1).toUInt());
+    if (colon <= 0 || port == 0) {
+      fprintf(stderr, "agent needs --collector <host:port>\n");
+      return 1;
+    }
+    QObject::connect(&agent, &SnapshotAgent::connected, [&collector]() {
+      fprintf(stderr, "Connected to %s\n", qPrintable(collector));
+    });
+    QObject::connect(&agent, &SnapshotAgent::disconnected,
+                     [&collector](const QString &error) {
+                       fprintf(stderr, "%s: %s; retrying\n",
+                               qPrintable(collector), qPrintable(error));
+                     });
+    agent.connectToCollector(collector.left(colon), port);
+  }
+  if (command == "serve") {
+    if (!server.listen(socketPath)) {
+      fprintf(stderr, "%s\n", qPrintable(server.errorString()));
+      return 1;
+    }
+    fprintf(stderr, "Serving scans on %s\n", qPrintable(socketPath));
+  }
+  MetricsExporter metrics;
+  if (parser.isSet(metricsOption) && command != "list") {
+    if (!metrics.listen(quint16(parser.value(metricsOption).toUInt()))) {
+      fprintf(stderr, "Metrics: %s\n", qPrintable(metrics.errorString()));
+      return 1;
+    }
+    fprintf(stderr, "Metrics on http://127.0.0.1:%u/metrics\n",
+            unsigned(metrics.port()));
+  }
+
+  // The next scan is scheduled once the previous one is done, so a slow
+  // scan never overlaps the next
+  QTimer next;
+  next.setSingleShot(true);
+  next.setInterval(intervalMs);
+  QObject::connect(&next, &QTimer::timeout, &monitor, &PortMonitor::refresh);
+
+  QObject::connect(
+      &monitor, &PortMonitor::portsUpdated, [&](const QList<PortInfo> &ports) {
+        if (metrics.isListening())
+          metrics.recordScan(ports, monitor.lastScanMs());
+        if (alerting)
+          alerts.update(ports);
+        if (command == "serve" || command == "agent") {
+          if (command == "serve")
+            server.publish(ports);
+          else
+            agent.publish(ports);
+          next.start();
+          return;
+        }
+        if (!watch) {
+          json ? printJson(ports) : printTable(ports);
+          app.quit();
+          return;
+        }
+        const SnapshotDelta delta = diff.update(ports);
+        if (firstScan && !json)
+          printTable(ports);
+        else
+          printDelta(delta, json);
+        firstScan = false;
+        next.start();
+      });
+  QObject::connect(&monitor, &PortMonitor::errorOccurred,
+                   [&](const QString &error) {
+                     if (metrics.isListening())
+                       metrics.recordScanError();
+                     const QString message = error.trimmed();
+                     fprintf(stderr, "%s\n",
+                             qPrintable(message.isEmpty() ? "lsof failed"
+                                                          : message));
+                     if (command != "list")
+                       next.start();
+                     else
+                       app.exit(1);
+                   });
+
+  monitor.refresh();
+  return app.exec();
+}
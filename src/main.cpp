@@ -15,16 +15,16 @@
  */
 
 #include "MainWindow.h"
+#include "StageProfiler.h"
 #include <QApplication>
+#include <QElapsedTimer>
 #include <QFile>
 #include <QIcon>
-#include <QPainter>
-#include <QPainterPath>
-#include <QScreen>
-#include <QSplashScreen>
-#include <QTimer>
 
 int main(int argc, char *argv[]) {
+  QElapsedTimer startup;
+  startup.start();
+
   // Ensure we can see the tray icon on some systems
   QApplication::setQuitOnLastWindowClosed(false);
 
@@ -39,51 +39,26 @@ int main(int argc, char *argv[]) {
     app.setStyleSheet(styleFile.readAll());
   }
 
-  // Create Splash Screen
-  QPixmap splashPix(450, 280);
-  splashPix.fill(Qt::transparent);
-
-  QPainter painter(&splashPix);
-  painter.setRenderHint(QPainter::Antialiasing);
-
-  // Background
-  QLinearGradient gradient(0, 0, 450, 280);
-  gradient.setColorAt(0, QColor(45, 45, 45));
-  gradient.setColorAt(1, QColor(25, 25, 25));
-
-  QPainterPath path;
-  path.addRoundedRect(0, 0, 450, 280, 15, 15);
-  painter.fillPath(path, gradient);
-
-  // App Title
-  painter.setPen(QColor(61, 174, 233));
-  painter.setFont(QFont("Arial", 28, QFont::Bold));
-  painter.drawText(QRect(0, 70, 450, 50), Qt::AlignCenter, "Port Monitor");
-
-  // Subtitle
-  painter.setPen(QColor(200, 200, 200));
-  painter.setFont(QFont("Arial", 14));
-  painter.drawText(QRect(0, 130, 450, 30), Qt::AlignCenter,
-                   "Advanced Network Tool");
-
-  // Loading...
-  painter.setPen(QColor(120, 120, 120));
-  painter.setFont(QFont("Arial", 10));
-  painter.drawText(QRect(0, 230, 450, 30), Qt::AlignCenter,
-                   "Initializing System...");
-
-  QSplashScreen splash(splashPix);
-  splash.show();
-  app.processEvents();
+  // --trace <file> records every refresh stage and writes a Chrome trace
+  // on exit
+  const int traceArg = app.arguments().indexOf("--trace");
+  const QString tracePath = app.arguments().value(traceArg + 1);
+  if (traceArg > 0 && !tracePath.isEmpty()) {
+    StageProfiler::instance()->startTrace();
+    QObject::connect(&app, &QCoreApplication::aboutToQuit, [tracePath]() {
+      if (StageProfiler::instance()->isTracing() &&
+          !StageProfiler::instance()->stopTrace(tracePath)) {
+        qWarning("Could not write %s", qPrintable(tracePath));
+      }
+    });
+  }
 
   MainWindow window;
   window.resize(1000, 700);
-
-  // Delay showing main window to let splash be seen
-  QTimer::singleShot(2000, [&]() {
-    splash.finish(&window);
-    window.show();
-  });
+  // --startup-timing reports time to first paint and to fresh data
+  if (app.arguments().contains("--startup-timing"))
+    window.enableStartupTiming(startup);
+  window.show();
 
   return app.exec();
 }